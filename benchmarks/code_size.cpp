@@ -0,0 +1,92 @@
+// Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Reference program for measuring the code size of each instantiation.
+//
+// Exercises the common operations of strong_ptr, weak_ptr and optional_ptr for
+// LIBHAL_CODE_SIZE_TYPES distinct types. The code_size_report target builds
+// this program for one type and for many types, and divides the difference in
+// .text by the number of extra types to report the cost of one instantiation.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
+
+import strong_ptr;
+
+#if not defined(LIBHAL_CODE_SIZE_TYPES)
+#define LIBHAL_CODE_SIZE_TYPES 1
+#endif
+
+namespace {
+/**
+ * @brief Prevent the compiler from optimizing away a value
+ */
+template<typename T>
+void do_not_optimize(T const& p_value)
+{
+#if defined(__GNUC__) or defined(__clang__)
+  asm volatile("" : : "r,m"(p_value) : "memory");
+#else
+  static_cast<void>(*static_cast<T const volatile*>(&p_value));
+#endif
+}
+
+// A distinct type per index, so each one has its own instantiations
+template<std::size_t Index>
+struct payload
+{
+  std::uint32_t value = Index;
+  std::array<std::uint32_t, 3> data{};
+};
+
+template<std::size_t Index>
+void exercise(std::pmr::memory_resource* p_resource)
+{
+  auto ptr = mem::make_strong_ptr<payload<Index>>(p_resource);
+  auto copy = ptr;
+  do_not_optimize(copy->value);
+
+  mem::weak_ptr<payload<Index>> weak = ptr;
+  if (auto locked = weak.lock()) {
+    do_not_optimize(locked->value);
+  }
+
+  mem::optional_ptr<payload<Index>> maybe = ptr;
+  if (maybe) {
+    do_not_optimize(maybe->value);
+  }
+  maybe.reset();
+
+  mem::strong_ptr<std::uint32_t> member(ptr, &payload<Index>::value);
+  mem::strong_ptr<std::uint32_t> element(ptr, &payload<Index>::data, 1);
+  do_not_optimize(*member + *element);
+}
+
+template<std::size_t... Indices>
+void exercise_all(std::pmr::memory_resource* p_resource,
+                  std::index_sequence<Indices...>)
+{
+  (exercise<Indices>(p_resource), ...);
+}
+}  // namespace
+
+int main()
+{
+  exercise_all(std::pmr::new_delete_resource(),
+               std::make_index_sequence<LIBHAL_CODE_SIZE_TYPES>{});
+  return 0;
+}
@@ -0,0 +1,46 @@
+# Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Reports the .text cost of one instantiation from two builds of
+# code_size.cpp. Run by the code_size_report target:
+#
+#   cmake -DSIZE_TOOL=<size> -DBASELINE=<1 type> -DSCALED=<N types>
+#         -DTYPES=<N> -P code_size_report.cmake
+
+function(text_size executable result)
+    execute_process(
+        COMMAND ${SIZE_TOOL} ${executable}
+        OUTPUT_VARIABLE output
+        RESULT_VARIABLE status)
+    if(NOT status EQUAL 0)
+        message(FATAL_ERROR "${SIZE_TOOL} failed on ${executable}")
+    endif()
+    # Berkeley format: a header line, then "text data bss dec hex filename"
+    string(REGEX MATCH "\n[ \t]*([0-9]+)" match "${output}")
+    if(NOT match)
+        message(FATAL_ERROR "Unexpected output from ${SIZE_TOOL}:\n${output}")
+    endif()
+    set(${result} ${CMAKE_MATCH_1} PARENT_SCOPE)
+endfunction()
+
+text_size(${BASELINE} baseline)
+text_size(${SCALED} scaled)
+math(EXPR extra_types "${TYPES} - 1")
+math(EXPR growth "${scaled} - ${baseline}")
+math(EXPR per_type "${growth} / ${extra_types}")
+
+message(STATUS "strong_ptr code size")
+message(STATUS "  .text with 1 type: ${baseline} bytes")
+message(STATUS "  .text with ${TYPES} types: ${scaled} bytes")
+message(STATUS "  .text per extra type: ${per_type} bytes")
@@ -0,0 +1,379 @@
+// Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares strong_ptr against std::shared_ptr using the same memory resource.
+//
+// Usage: strong_ptr_benchmarks [iterations]
+//
+// Every benchmark reports the mean time of one operation in nanoseconds. Run a
+// release build on an otherwise idle machine, and compare numbers from the
+// same machine only.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <memory_resource>
+#include <print>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+import strong_ptr;
+
+namespace {
+constexpr std::size_t default_iterations = 1'000'000;
+constexpr std::size_t thread_count = 4;
+
+/**
+ * @brief Prevent the compiler from optimizing away a value
+ */
+template<typename T>
+void do_not_optimize(T const& p_value)
+{
+#if defined(__GNUC__) or defined(__clang__)
+  asm volatile("" : : "r,m"(p_value) : "memory");
+#else
+  static_cast<void>(*static_cast<T const volatile*>(&p_value));
+#endif
+}
+
+struct payload
+{
+  std::uint32_t value = 0;
+  std::array<std::uint32_t, 3> data{};
+};
+
+struct self_aware
+  : public mem::enable_strong_from_this<self_aware>
+  , public std::enable_shared_from_this<self_aware>
+{
+  std::uint32_t value = 0;
+};
+
+struct compact_self_aware
+  : public mem::enable_strong_from_this_compact<compact_self_aware>
+{
+  explicit compact_self_aware(mem::strong_ptr_only_token p_token)
+    : enable_strong_from_this_compact(p_token)
+  {
+  }
+
+  std::uint32_t value = 0;
+};
+
+/**
+ * @brief Records the number of bytes requested from the upstream resource
+ */
+struct measuring_resource : public std::pmr::memory_resource
+{
+  void* do_allocate(std::size_t p_bytes, std::size_t p_alignment) override
+  {
+    last_allocation = p_bytes;
+    return std::pmr::new_delete_resource()->allocate(p_bytes, p_alignment);
+  }
+
+  void do_deallocate(void* p_address,
+                     std::size_t p_bytes,
+                     std::size_t p_alignment) override
+  {
+    std::pmr::new_delete_resource()->deallocate(p_address, p_bytes, p_alignment);
+  }
+
+  [[nodiscard]] bool do_is_equal(
+    std::pmr::memory_resource const& p_other) const noexcept override
+  {
+    return this == &p_other;
+  }
+
+  std::size_t last_allocation = 0;
+};
+
+/**
+ * @brief Run p_operation p_iterations times and report mean time per call
+ */
+template<typename Operation>
+void measure(std::string_view p_name,
+             std::size_t p_iterations,
+             Operation&& p_operation)
+{
+  using clock = std::chrono::steady_clock;
+
+  // Warm up caches and the memory resource
+  for (std::size_t i = 0; i < p_iterations / 10; i++) {
+    p_operation();
+  }
+
+  auto const start = clock::now();
+  for (std::size_t i = 0; i < p_iterations; i++) {
+    p_operation();
+  }
+  auto const elapsed = std::chrono::duration<double, std::nano>(clock::now() -
+                                                                start);
+
+  std::println("  {:<44} {:>10.2f} ns", p_name, elapsed.count() / p_iterations);
+}
+
+/**
+ * @brief Run p_operation on every thread at once, all sharing p_shared
+ */
+template<typename Shared, typename Operation>
+void measure_contended(std::string_view p_name,
+                       std::size_t p_iterations,
+                       Shared const& p_shared,
+                       Operation p_operation)
+{
+  using clock = std::chrono::steady_clock;
+
+  std::atomic<bool> start = false;
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count);
+
+  for (std::size_t t = 0; t < thread_count; t++) {
+    threads.emplace_back([&] {
+      while (not start) {
+      }
+      for (std::size_t i = 0; i < p_iterations; i++) {
+        p_operation(p_shared);
+      }
+    });
+  }
+
+  auto const begin = clock::now();
+  start = true;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto const elapsed = std::chrono::duration<double, std::nano>(clock::now() -
+                                                                begin);
+
+  std::println("  {:<44} {:>10.2f} ns",
+               p_name,
+               elapsed.count() / (p_iterations * thread_count));
+}
+
+void report_sizes()
+{
+  measuring_resource resource;
+
+  std::println("Sizes (bytes)");
+  std::println("  {:<44} {:>10}",
+               "strong_ptr<payload>",
+               sizeof(mem::strong_ptr<payload>));
+  std::println("  {:<44} {:>10}",
+               "optional_ptr<payload>",
+               sizeof(mem::optional_ptr<payload>));
+  std::println("  {:<44} {:>10}",
+               "intrusive_strong_ptr<self_aware>",
+               sizeof(mem::intrusive_strong_ptr<self_aware>));
+  std::println("  {:<44} {:>10}",
+               "std::shared_ptr<payload>",
+               sizeof(std::shared_ptr<payload>));
+
+  {
+    auto ptr = mem::make_strong_ptr<payload>(&resource);
+    std::println("  {:<44} {:>10}",
+                 "make_strong_ptr<payload> allocation",
+                 resource.last_allocation);
+  }
+  {
+    auto ptr = std::allocate_shared<payload>(
+      std::pmr::polymorphic_allocator<payload>(&resource));
+    std::println("  {:<44} {:>10}",
+                 "allocate_shared<payload> allocation",
+                 resource.last_allocation);
+  }
+  {
+    auto ptr = mem::make_strong_ptr<self_aware>(&resource);
+    std::println("  {:<44} {:>10}",
+                 "make_strong_ptr<self_aware> allocation",
+                 resource.last_allocation);
+  }
+  {
+    auto ptr = mem::make_strong_ptr<compact_self_aware>(&resource);
+    std::println("  {:<44} {:>10}",
+                 "make_strong_ptr<compact_self_aware> allocation",
+                 resource.last_allocation);
+  }
+}
+
+void run_single_threaded(std::size_t p_iterations)
+{
+  std::pmr::unsynchronized_pool_resource pool;
+  std::pmr::polymorphic_allocator<payload> allocator(&pool);
+
+  std::println("Single threaded (per operation)");
+
+  measure("make_strong_ptr", p_iterations, [&] {
+    auto ptr = mem::make_strong_ptr<payload>(&pool);
+    do_not_optimize(ptr);
+  });
+  measure("std::allocate_shared", p_iterations, [&] {
+    auto ptr = std::allocate_shared<payload>(allocator);
+    do_not_optimize(ptr);
+  });
+
+  auto strong = mem::make_strong_ptr<payload>(&pool);
+  auto shared = std::allocate_shared<payload>(allocator);
+
+  measure("strong_ptr copy", p_iterations, [&] {
+    auto copy = strong;
+    do_not_optimize(copy);
+  });
+  measure("std::shared_ptr copy", p_iterations, [&] {
+    auto copy = shared;
+    do_not_optimize(copy);
+  });
+
+  measure("strong_ptr move", p_iterations, [&] {
+    auto copy = strong;
+    auto moved = std::move(copy);
+    do_not_optimize(moved);
+  });
+  measure("optional_ptr move", p_iterations, [&] {
+    mem::optional_ptr<payload> copy = strong;
+    auto moved = std::move(copy);
+    do_not_optimize(moved);
+  });
+  measure("std::shared_ptr move", p_iterations, [&] {
+    auto copy = shared;
+    auto moved = std::move(copy);
+    do_not_optimize(moved);
+  });
+
+  auto strong_other = mem::make_strong_ptr<payload>(&pool);
+  auto shared_other = std::allocate_shared<payload>(allocator);
+  measure("strong_ptr assign", p_iterations, [&] {
+    auto copy = strong;
+    copy = strong_other;
+    do_not_optimize(copy);
+  });
+  measure("std::shared_ptr assign", p_iterations, [&] {
+    auto copy = shared;
+    copy = shared_other;
+    do_not_optimize(copy);
+  });
+
+  mem::weak_ptr<payload> weak = strong;
+  std::weak_ptr<payload> std_weak = shared;
+  measure("weak_ptr::lock", p_iterations, [&] {
+    auto locked = weak.lock();
+    do_not_optimize(locked);
+  });
+  measure("std::weak_ptr::lock", p_iterations, [&] {
+    auto locked = std_weak.lock();
+    do_not_optimize(locked);
+  });
+  measure("weak_ptr::try_lock", p_iterations, [&] {
+    auto locked = strong_other;
+    do_not_optimize(weak.try_lock(locked));
+    do_not_optimize(locked);
+  });
+  measure("weak_ptr::visit", p_iterations, [&] {
+    do_not_optimize(
+      weak.visit([](payload& p_payload) { do_not_optimize(p_payload.value); }));
+  });
+
+  measure("strong_ptr aliasing", p_iterations, [&] {
+    auto alias = mem::strong_ptr<std::uint32_t>(strong, &payload::value);
+    do_not_optimize(alias);
+  });
+  measure("std::shared_ptr aliasing", p_iterations, [&] {
+    auto alias = std::shared_ptr<std::uint32_t>(shared, &shared->value);
+    do_not_optimize(alias);
+  });
+
+  auto self = mem::make_strong_ptr<self_aware>(&pool);
+  auto compact = mem::make_strong_ptr<compact_self_aware>(&pool);
+  auto std_self = std::allocate_shared<self_aware>(
+    std::pmr::polymorphic_allocator<self_aware>(&pool));
+  measure("strong_from_this", p_iterations, [&] {
+    auto ptr = self->strong_from_this();
+    do_not_optimize(ptr);
+  });
+  measure("strong_from_this (compact)", p_iterations, [&] {
+    auto ptr = compact->strong_from_this();
+    do_not_optimize(ptr);
+  });
+  measure("shared_from_this", p_iterations, [&] {
+    auto ptr = std_self->shared_from_this();
+    do_not_optimize(ptr);
+  });
+}
+
+void run_multi_threaded(std::size_t p_iterations)
+{
+  std::pmr::synchronized_pool_resource pool;
+
+  std::println("Contended, {} threads (per operation)", thread_count);
+
+  auto strong = mem::make_strong_ptr<payload>(&pool);
+  auto shared = std::allocate_shared<payload>(
+    std::pmr::polymorphic_allocator<payload>(&pool));
+
+  if constexpr (mem::thread_safe_ref_count) {
+    measure_contended(
+      "strong_ptr copy", p_iterations, strong, [](auto const& p_shared) {
+        auto copy = p_shared;
+        do_not_optimize(copy);
+      });
+    mem::weak_ptr<payload> weak = strong;
+    measure_contended(
+      "weak_ptr::lock", p_iterations, weak, [](auto const& p_weak) {
+        auto locked = p_weak.lock();
+        do_not_optimize(locked);
+      });
+  } else {
+    std::println("  strong_ptr skipped: build with "
+                 "LIBHAL_STRONG_PTR_THREAD_SAFE=ON to share across threads");
+  }
+
+  measure_contended(
+    "std::shared_ptr copy", p_iterations, shared, [](auto const& p_shared) {
+      auto copy = p_shared;
+      do_not_optimize(copy);
+    });
+  std::weak_ptr<payload> std_weak = shared;
+  measure_contended(
+    "std::weak_ptr::lock", p_iterations, std_weak, [](auto const& p_weak) {
+      auto locked = p_weak.lock();
+      do_not_optimize(locked);
+    });
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  std::size_t iterations = default_iterations;
+  if (argc > 1) {
+    iterations = std::max<std::size_t>(1, std::strtoull(argv[1], nullptr, 10));
+  }
+
+  std::println("strong_ptr benchmarks: {} iterations, {}-bit {} counts",
+               iterations,
+               sizeof(mem::ref_count_t) * 8,
+               mem::thread_safe_ref_count ? "atomic" : "unsynchronized");
+  std::println("");
+
+  report_sizes();
+  std::println("");
+  run_single_threaded(iterations);
+  std::println("");
+  run_multi_threaded(iterations / thread_count);
+  return 0;
+}
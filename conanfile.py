@@ -36,17 +36,27 @@ class strong_ptr_conan(ConanFile):
     topics = ("memory", "dynamic", "polymorphic_allocator",
               "pointer", "pointers")
     settings = "compiler", "build_type", "os", "arch"
-    exports_sources = ("modules/*", "tests/*",
+    exports_sources = ("modules/*", "tests/*", "benchmarks/*",
                        "CMakeLists.txt", "LICENSE", ".clang-tidy")
     shared = False
 
     options = {
         "enable_clang_tidy": [True, False],
         "clang_tidy_fix": [True, False],
+        "thread_safe": [True, False],
+        "count_bits": ["16", "32", "64"],
+        "instrumentation": [True, False],
+        "cache_line_size": ["ANY"],
+        "exceptions": [True, False],
     }
     default_options = {
         "enable_clang_tidy": False,
         "clang_tidy_fix": False,
+        "thread_safe": False,
+        "count_bits": "32",
+        "instrumentation": False,
+        "cache_line_size": "64",
+        "exceptions": True,
     }
 
     @property
@@ -123,6 +133,11 @@ class strong_ptr_conan(ConanFile):
         tc.generator = "Ninja"
         tc.variables["LIBHAL_ENABLE_CLANG_TIDY"] = self.options.enable_clang_tidy
         tc.variables["LIBHAL_CLANG_TIDY_FIX"] = self.options.clang_tidy_fix
+        tc.variables["LIBHAL_STRONG_PTR_THREAD_SAFE"] = self.options.thread_safe
+        tc.variables["LIBHAL_STRONG_PTR_COUNT_BITS"] = self.options.count_bits
+        tc.variables["LIBHAL_STRONG_PTR_INSTRUMENTATION"] = self.options.instrumentation
+        tc.variables["LIBHAL_STRONG_PTR_CACHE_LINE_SIZE"] = self.options.cache_line_size
+        tc.variables["LIBHAL_STRONG_PTR_EXCEPTIONS"] = self.options.exceptions
         tc.generate()
 
         deps = CMakeDeps(self)
@@ -144,7 +159,10 @@ class strong_ptr_conan(ConanFile):
              src=self.source_folder)
 
     def package_id(self):
-        self.info.options.clear()
+        # Every option except the clang-tidy switches changes the produced
+        # package, through its public compile definitions and layout
+        self.info.options.rm_safe("enable_clang_tidy")
+        self.info.options.rm_safe("clang_tidy_fix")
 
     def package_info(self):
         # DISABLE Conan's config file generation
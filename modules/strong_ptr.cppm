@@ -17,17 +17,74 @@ module;
 #include <cstddef>
 #include <cstdint>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <coroutine>
 #include <exception>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <memory_resource>
+#include <source_location>
 #include <span>
+#include <string_view>
 #include <system_error>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 
 export module strong_ptr;
 
+// Select the reference counting policy used by every control block. Define
+// LIBHAL_STRONG_PTR_THREAD_SAFE=1 (or enable the CMake/Conan option of the
+// same purpose) to share strong_ptr, weak_ptr and optional_ptr across threads.
+#if not defined(LIBHAL_STRONG_PTR_THREAD_SAFE)
+#define LIBHAL_STRONG_PTR_THREAD_SAFE 0
+#endif
+
+// Width in bits of each reference count: 16, 32 or 64
+#if not defined(LIBHAL_STRONG_PTR_COUNT_BITS)
+#define LIBHAL_STRONG_PTR_COUNT_BITS 32
+#endif
+
+// Count reference counting operations per type, see ref_count_stats_for()
+#if not defined(LIBHAL_STRONG_PTR_INSTRUMENTATION)
+#define LIBHAL_STRONG_PTR_INSTRUMENTATION 0
+#endif
+
+// Bytes that must separate two objects so they never share a cache line, see
+// isolate_control_block. A fixed value keeps the layout identical across
+// translation units, which std::hardware_destructive_interference_size does
+// not guarantee.
+#if not defined(LIBHAL_STRONG_PTR_CACHE_LINE_SIZE)
+#define LIBHAL_STRONG_PTR_CACHE_LINE_SIZE 64
+#endif
+
+// Error policy: 1 reports failures by throwing, 0 calls std::terminate() so
+// the library builds with -fno-exceptions. Defaults to the compiler's mode.
+#if not defined(LIBHAL_STRONG_PTR_EXCEPTIONS)
+#if defined(__cpp_exceptions)
+#define LIBHAL_STRONG_PTR_EXCEPTIONS 1
+#else
+#define LIBHAL_STRONG_PTR_EXCEPTIONS 0
+#endif
+#endif
+
+#if LIBHAL_STRONG_PTR_EXCEPTIONS and not defined(__cpp_exceptions)
+#error "LIBHAL_STRONG_PTR_EXCEPTIONS=1 requires exceptions to be enabled"
+#endif
+
+// Keeps rarely taken paths out of line, so that every instantiation calls one
+// shared copy rather than inlining its own
+#if defined(_MSC_VER) and not defined(__clang__)
+#define LIBHAL_STRONG_PTR_NOINLINE __declspec(noinline)
+#else
+#define LIBHAL_STRONG_PTR_NOINLINE [[gnu::noinline]]
+#endif
+
 namespace mem::inline v1 {
 
 // Forward declarations
@@ -40,8 +97,83 @@ class weak_ptr;
 export template<typename T>
 class optional_ptr;
 
+export template<class T>
+class enable_strong_from_this_compact;
+
+export template<class Promise>
+class strong_promise;
+
+struct strong_ptr_factory;
+
+/**
+ * @brief True if failures are reported by throwing exceptions
+ *
+ * When false, every failure that would throw calls std::terminate() instead.
+ * Use the `try_` APIs, such as `try_make_strong_ptr`, to handle recoverable
+ * failures without exceptions.
+ */
+export inline constexpr bool exceptions_enabled =
+  LIBHAL_STRONG_PTR_EXCEPTIONS != 0;
+
+/**
+ * @brief Report a failure according to the error policy
+ *
+ * @param p_error - exception thrown when exceptions are enabled
+ */
+template<typename Exception>
+[[noreturn]] constexpr void throw_exception(Exception const& p_error)
+{
+#if LIBHAL_STRONG_PTR_EXCEPTIONS
+  throw p_error;
+#else
+  static_cast<void>(p_error);
+  std::terminate();
+#endif
+}
+
+// The failure paths below are shared by every allocator and instantiation
+
+[[noreturn]] LIBHAL_STRONG_PTR_NOINLINE void throw_bad_alloc()
+{
+  throw_exception(std::bad_alloc());
+}
+
+/**
+ * @brief Usage statistics of a monotonic allocator
+ *
+ * Use `high_water_mark_bytes` from representative runs to right-size the
+ * `StorageSizeBytes` of `make_monotonic_allocator`.
+ */
+export struct monotonic_allocator_stats
+{
+  /// Bytes currently allocated and not yet deallocated
+  std::size_t live_bytes = 0;
+  /// Bytes of storage consumed since the last rewind, including padding
+  /// inserted to satisfy alignment
+  std::size_t consumed_bytes = 0;
+  /// Largest value `consumed_bytes` has reached, across rewinds
+  std::size_t high_water_mark_bytes = 0;
+  /// Bytes of storage that can still be consumed
+  std::size_t remaining_bytes = 0;
+  /// Total bytes of storage
+  std::size_t capacity_bytes = 0;
+};
+
 struct monotonic_allocator_base : public std::pmr::memory_resource
 {
+  monotonic_allocator_base(void* p_storage, std::size_t p_capacity)
+    : m_space(p_capacity)
+    , m_ptr(p_storage)
+    , m_begin(p_storage)
+    , m_capacity(p_capacity)
+  {
+  }
+
+  monotonic_allocator_base(monotonic_allocator_base const&) = delete;
+  monotonic_allocator_base& operator=(monotonic_allocator_base const&) = delete;
+  monotonic_allocator_base(monotonic_allocator_base&&) = delete;
+  monotonic_allocator_base& operator=(monotonic_allocator_base&&) = delete;
+
   ~monotonic_allocator_base() override
   {
     if (m_allocated_bytes != 0) {
@@ -49,49 +181,248 @@ struct monotonic_allocator_base : public std::pmr::memory_resource
     }
   }
 
-  void* do_allocate(std::size_t p_bytes, std::size_t p_alignment) override
+  /**
+   * @brief Allocate without reporting failure through the error policy
+   *
+   * @return void* - the allocation or nullptr if the arena is exhausted
+   */
+  [[nodiscard]] void* try_allocate(std::size_t p_bytes,
+                                   std::size_t p_alignment) noexcept
   {
     void* result = std::align(p_alignment, p_bytes, m_ptr, m_space);
     if (result == nullptr) [[unlikely]] {
-      throw std::bad_alloc();
+      return nullptr;
     }
 
-    m_allocated_bytes += static_cast<decltype(m_allocated_bytes)>(p_bytes);
+    m_allocated_bytes += p_bytes;
     m_ptr = static_cast<std::uint8_t*>(result) + p_bytes;
     m_space -= p_bytes;
+    m_high_water_mark = std::max(m_high_water_mark, m_capacity - m_space);
+    return result;
+  }
+
+  void* do_allocate(std::size_t p_bytes, std::size_t p_alignment) override
+  {
+    void* result = try_allocate(p_bytes, p_alignment);
+    if (result == nullptr) [[unlikely]] {
+      throw_bad_alloc();
+    }
     return result;
   };
 
   void do_deallocate(void*, std::size_t p_bytes, std::size_t) override
   {
-    m_allocated_bytes -= static_cast<decltype(m_allocated_bytes)>(p_bytes);
+    m_allocated_bytes -= p_bytes;
   }
 
   [[nodiscard]] bool do_is_equal(
     std::pmr::memory_resource const& p_other) const noexcept override
   {
-    return *this == p_other;
+    return this == &p_other;
+  }
+
+  [[nodiscard]] monotonic_allocator_stats stats() const noexcept
+  {
+    return {
+      .live_bytes = m_allocated_bytes,
+      .consumed_bytes = m_capacity - m_space,
+      .high_water_mark_bytes = m_high_water_mark,
+      .remaining_bytes = m_space,
+      .capacity_bytes = m_capacity,
+    };
+  }
+
+  [[nodiscard]] bool rewind() noexcept
+  {
+    if (m_allocated_bytes != 0) {
+      return false;
+    }
+    m_ptr = m_begin;
+    m_space = m_capacity;
+    return true;
+  }
+
+  // Discard every allocation at once, used by scoped_arena once it has
+  // destroyed all of the objects in the arena
+  void release_all() noexcept
+  {
+    m_allocated_bytes = 0;
+    m_ptr = m_begin;
+    m_space = m_capacity;
   }
 
-  size_t m_space = 0;
+  std::size_t m_space = 0;
   void* m_ptr = nullptr;
-  std::int32_t m_allocated_bytes = 0;
+  void* m_begin = nullptr;
+  std::size_t m_capacity = 0;
+  std::size_t m_allocated_bytes = 0;
+  std::size_t m_high_water_mark = 0;
 };
 
-template<size_t MemorySize>
-struct monotonic_allocator
+/**
+ * @brief Monotonic arena that may be shared by any number of threads
+ *
+ * The bump offset, live byte counter and high water mark are atomics, so
+ * allocation and deallocation are lock free and may happen on different
+ * threads. Deallocations are release operations and the leak check performs
+ * an acquire, so an object freed on another thread balances the counter before
+ * the arena is rewound or destroyed.
+ */
+struct concurrent_monotonic_allocator_base : public std::pmr::memory_resource
 {
-  monotonic_allocator()
+  concurrent_monotonic_allocator_base(void* p_storage, std::size_t p_capacity)
+    : m_begin(p_storage)
+    , m_capacity(p_capacity)
+  {
+  }
+
+  concurrent_monotonic_allocator_base(
+    concurrent_monotonic_allocator_base const&) = delete;
+  concurrent_monotonic_allocator_base& operator=(
+    concurrent_monotonic_allocator_base const&) = delete;
+  concurrent_monotonic_allocator_base(concurrent_monotonic_allocator_base&&) =
+    delete;
+  concurrent_monotonic_allocator_base& operator=(
+    concurrent_monotonic_allocator_base&&) = delete;
+
+  ~concurrent_monotonic_allocator_base() override
+  {
+    if (m_allocated_bytes.load(std::memory_order_acquire) != 0) {
+      std::terminate();
+    }
+  }
+
+  /**
+   * @brief Allocate without reporting failure through the error policy
+   *
+   * @return void* - the allocation or nullptr if the arena is exhausted
+   */
+  [[nodiscard]] void* try_allocate(std::size_t p_bytes,
+                                   std::size_t p_alignment) noexcept
+  {
+    auto const base = reinterpret_cast<std::uintptr_t>(m_begin);
+    auto consumed = m_consumed.load(std::memory_order_relaxed);
+    std::size_t offset = 0;
+    std::size_t end = 0;
+
+    // Each thread claims a distinct [offset, end) range, the memory itself is
+    // never shared so relaxed ordering is sufficient.
+    do {
+      auto const aligned =
+        (base + consumed + p_alignment - 1) & ~(p_alignment - 1);
+      offset = aligned - base;
+      if (offset > m_capacity || p_bytes > m_capacity - offset) [[unlikely]] {
+        return nullptr;
+      }
+      end = offset + p_bytes;
+    } while (not m_consumed.compare_exchange_weak(
+      consumed, end, std::memory_order_relaxed, std::memory_order_relaxed));
+
+    m_allocated_bytes.fetch_add(p_bytes, std::memory_order_relaxed);
+
+    auto mark = m_high_water_mark.load(std::memory_order_relaxed);
+    while (mark < end && not m_high_water_mark.compare_exchange_weak(
+                           mark, end, std::memory_order_relaxed)) {
+    }
+
+    return static_cast<std::byte*>(m_begin) + offset;
+  }
+
+  void* do_allocate(std::size_t p_bytes, std::size_t p_alignment) override
+  {
+    void* result = try_allocate(p_bytes, p_alignment);
+    if (result == nullptr) [[unlikely]] {
+      throw_bad_alloc();
+    }
+    return result;
+  };
+
+  void do_deallocate(void*, std::size_t p_bytes, std::size_t) override
+  {
+    m_allocated_bytes.fetch_sub(p_bytes, std::memory_order_release);
+  }
+
+  [[nodiscard]] bool do_is_equal(
+    std::pmr::memory_resource const& p_other) const noexcept override
+  {
+    return this == &p_other;
+  }
+
+  [[nodiscard]] monotonic_allocator_stats stats() const noexcept
+  {
+    auto const consumed = m_consumed.load(std::memory_order_relaxed);
+    return {
+      .live_bytes = m_allocated_bytes.load(std::memory_order_relaxed),
+      .consumed_bytes = consumed,
+      .high_water_mark_bytes =
+        m_high_water_mark.load(std::memory_order_relaxed),
+      .remaining_bytes = m_capacity - consumed,
+      .capacity_bytes = m_capacity,
+    };
+  }
+
+  // Must not race with allocation, as a concurrent allocation could be handed
+  // memory that is reused after the rewind.
+  [[nodiscard]] bool rewind() noexcept
   {
-    m_base.m_ptr = m_storage.data();
-    m_base.m_space = MemorySize;
+    if (m_allocated_bytes.load(std::memory_order_acquire) != 0) {
+      return false;
+    }
+    m_consumed.store(0, std::memory_order_relaxed);
+    return true;
   }
 
+  void* m_begin = nullptr;
+  std::size_t m_capacity = 0;
+  std::atomic<std::size_t> m_consumed = 0;
+  std::atomic<std::size_t> m_allocated_bytes = 0;
+  std::atomic<std::size_t> m_high_water_mark = 0;
+};
+
+template<size_t MemorySize, typename Base = monotonic_allocator_base>
+struct monotonic_allocator
+{
+  monotonic_allocator() = default;
+
   std::pmr::memory_resource* resource()
   {
     return &m_base;
   }
 
+  /**
+   * @brief Allocate memory without going through the virtual interface of
+   * std::pmr::memory_resource
+   *
+   * Memory must be deallocated through `resource()`.
+   *
+   * @param p_bytes - number of bytes to allocate
+   * @param p_alignment - alignment of the allocation
+   * @return void* - the allocated memory
+   * @throws std::bad_alloc if the request cannot be satisfied
+   */
+  [[nodiscard]] void* allocate(std::size_t p_bytes, std::size_t p_alignment)
+  {
+    // Qualified call to guarantee static dispatch
+    return m_base.Base::do_allocate(p_bytes, p_alignment);
+  }
+
+  /**
+   * @brief Allocate memory, returning nullptr rather than reporting failure
+   * through the error policy
+   *
+   * Memory must be deallocated through `resource()`.
+   *
+   * @param p_bytes - number of bytes to allocate
+   * @param p_alignment - alignment of the allocation
+   * @return void* - the allocated memory or nullptr if the request cannot be
+   * satisfied
+   */
+  [[nodiscard]] void* try_allocate(std::size_t p_bytes,
+                                   std::size_t p_alignment) noexcept
+  {
+    return m_base.try_allocate(p_bytes, p_alignment);
+  }
+
   operator std::pmr::memory_resource*()
   {
     return &m_base;
@@ -113,8 +444,34 @@ struct monotonic_allocator
     return &m_base;
   }
 
-  monotonic_allocator_base m_base{};
+  /**
+   * @brief Get the usage statistics of this allocator
+   *
+   * @return monotonic_allocator_stats - current usage statistics
+   */
+  [[nodiscard]] monotonic_allocator_stats stats() const noexcept
+  {
+    return m_base.stats();
+  }
+
+  /**
+   * @brief Make the entire storage available for allocation again
+   *
+   * Rewinding is only permitted once every allocation has been deallocated,
+   * as rewinding earlier would hand out memory that is still in use. This lets
+   * an arena be reused, for example once per frame, rather than reconstructed.
+   * The high water mark is retained.
+   *
+   * @return true - the allocator was rewound
+   * @return false - allocations are still live, nothing was changed
+   */
+  [[nodiscard]] bool rewind() noexcept
+  {
+    return m_base.rewind();
+  }
+
   std::array<std::byte, MemorySize> m_storage = {};
+  Base m_base{ m_storage.data(), MemorySize };
 };
 
 /**
@@ -134,6 +491,11 @@ struct monotonic_allocator
  * amount of bytes is not 0, std::terminate is called. This is to ensure that
  * references to memory within this buffer cannot become invalid.
  *
+ * Once every allocation has been deallocated, `rewind()` makes the whole
+ * buffer available again so the allocator can be reused. `stats()` reports the
+ * live, consumed and remaining bytes along with the high water mark, which can
+ * be used to right-size `StorageSizeBytes`.
+ *
  * @tparam StorageSizeBytes - Number of bytes for allocator memory
  * @return monotonic_allocator - the monotonic allocator arena
  */
@@ -144,1930 +506,7045 @@ monotonic_allocator<StorageSizeBytes> make_monotonic_allocator()
 }
 
 /**
- * @brief Control block for reference counting - type erased.
+ * @brief Creates a monotonic allocator that can be shared across threads
  *
- * This structure manages the lifetime of reference-counted objects by tracking
- * strong and weak references. It also stores the memory allocator and destroy
- * function used to clean up the object when no more references exist.
+ * Behaves like `make_monotonic_allocator`, including the termination check on
+ * destruction, but allocation and deallocation are lock free and may be called
+ * concurrently from any thread. Memory may be deallocated on a different
+ * thread than the one that allocated it. This allows a pool of threads to
+ * share one arena without a global lock.
+ *
+ * `rewind()` must only be called once the threads using the arena have
+ * finished allocating, for example between frames.
+ *
+ * @tparam StorageSizeBytes - Number of bytes for allocator memory
+ * @return monotonic_allocator - the thread safe monotonic allocator arena
  */
-struct ref_info
+export template<size_t StorageSizeBytes>
+monotonic_allocator<StorageSizeBytes, concurrent_monotonic_allocator_base>
+make_concurrent_monotonic_allocator()
 {
-  /**
-   * @brief Destroy function for ref counted object
-   *
-   * Always returns the total size of the object wrapped in a ref count object.
-   * Thus the size should normally be greater than sizeof(T). Expect sizeof(T) +
-   * sizeof(ref_info) and anything else the ref count object may contain.
-   *
-   * If a nullptr is passed to the destroy function, it returns the object size
-   * but does not destroy the object.
-   */
-  using type_erased_destruct_function_t = std::size_t(void const*);
+  return monotonic_allocator<StorageSizeBytes,
+                             concurrent_monotonic_allocator_base>();
+}
+
+/**
+ * @brief Reference counting policy for single threaded use
+ *
+ * Counts are plain integers and every operation compiles down to a single
+ * increment, decrement or compare. This is the default policy and is intended
+ * for MCUs and any application that does not share ownership across threads.
+ *
+ * The strong and weak counts always begin at 1 since creation implies a
+ * strong reference and all strong references share a single weak reference.
+ *
+ * @tparam Count - signed integer type used for each count
+ */
+export template<std::signed_integral Count>
+struct unsynchronized_count_policy
+{
+  using count_t = Count;
 
-  /// Initialize to 1 since creation implies a reference
-  std::pmr::memory_resource* allocator;
-  type_erased_destruct_function_t* destroy = nullptr;
-  int strong_count = 0;
-  int weak_count = 0;
+  struct counts
+  {
+    count_t strong = 1;
+    count_t weak = 1;
+  };
 
-  // Add explicit constructor to avoid aggregate initialization issues
-  constexpr ref_info(std::pmr::memory_resource* p_allocator,
-                     type_erased_destruct_function_t* p_destroy)
-    : allocator(p_allocator)
-    , destroy(p_destroy)
+  static constexpr void add_strong(counts& p_counts) noexcept
   {
+    ++p_counts.strong;
   }
 
-  /**
-   * @brief Add strong reference to control block
-   *
-   */
-  constexpr void add_ref()
+  /// @return true - if this released the last strong reference
+  static constexpr bool release_strong(counts& p_counts) noexcept
   {
-    strong_count++;
+    return --p_counts.strong == 0;
   }
 
-  /**
-   * @brief Release strong reference from control block
-   *
-   * If this was the last strong reference, the pointed-to object will be
-   * destroyed. If there are no remaining weak references, the memory
-   * will also be deallocated.
-   */
-  constexpr void release()
+  /// @return true - if the strong count was non-zero and was incremented
+  static constexpr bool try_add_strong(counts& p_counts) noexcept
   {
-    // Note: fetch_sub returns the previous value, if it was 1 and we subtracted
-    // 1, then the final value is 0. We check below 1 just in case another
-    // thread performs a fetch_sub and gets a 0 or negative value.
-    strong_count--;
-    if (strong_count == 0) {
-      // No more strong references, destroy the object but keep control block
-      // if there are weak references
-
-      // Call the destroy function which will:
-      // 1. Call the destructor of the object
-      // 2. Return the size of the rc for deallocation when needed
-      auto const object_size = destroy(this);
-
-      // If there are no weak references, deallocate memory
-      if (weak_count == 0) {
-        // Save allocator for deallocating
-        auto alloc = allocator;
-
-        // Deallocate memory
-        alloc->deallocate(this, object_size);
-      }
+    if (p_counts.strong == 0) {
+      return false;
     }
+    ++p_counts.strong;
+    return true;
   }
 
-  /**
-   * @brief Add weak reference to control block
-   *
-   */
-  constexpr void add_weak()
+  static constexpr void add_weak(counts& p_counts) noexcept
   {
-    weak_count--;
+    ++p_counts.weak;
   }
 
-  /**
-   * @brief Release weak reference from control block
-   *
-   * If this was the last weak reference and there are no remaining
-   * strong references, the memory will be deallocated.
-   *
-   * @param p_info Pointer to the control block
-   */
-  constexpr void release_weak()
+  /// @return true - if this released the last weak reference
+  static constexpr bool release_weak(counts& p_counts) noexcept
   {
-    weak_count--;
-    if (weak_count == 0) {
-      // No more weak references, check if we can deallocate
-      if (strong_count == 0) {
-        // No strong references remain
-        // Get the size from the destroy function
-        auto const object_size = destroy(nullptr);
+    return --p_counts.weak == 0;
+  }
 
-        // Save allocator for deallocating
-        auto alloc = allocator;
+  /// @return true - if the only weak reference left is the one held
+  /// collectively by the strong references
+  [[nodiscard]] static constexpr bool sole_weak(counts const& p_counts) noexcept
+  {
+    return p_counts.weak == 1;
+  }
 
-        // Deallocate memory
-        alloc->deallocate(this, object_size);
-      }
-    }
+  [[nodiscard]] static constexpr count_t strong_count(
+    counts const& p_counts) noexcept
+  {
+    return p_counts.strong;
   }
 };
 
 /**
- * @brief A wrapper that contains both the ref_info and the actual object
+ * @brief Reference counting policy for sharing ownership across threads
  *
- * This structure keeps the control block and managed object together in memory.
+ * Increments are relaxed, as taking a new reference requires an existing
+ * reference and thus cannot race with destruction. Decrements are acq_rel so
+ * that all writes made through other references happen-before the destructor
+ * of the managed object runs on whichever thread releases last.
  *
- * @tparam T The type of the managed object
+ * When both counts fit into a single lock free word, they are packed together
+ * with the strong count in the lower half and the weak count in the upper
+ * half. This keeps the entire state of the control block in one atomic word.
+ *
+ * @tparam Count - signed integer type used for each count
  */
-template<typename T>
-struct rc
+export template<std::signed_integral Count>
+struct atomic_count_policy
 {
-  ref_info m_info;
-  T m_object;
+  using count_t = Count;
+  using word_t = std::conditional_t<(sizeof(count_t) <= sizeof(std::uint16_t)),
+                                    std::uint32_t,
+                                    std::uint64_t>;
 
-  // Constructor that forwards arguments to the object
-  template<typename... Args>
-  constexpr rc(std::pmr::memory_resource* p_alloc, Args&&... args)
-    : m_info(p_alloc, &destruct_this_type_and_return_size)
-    , m_object(std::forward<Args>(args)...)
-  {
-  }
-
-  constexpr static std::size_t destruct_this_type_and_return_size(
-    void const* p_object)
-  {
-    if (p_object != nullptr) {
-      // Cast back into the original rc<T> type and ...
-      auto const* obj = static_cast<rc<T> const*>(p_object);
-      obj->~rc<T>();
-    }
-    // Return size for future deallocation
-    return sizeof(rc<T>);
-  }
-};
-// Check if a type is an array or std::array
-template<typename T>
-struct is_array_like : std::false_type
-{};
+  static constexpr bool packed =
+    sizeof(count_t) * 2 <= sizeof(word_t) &&
+    std::atomic<word_t>::is_always_lock_free;
 
-// NOLINTBEGIN(modernize-avoid-c-arrays)
-// Specialization for C-style arrays
-template<typename T, std::size_t N>
-struct is_array_like<T[N]> : std::true_type
-{};
-// NOLINTEND(modernize-avoid-c-arrays)
+  static constexpr word_t strong_one = 1;
+  static constexpr word_t weak_one = word_t{ 1 } << (sizeof(count_t) * 8);
+  static constexpr word_t strong_mask = weak_one - 1;
 
-// Specialization for std::array
-template<typename T, std::size_t N>
-struct is_array_like<std::array<T, N>> : std::true_type
-{};
+  struct packed_counts
+  {
+    std::atomic<word_t> word = strong_one | weak_one;
+  };
 
-// Helper variable template
-template<typename T>
-constexpr bool is_array_like_v = is_array_like<T>::value;
+  struct split_counts
+  {
+    std::atomic<count_t> strong = 1;
+    std::atomic<count_t> weak = 1;
+  };
 
-// Concept for array-like types
-template<typename T>
-concept array_like = is_array_like_v<T>;
+  using counts = std::conditional_t<packed, packed_counts, split_counts>;
 
-// Concept for non-array-like types
-template<typename T>
-concept non_array_like = not array_like<T>;
+  static void add_strong(counts& p_counts) noexcept
+  {
+    if constexpr (packed) {
+      p_counts.word.fetch_add(strong_one, std::memory_order_relaxed);
+    } else {
+      p_counts.strong.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
 
-/**
- * @ingroup Error
- * @brief Base exception class for all hal related exceptions
- *
- */
-export class exception : public std::exception
-{
-public:
-  exception(std::errc p_error_code)
-    : m_error_code(p_error_code)
+  /// @return true - if this released the last strong reference
+  static bool release_strong(counts& p_counts) noexcept
   {
+    if constexpr (packed) {
+      auto const previous =
+        p_counts.word.fetch_sub(strong_one, std::memory_order_acq_rel);
+      return (previous & strong_mask) == strong_one;
+    } else {
+      return p_counts.strong.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
   }
 
   /**
-   * @brief Convert this exception to the closest C++ error code
-   *
-   * Main Use Case: Translation from C++ exceptions to C error codes
+   * @brief Increment the strong count only if it has not reached zero
    *
-   * Lets consider a situation when a C++ program must interface with C code or
-   * code that uses a C API to operate. Normally C++ code calls C code, but if
-   * C++ code is given to a C API like a callback and that C api expects an
-   * error code back for its own error handling purposes, this class function
-   * provides that error code. Simply catch the mem::exception, and return an
-   * error code. Perform any other recovery or handling required to make the
-   * system perform as expected.
+   * Used by weak_ptr::lock(). A plain load-then-increment would allow another
+   * thread to drop the last strong reference between the two operations and
+   * resurrect an object that is being destroyed.
    *
-   * Other use cases:
-   *
-   * 1. Logging
-   *
-   * Log the error code value (or the stringified version) of this exception to
-   * alert developers of the kind of underlying exception that was thrown.
-   *
-   * 2. Recovery
-   *
-   * This can be used for recovery, but it is HIGHLY RECOMMENDED to use the
-   * derived classes in their own catch blocks to recover from a specific error
-   * rather than using the base class and extracting its error code.
-   *
-   * @return std::errc - error code represented by the exception
+   * @return true - if the strong count was non-zero and was incremented
    */
-  [[nodiscard]] constexpr std::errc error_code() const
+  static bool try_add_strong(counts& p_counts) noexcept
   {
-    return m_error_code;
+    if constexpr (packed) {
+      auto expected = p_counts.word.load(std::memory_order_relaxed);
+      while ((expected & strong_mask) != 0) {
+        if (p_counts.word.compare_exchange_weak(expected,
+                                                expected + strong_one,
+                                                std::memory_order_acq_rel,
+                                                std::memory_order_relaxed)) {
+          return true;
+        }
+      }
+    } else {
+      auto expected = p_counts.strong.load(std::memory_order_relaxed);
+      while (expected != 0) {
+        if (p_counts.strong.compare_exchange_weak(
+              expected,
+              static_cast<count_t>(expected + 1),
+              std::memory_order_acq_rel,
+              std::memory_order_relaxed)) {
+          return true;
+        }
+      }
+    }
+    return false;
   }
 
-  [[nodiscard]] constexpr char const* what() const noexcept override
+  static void add_weak(counts& p_counts) noexcept
   {
-    return "mem::exception";
+    if constexpr (packed) {
+      p_counts.word.fetch_add(weak_one, std::memory_order_relaxed);
+    } else {
+      p_counts.weak.fetch_add(1, std::memory_order_relaxed);
+    }
   }
 
-  // NOLINTNEXTLINE(modernize-use-equals-default)
-  ~exception() override
+  /// @return true - if this released the last weak reference
+  static bool release_weak(counts& p_counts) noexcept
   {
-    // Needed for GCC 14.2 LTO to link 🤷🏾‍♂️
+    if constexpr (packed) {
+      // The weak count only reaches zero after the strong count, so the last
+      // weak release observes the entire word going to zero.
+      return p_counts.word.fetch_sub(weak_one, std::memory_order_acq_rel) ==
+             weak_one;
+    } else {
+      return p_counts.weak.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
   }
 
-private:
-  std::errc m_error_code{};
+  /**
+   * @brief Check if no weak references remain besides the collective one
+   *
+   * Only meaningful once the strong count has reached zero, at which point no
+   * new weak reference can be created. The acquire pairs with the release of
+   * every other weak reference, so the caller may then deallocate without
+   * decrementing the weak count.
+   *
+   * @return true - if the only weak reference left is the one held
+   * collectively by the strong references
+   */
+  [[nodiscard]] static bool sole_weak(counts const& p_counts) noexcept
+  {
+    if constexpr (packed) {
+      return p_counts.word.load(std::memory_order_acquire) == weak_one;
+    } else {
+      return p_counts.weak.load(std::memory_order_acquire) == 1;
+    }
+  }
+
+  [[nodiscard]] static count_t strong_count(counts const& p_counts) noexcept
+  {
+    if constexpr (packed) {
+      return static_cast<count_t>(
+        p_counts.word.load(std::memory_order_acquire) & strong_mask);
+    } else {
+      return p_counts.strong.load(std::memory_order_acquire);
+    }
+  }
 };
 
 /**
- * @ingroup Error
- * @brief Raised when an API attempts to access elements outside of a container
- * or resource.
+ * @brief Integer type used for the strong and weak reference counts
  *
+ * Selected at build time by LIBHAL_STRONG_PTR_COUNT_BITS. 16-bit counts
+ * shrink the control block on embedded targets where no object is shared more
+ * than a few thousand times, 64-bit counts remove any practical limit.
  */
-export struct out_of_range : public exception
+export using ref_count_t =
+  std::conditional_t<(LIBHAL_STRONG_PTR_COUNT_BITS == 16),
+                     std::int16_t,
+                     std::conditional_t<(LIBHAL_STRONG_PTR_COUNT_BITS == 64),
+                                        std::int64_t,
+                                        std::int32_t>>;
+
+static_assert(sizeof(ref_count_t) * 8 == LIBHAL_STRONG_PTR_COUNT_BITS,
+              "LIBHAL_STRONG_PTR_COUNT_BITS must be one of 16, 32 or 64");
+
+/**
+ * @brief The reference counting policy used by all control blocks
+ *
+ * Selected at build time by LIBHAL_STRONG_PTR_THREAD_SAFE so that every
+ * translation unit importing this module agrees on the control block layout.
+ */
+export using ref_count_policy =
+  std::conditional_t<(LIBHAL_STRONG_PTR_THREAD_SAFE != 0),
+                     atomic_count_policy<ref_count_t>,
+                     unsynchronized_count_policy<ref_count_t>>;
+
+/**
+ * @brief true if reference counts may be safely modified from multiple threads
+ */
+export constexpr bool thread_safe_ref_count =
+  std::is_same_v<ref_count_policy, atomic_count_policy<ref_count_t>>;
+
+/**
+ * @brief true if reference count instrumentation is compiled in
+ *
+ * Enabled by defining LIBHAL_STRONG_PTR_INSTRUMENTATION=1. When disabled, every
+ * instrumentation hook compiles to nothing.
+ */
+export constexpr bool ref_count_instrumentation =
+  (LIBHAL_STRONG_PTR_INSTRUMENTATION != 0);
+
+/**
+ * @brief Snapshot of the reference counting operations performed on a type
+ *
+ * Operations are counted against the pointed-to type of the handle performing
+ * them, ignoring cv qualifiers. Creating an object counts as a strong
+ * increment, so when no handles of a type are alive, and none were converted to
+ * or from handles of other types, increments and decrements of each kind are
+ * equal. A large number of increments relative to destructions points at
+ * strong_ptr being copied where a reference or move would do.
+ */
+export struct ref_count_stats
 {
-  struct info
-  {
-    std::size_t m_index;
-    std::size_t m_capacity;
-  };
+  /// Strong references acquired, including creation and successful locks
+  std::uint64_t strong_increments = 0;
+  /// Strong references released
+  std::uint64_t strong_decrements = 0;
+  /// Weak references acquired
+  std::uint64_t weak_increments = 0;
+  /// Weak references released
+  std::uint64_t weak_decrements = 0;
+  /// weak_ptr::lock calls that failed because the object was destroyed
+  std::uint64_t failed_locks = 0;
+  /// Objects destroyed by the release of their last strong reference
+  std::uint64_t destructions = 0;
+};
 
-  out_of_range(info p_info)
-    : exception(std::errc::invalid_argument)
-    , info(p_info)
+/// Reference counting events recorded by the instrumentation
+enum class ref_event : std::uint8_t
+{
+  strong_increment,
+  strong_decrement,
+  weak_increment,
+  weak_decrement,
+  failed_lock,
+  destruction,
+};
+
+/**
+ * @brief Event counters of a single type, `void` holds the totals
+ */
+template<typename T>
+struct ref_event_counters
+{
+  using counter = std::conditional_t<thread_safe_ref_count,
+                                     std::atomic<std::uint64_t>,
+                                     std::uint64_t>;
+
+  static void increment(ref_event p_event) noexcept
   {
+    increment(counters[static_cast<std::size_t>(p_event)]);
   }
 
-  [[nodiscard]] constexpr char const* what() const noexcept override
+  static std::uint64_t load(ref_event p_event) noexcept
   {
-    return "mem::out_of_range";
+    return load(counters[static_cast<std::size_t>(p_event)]);
   }
 
-  // NOLINTNEXTLINE(modernize-use-equals-default)
-  ~out_of_range() override
+  static void increment(std::atomic<std::uint64_t>& p_counter) noexcept
   {
-    // Needed for GCC 14.2 LTO to link 🤷🏾‍♂️
+    // Counts must be exact but need no ordering with other memory
+    p_counter.fetch_add(1, std::memory_order_relaxed);
   }
 
-  info info;
-};
-
-/**
- * @ingroup Error
- * @brief Raised when an API attempts to access the contents of an empty
- * optional_ptr.
- *
- */
-export struct nullptr_access : public exception
-{
-  nullptr_access()
-    : exception(std::errc::invalid_argument)
+  static void increment(std::uint64_t& p_counter) noexcept
   {
+    p_counter++;
   }
 
-  [[nodiscard]] constexpr char const* what() const noexcept override
+  static std::uint64_t load(
+    std::atomic<std::uint64_t> const& p_counter) noexcept
   {
-    return "mem::nullptr_access";
+    return p_counter.load(std::memory_order_relaxed);
   }
 
-  // NOLINTNEXTLINE(modernize-use-equals-default)
-  ~nullptr_access() override
+  static std::uint64_t load(std::uint64_t const& p_counter) noexcept
   {
-    // Needed for GCC 14.2 LTO to link 🤷🏾‍♂️
+    return p_counter;
   }
+
+  inline static std::array<counter, 6> counters{};
 };
 
 /**
- * @brief API tag used to create a strong_ptr which points to static memory
- *
- * As the name implies this is unsafe and is up to the developer to ensure that
- * the object passed to strong_ptr actually has static storage duration.
- *
+ * @brief Record a reference counting event for type T and for the totals
  */
-export struct unsafe_assume_static_tag
-{};
+template<typename T>
+constexpr void record_ref_event([[maybe_unused]] ref_event p_event) noexcept
+{
+  if constexpr (ref_count_instrumentation) {
+    if constexpr (not std::is_void_v<T>) {
+      ref_event_counters<std::remove_cv_t<T>>::increment(p_event);
+    }
+    ref_event_counters<void>::increment(p_event);
+  }
+}
 
 /**
- * @brief A non-nullable strong reference counted pointer
- *
- * strong_ptr is a smart pointer that maintains shared ownership of an object
- * through a reference count. It is similar to std::shared_ptr but with these
- * key differences:
- *
- * 1. Cannot be null - must always point to a valid object
- * 2. Can only be created via make_strong_ptr, not from raw pointers
- * 3. More memory efficient implementation
+ * @brief Get the reference counting operations recorded for a type
  *
- * Use strong_ptr when you need shared ownership semantics and can guarantee
- * the pointer will never be null. For nullable references, use optional_ptr.
+ * Always returns zeros unless LIBHAL_STRONG_PTR_INSTRUMENTATION is enabled.
  *
  * Example usage:
+ * ```
+ * auto stats = mem::ref_count_stats_for<my_driver>();
+ * auto totals = mem::ref_count_stats_for<>();
+ * ```
  *
- * ```C++
- * // Create a strong_ptr to an object
- * auto i2c = mem::make_strong_ptr<my_i2c_driver>(allocator, arg1, arg2);
+ * @tparam T - pointed-to type, or void for the totals of every type
+ * @return ref_count_stats - counts recorded since start or the last reset
+ */
+export template<typename T = void>
+[[nodiscard]] ref_count_stats ref_count_stats_for() noexcept
+{
+  if constexpr (ref_count_instrumentation) {
+    using counters = ref_event_counters<std::remove_cv_t<T>>;
+    return {
+      .strong_increments = counters::load(ref_event::strong_increment),
+      .strong_decrements = counters::load(ref_event::strong_decrement),
+      .weak_increments = counters::load(ref_event::weak_increment),
+      .weak_decrements = counters::load(ref_event::weak_decrement),
+      .failed_locks = counters::load(ref_event::failed_lock),
+      .destructions = counters::load(ref_event::destruction),
+    };
+  } else {
+    return {};
+  }
+}
+
+/**
+ * @brief Reset the reference counting operations recorded for a type
  *
- * // Use the object using dereference (*) operator
- * (*i2c).configure({ .clock_rate = 250_kHz });
+ * The totals are not affected when T is not void.
  *
- * // OR use the object using arrow (->) operator
- * i2c->configure({ .clock_rate = 250_kHz });
+ * @tparam T - pointed-to type, or void for the totals of every type
+ */
+export template<typename T = void>
+void reset_ref_count_stats() noexcept
+{
+  if constexpr (ref_count_instrumentation) {
+    for (auto& event_counter :
+         ref_event_counters<std::remove_cv_t<T>>::counters) {
+      event_counter = 0;
+    }
+  }
+}
+
+/**
+ * @brief Control block for reference counting - type erased.
  *
- * // Share ownership with another driver or object
- * auto sensor = mem::make_strong_ptr<my_sensor>(allocator, i2c, 0x13);
- * ```
+ * This structure manages the lifetime of reference-counted objects by tracking
+ * strong and weak references. Everything that depends on the type of the
+ * managed object or on where its memory came from is handled by a single
+ * manager function, keeping the control block to one function pointer and the
+ * reference counts.
  *
- * @tparam T The type of the managed object
+ * Creation implies a single strong reference. All strong references
+ * collectively hold one weak reference, which is released when the last
+ * strong reference is released. This ensures that the control block is
+ * deallocated exactly once, even when the last strong_ptr and the last
+ * weak_ptr are released concurrently.
  */
-template<typename T>
-class strong_ptr
+struct ref_info
 {
-public:
-  using element_type = std::remove_extent_t<T>;
-  using weak_type = weak_ptr<T>;
+  /// Operations performed by the type specific manager function
+  enum class operation : std::uint8_t
+  {
+    /// Destroy the managed object, or queue it for deferred destruction,
+    /// returns nullptr
+    destroy,
+    /// Destroy the managed object now, even if its destruction is deferred,
+    /// returns nullptr
+    finalize,
+    /// Return the memory to the memory resource, returns nullptr
+    deallocate,
+    /// destroy followed by deallocate, used when no weak references remain.
+    /// A deferred object is queued instead and the domain takes over the
+    /// collective weak reference, returns nullptr
+    destroy_and_deallocate,
+    /// Return the memory resource that allocated the memory
+    get_allocator,
+  };
 
-  /// Delete default constructor - strong_ptr must always be valid
-  strong_ptr() = delete;
+  using manager_function_t = std::pmr::memory_resource*(ref_info*, operation);
+  using policy = ref_count_policy;
 
-  /// Delete nullptr constructor - strong_ptr must always be valid
-  strong_ptr(std::nullptr_t) = delete;
+  manager_function_t* manager;
+  policy::counts counts{};
+
+  // Add explicit constructor to avoid aggregate initialization issues
+  constexpr explicit ref_info(manager_function_t* p_manager)
+    : manager(p_manager)
+  {
+  }
 
   /**
-   * @brief Create a strong_ptr that points to points to an object with static
-   * storage duration.
-   *
-   * This API MUST only be used with objects with static storage duration.
-   * Without that precondition met, it is UB to create such a strong_ptr.
-   *
-   * There is no way in C++23 and below to determine if an lvalue passed has
-   * static storage duration. With C++26 and `std::has_static_storage_duration`
-   * we can determine this at compile time and provide a compile time error if
-   * the passed lvalue is not an object with static storage duration. This
-   * constructor will be deprecated once the library migrates to C++26.
-   *
-   * Since the original object was statically allocated, there is no need for a
-   * ref counted control block and thus no allocation occurs. `use_count()` will
-   * return 0 meaning that the object is statically allocated.
+   * @brief Add strong reference to control block
    *
-   * @param p_object - a statically allocated object to
-   * @return strong_ptr<T> - A strong_ptr pointing to lvalue which should have
-   * static storage duration.
+   * @tparam T - pointed-to type, recorded by the instrumentation
    */
-  constexpr strong_ptr(unsafe_assume_static_tag, T& p_object)
-    : m_ptr(&p_object)
+  template<typename T = void>
+  void add_ref()
   {
+    record_ref_event<T>(ref_event::strong_increment);
+    policy::add_strong(counts);
   }
 
   /**
-   * @brief Copy constructor
+   * @brief Attempt to add a strong reference to the control block
    *
-   * Creates a new strong reference to the same object.
+   * Fails if the managed object has already been, or is being, destroyed.
    *
-   * @param p_other The strong_ptr to copy from
+   * @tparam T - pointed-to type, recorded by the instrumentation
+   * @return true - a strong reference was added
+   * @return false - the strong count had reached zero
    */
-  constexpr strong_ptr(strong_ptr const& p_other) noexcept
-    : m_ctrl(p_other.m_ctrl)
-    , m_ptr(p_other.m_ptr)
+  template<typename T = void>
+  bool try_add_ref()
   {
-    add_ref();
+    bool const acquired = policy::try_add_strong(counts);
+    record_ref_event<T>(acquired ? ref_event::strong_increment
+                                 : ref_event::failed_lock);
+    return acquired;
   }
 
   /**
-   * @brief Converting copy constructor
+   * @brief Release strong reference from control block
    *
-   * Creates a new strong reference to the same object, converting from
-   * a derived type U to base type T.
+   * If this was the last strong reference, the pointed-to object will be
+   * destroyed. If there are no remaining weak references, the memory
+   * will also be deallocated.
    *
-   * @tparam U A type convertible to T
-   * @param p_other The strong_ptr to copy from
+   * @tparam T - pointed-to type, recorded by the instrumentation
    */
-  template<typename U>
-  constexpr strong_ptr(strong_ptr<U> const& p_other) noexcept
-    requires(std::is_convertible_v<U*, T*>)
-    : m_ctrl(p_other.m_ctrl)
-    , m_ptr(p_other.m_ptr)
+  template<typename T = void>
+  void release()
   {
-    add_ref();
+    record_ref_event<T>(ref_event::strong_decrement);
+    if (policy::release_strong(counts)) {
+      record_ref_event<T>(ref_event::destruction);
+      release_last();
+    }
   }
 
   /**
-   * @brief Move constructor that intentionally behaves like a copy constructor
-   * for safety
-   *
-   * This move constructor deliberately performs a full copy operation rather
-   * than transferring ownership. This is a safety feature to prevent potential
-   * undefined behavior that could occur if code accidentally accessed a
-   * moved-from strong_ptr.
-   *
-   * After this operation, both the source and destination objects remain in
-   * valid states, and the reference count is incremented by 1. This ensures
-   * that even if code incorrectly continues to use the source object after a
-   * move, no undefined behavior will occur.
+   * @brief Add weak reference to control block
    *
-   * @param p_other The strong_ptr to "move" from (actually copied for safety)
+   * @tparam T - pointed-to type, recorded by the instrumentation
    */
-  constexpr strong_ptr(strong_ptr&& p_other) noexcept
-    : m_ctrl(p_other.m_ctrl)
-    , m_ptr(p_other.m_ptr)
+  template<typename T = void>
+  void add_weak()
   {
-    add_ref();
+    record_ref_event<T>(ref_event::weak_increment);
+    policy::add_weak(counts);
   }
 
   /**
-   * @brief Move assignment operator that behaves like a copy assignment for
-   * safety
+   * @brief Release weak reference from control block
    *
-   * This move assignment operator deliberately performs a full copy operation
-   * rather than transferring ownership. This is a safety feature to prevent
-   * potential undefined behavior that could occur if code accidentally accessed
-   * a moved-from strong_ptr.
+   * If this was the last weak reference and there are no remaining
+   * strong references, the memory will be deallocated.
    *
-   * After this operation, both the source and destination objects remain in
-   * valid states, and the reference count is incremented by 1. This ensures
-   * that even if code incorrectly continues to use the source object after a
-   * move, no undefined behavior will occur.
+   * @tparam T - pointed-to type, recorded by the instrumentation
+   */
+  template<typename T = void>
+  void release_weak()
+  {
+    record_ref_event<T>(ref_event::weak_decrement);
+    drop_weak();
+  }
+
+  /**
+   * @brief Get the current number of strong references
    *
-   * @param p_other The strong_ptr to "move" from (actually copied for safety)
-   * @return Reference to *this
+   * @return ref_count_t - the number of strong references
    */
-  constexpr strong_ptr& operator=(strong_ptr&& p_other) noexcept
+  [[nodiscard]] ref_count_t use_count() const
   {
-    if (this != &p_other) {
-      release();
-      m_ctrl = p_other.m_ctrl;
-      m_ptr = p_other.m_ptr;
-      add_ref();
-    }
-    return *this;
+    return policy::strong_count(counts);
   }
 
   /**
-   * @brief Compile time error message for bad alias value
+   * @brief Get the memory resource used to allocate this control block
    *
-   * `std::shared_ptr` provides an alias constructor that accepts any `void*`
-   * which is UB if that `void*` doesn't have the same lifetime as the object
-   * referenced by the `std::shared_ptr`. Users attempting to do this will get a
-   * list of constructors that failed to fit. This is not a good error message
-   * for users. Instead, we provide a static_assert message in plain english
-   * that explains why this overload fails at compile time.
-   *
-   * @tparam U - some type for the strong_ptr.
+   * @return std::pmr::memory_resource* - the memory resource
    */
-  template<typename U>
-  constexpr strong_ptr(strong_ptr<U> const&, void const*) noexcept
+  [[nodiscard]] std::pmr::memory_resource* allocator()
   {
-    // NOTE: The conditional used here is to prevent the compiler from
-    // jumping-the-gun and emitting the static assert error during template
-    // instantiation of the class. With this conditional, the error only appears
-    // when this constructor is used.
-    static_assert(
-      std::is_same_v<U, void> && not std::is_same_v<U, void>,
-      "Aliasing constructor only works with pointers-to-members "
-      "and does not work with arbitrary pointers like std::shared_ptr allows.");
+    return manager(this, operation::get_allocator);
   }
 
-  /**
-   * @brief Safe aliasing constructor for object members
-   *
-   * This constructor creates a strong_ptr that points to a member of an object
-   * managed by another strong_ptr. The resulting strong_ptr shares ownership
-   * with the original strong_ptr, keeping the entire parent object alive.
-   *
-   * This version is only enabled for non-array members to prevent potential
-   * undefined behavior when accessing array elements directly. Use the
-   * array-specific versions instead.
-   *
-   * Example usage:
-   * ```
-   * struct container {
-   *   component part;
-   * };
-   *
-   * // Create a strong_ptr to the container
-   * auto container_ptr = make_strong_ptr<container>(allocator);
-   *
-   * // Create a strong_ptr to just the component
-   * auto component_ptr = strong_ptr<component>(container_ptr,
-   * &container::part);
-   * ```
-   *
-   * @tparam U Type of the parent object
-   * @tparam M Type of the member
-   * @param p_other The strong_ptr to the parent object
-   * @param p_member_ptr Pointer-to-member identifying which member to reference
-   */
-  template<typename U, non_array_like M>
-  constexpr strong_ptr(strong_ptr<U> const& p_other,
-                       // clang-format off
-             M U::* p_member_ptr
-                       // clang-format on
-                       ) noexcept
+private:
+  // The teardown below does not depend on the pointed-to type, so it is kept
+  // out of line and shared, leaving only the decrement inlined in each
+  // instantiation of release() and release_weak()
 
-    : m_ctrl(p_other.m_ctrl)
-    , m_ptr(&((*p_other).*p_member_ptr))
+  LIBHAL_STRONG_PTR_NOINLINE void release_last()
   {
-    add_ref();
+    // Nothing can observe the control block any more, so destroy and
+    // deallocate with a single indirect call
+    if (policy::sole_weak(counts)) {
+      manager(this, operation::destroy_and_deallocate);
+      return;
+    }
+
+    // No more strong references, destroy the object but keep control block
+    // if there are weak references
+    manager(this, operation::destroy);
+
+    // Release the weak reference held collectively by the strong references
+    drop_weak();
   }
 
-  /**
-   * @brief Safe aliasing constructor for std::array members
-   *
-   * This constructor creates a strong_ptr that points to an element of an array
-   * member in an object managed by another strong_ptr. It performs bounds
-   * checking to ensure the index is valid.
-   *
-   * Example usage:
-   * ```
-   * struct array_container {
-   *   std::array<element, 5> elements;
-   * };
-   *
-   * auto container_ptr = make_strong_ptr<array_container>(allocator);
-   *
-   * // Get strong_ptr to the 2nd element
-   * auto element_ptr = strong_ptr<element>(
-   *   container_ptr,
-   *   &array_container::elements,
-   *   2 // Index to access
-   * );
-   * ```
-   *
-   * @tparam U Type of the parent object
-   * @tparam E Type of the array element
-   * @tparam N Size of the array
-   * @param p_other The strong_ptr to the parent object
-   * @param p_array_ptr Pointer-to-member identifying the array member
-   * @param p_index Index of the element to reference
-   * @throws mem::out_of_range if index is out of bounds
-   */
-  template<typename U, typename E, std::size_t N>
-  constexpr strong_ptr(strong_ptr<U> const& p_other,
-                       // clang-format off
-             std::array<E, N> U::* p_array_ptr,
-                       // clang-format on
-                       std::size_t p_index)
+  LIBHAL_STRONG_PTR_NOINLINE void drop_weak()
   {
-    static_assert(std::is_convertible_v<E*, T*>,
-                  "Array element type must be convertible to T");
-    throw_if_out_of_bounds(N, p_index);
-    m_ctrl = p_other.m_ctrl;
-    m_ptr = &((*p_other).*p_array_ptr)[p_index];
-    add_ref();
+    if (policy::release_weak(counts)) {
+      // No strong or weak references remain
+      manager(this, operation::deallocate);
+    }
   }
+};
 
-  // NOLINTBEGIN(modernize-avoid-c-arrays)
-  /**
-   * @brief Safe aliasing constructor for C-array members
-   *
-   * This constructor creates a strong_ptr that points to an element of a
-   * C-style array member in an object managed by another strong_ptr. It
-   * performs bounds checking to ensure the index is valid.
-   *
-   * Example usage:
-   * ```
-   * struct c_array_container {
-   *   element elements[5];
-   * };
-   *
-   * auto container_ptr = make_strong_ptr<c_array_container>(allocator);
-   *
-   * // Get strong_ptr to the 2nd element
-   * auto element_ptr = strong_ptr<element>(
-   *   container_ptr,
-   *   &c_array_container::elements,
-   *   2 // Index to access
-   * );
-   * ```
-   *
-   * @tparam U Type of the parent object
-   * @tparam E Type of the array element
-   * @tparam N Size of the array
-   * @param p_other The strong_ptr to the parent object
-   * @param p_array_ptr Pointer-to-member identifying the array member
-   * @param p_index Index of the element to reference
-   * @throws mem::out_of_range if index is out of bounds
-   */
-  template<typename U, typename E, std::size_t N>
-  constexpr strong_ptr(strong_ptr<U> const& p_other,
-                       E (U::*p_array_ptr)[N],
-                       std::size_t p_index)
+/**
+ * @brief Memory resource provided at runtime and stored in the control block
+ */
+struct runtime_resource
+{
+  [[nodiscard]] constexpr std::pmr::memory_resource* get() const noexcept
   {
-    static_assert(std::is_convertible_v<E*, T*>,
-                  "Array element type must be convertible to T");
-    throw_if_out_of_bounds(N, p_index);
-    m_ctrl = p_other.m_ctrl;
-    m_ptr = &((*p_other).*p_array_ptr)[p_index];
-    add_ref();
+    return m_resource;
   }
-  // NOLINTEND(modernize-avoid-c-arrays)
 
-  /**
-   * @brief Destructor
-   *
-   * Decrements the reference count and destroys the managed object
-   * if this was the last strong reference.
-   */
-  ~strong_ptr()
+  std::pmr::memory_resource* m_resource;
+};
+
+/**
+ * @brief Memory resource known at compile time
+ *
+ * Pass `mem::static_resource<my_resource>` to `make_strong_ptr` in place of a
+ * `std::pmr::memory_resource*` to avoid storing the memory resource pointer in
+ * every control block. The resource is referred to by its name so it must
+ * have static storage duration. It may be any `std::pmr::memory_resource` or
+ * any object convertible to `std::pmr::memory_resource*` such as the allocator
+ * returned by `make_monotonic_allocator`.
+ *
+ * @tparam Resource - memory resource with static storage duration
+ */
+export template<auto& Resource>
+struct static_resource_t
+{
+  [[nodiscard]] static std::pmr::memory_resource* get() noexcept
   {
-    release();
+    if constexpr (std::is_convertible_v<decltype(&Resource),
+                                        std::pmr::memory_resource*>) {
+      return &Resource;
+    } else {
+      return static_cast<std::pmr::memory_resource*>(Resource);
+    }
   }
+};
 
-  /**
-   * @brief Copy assignment operator
-   *
-   * Replaces the managed object with the one managed by p_other.
-   *
-   * @param p_other The strong_ptr to copy from
-   * @return Reference to *this
-   */
-  constexpr strong_ptr& operator=(strong_ptr const& p_other) noexcept
+/**
+ * @brief Tag used to pass a compile time memory resource to make_strong_ptr
+ *
+ * @tparam Resource - memory resource with static storage duration
+ */
+export template<auto& Resource>
+constexpr static_resource_t<Resource> static_resource{};
+
+/**
+ * @brief Link of an object waiting in a deferred_destruction_domain
+ */
+struct deferred_node
+{
+  deferred_node* m_next = nullptr;
+  ref_info* m_owner = nullptr;
+};
+
+/**
+ * @brief Defers the destruction of objects to a time of your choosing
+ *
+ * Normally the thread that releases the last strong reference to an object
+ * runs its destructor and deallocates its memory. For real time code, such as
+ * an interrupt handler or a network thread, an expensive destructor chain on
+ * that path is unacceptable. Objects created with `make_deferred_strong_ptr`
+ * are instead pushed onto this domain's lock-free list when their last strong
+ * reference is released, and are destroyed and deallocated when `drain()` is
+ * called, for example from an idle task or a background thread.
+ *
+ * Once the last strong reference is released, `weak_ptr::lock()` fails just as
+ * it would for an object destroyed immediately.
+ *
+ * Any thread may release deferred objects concurrently, but only one thread
+ * may call `drain()` at a time. The domain must outlive every object created
+ * with it. If objects created with it are still alive when the domain is
+ * destroyed, std::terminate is called, as they would otherwise be pushed onto
+ * a destroyed domain.
+ *
+ * Example usage:
+ * ```
+ * mem::deferred_destruction_domain graveyard;
+ *
+ * // Network thread, dropping the last reference only queues the session
+ * auto session = mem::make_deferred_strong_ptr<tcp_session>(graveyard, alloc);
+ *
+ * // Idle task, destroy at most 8 objects per call
+ * graveyard.drain(8);
+ * ```
+ */
+export class deferred_destruction_domain
+{
+public:
+  deferred_destruction_domain() = default;
+
+  deferred_destruction_domain(deferred_destruction_domain const&) = delete;
+  deferred_destruction_domain& operator=(deferred_destruction_domain const&) =
+    delete;
+  deferred_destruction_domain(deferred_destruction_domain&&) = delete;
+  deferred_destruction_domain& operator=(deferred_destruction_domain&&) =
+    delete;
+
+  ~deferred_destruction_domain()
   {
-    if (this != &p_other) {
-      release();
-      m_ctrl = p_other.m_ctrl;
-      m_ptr = p_other.m_ptr;
-      add_ref();
+    drain();
+    if (m_objects.load(std::memory_order_acquire) != 0) {
+      std::terminate();
     }
-    return *this;
   }
 
   /**
-   * @brief Converting copy assignment operator
+   * @brief Destroy and deallocate objects waiting in this domain
    *
-   * Replaces the managed object with the one managed by p_other,
-   * converting from type U to type T.
+   * Objects released by the destructors run here are queued and may be
+   * destroyed by this same call if the budget allows.
    *
-   * @tparam U A type convertible to T
-   * @param p_other The strong_ptr to copy from
-   * @return Reference to *this
+   * @param p_budget - maximum number of objects to destroy
+   * @return std::size_t - number of objects destroyed
    */
-  template<typename U>
-  constexpr strong_ptr& operator=(strong_ptr<U> const& p_other) noexcept
-    requires(std::is_convertible_v<U*, T*>)
+  std::size_t drain(
+    std::size_t p_budget = std::numeric_limits<std::size_t>::max())
   {
-    release();
-    m_ctrl = p_other.m_ctrl;
-    m_ptr = p_other.m_ptr;
-    add_ref();
-    return *this;
+    std::size_t destroyed = 0;
+    while (destroyed < p_budget) {
+      if (m_draining == nullptr) {
+        m_draining = m_pending.exchange(nullptr, std::memory_order_acquire);
+        if (m_draining == nullptr) {
+          break;
+        }
+      }
+
+      auto* owner = m_draining->m_owner;
+      // Advance first, the node is released along with the object
+      m_draining = m_draining->m_next;
+
+      owner->manager(owner, ref_info::operation::finalize);
+      // Release the weak reference taken when the object was deferred
+      owner->release_weak();
+      m_objects.fetch_sub(1, std::memory_order_release);
+      destroyed++;
+    }
+    return destroyed;
   }
 
   /**
-   * @brief Swap the contents of this strong_ptr with another
+   * @brief Check if no objects are waiting to be destroyed
    *
-   * @param p_other The strong_ptr to swap with
+   * @return true - nothing to drain
+   * @return false - at least one object is waiting to be destroyed
    */
-  constexpr void swap(strong_ptr& p_other) noexcept
+  [[nodiscard]] bool empty() const noexcept
   {
-    std::swap(m_ctrl, p_other.m_ctrl);
-    std::swap(m_ptr, p_other.m_ptr);
+    return m_draining == nullptr &&
+           m_pending.load(std::memory_order_relaxed) == nullptr;
   }
 
-  /**
-   * @brief Disable dereferencing for r-values (temporaries)
-   */
-  T& operator*() && = delete;
+private:
+  template<typename Resource>
+  friend struct deferred_resource;
 
-  /**
-   * @brief Disable member access for r-values (temporaries)
-   */
-  T* operator->() && = delete;
+  friend struct strong_ptr_factory;
 
-  /**
-   * @brief Dereference operator to access the managed object
-   *
-   * @return Reference to the managed object
-   */
-  [[nodiscard]] constexpr T& operator*() const& noexcept
+  void push(deferred_node* p_node) noexcept
   {
-    return *m_ptr;
+    // Treiber stack push, safe from any number of threads. The single
+    // consumer takes the entire stack at once, so there is no ABA problem.
+    auto* head = m_pending.load(std::memory_order_relaxed);
+    do {
+      p_node->m_next = head;
+    } while (not m_pending.compare_exchange_weak(
+      head, p_node, std::memory_order_release, std::memory_order_relaxed));
   }
 
-  /**
-   * @brief Member access operator to access the managed object
-   *
-   * @return Pointer to the managed object
-   */
-  [[nodiscard]] constexpr T* operator->() const& noexcept
-  {
-    return m_ptr;
-  }
+  std::atomic<deferred_node*> m_pending = nullptr;
+  std::atomic<std::size_t> m_objects = 0;
+  deferred_node* m_draining = nullptr;
+};
 
-  /**
-   * @brief Get the current reference count
-   *
-   * This is primarily for testing purposes.
-   *
-   * @return The number of strong references to the managed object
-   */
-  [[nodiscard]] constexpr auto use_count() const noexcept
+/**
+ * @brief Memory resource of an object whose destruction is deferred
+ *
+ * Stored at the end of the rc allocation in place of the plain resource, so
+ * deferred objects carry the link needed to queue them without a separate
+ * allocation.
+ *
+ * @tparam Resource - runtime_resource or static_resource_t
+ */
+template<typename Resource>
+struct deferred_resource
+{
+  [[nodiscard]] constexpr std::pmr::memory_resource* get() const noexcept
   {
-    return m_ctrl ? m_ctrl->strong_count : 0;
+    return m_resource.get();
   }
 
-  /**
-   * @brief Returns if the object this is pointing to is statically allocated or
-   * not.
-   *
-   * @return true - object is assumed to have static storage duration.
-   * @return false - object has dynamic storage duration.
-   */
-  constexpr bool is_dynamic()
+  void defer(ref_info* p_owner) noexcept
   {
-    return m_ctrl != nullptr;
+    m_node.m_owner = p_owner;
+    m_domain->push(&m_node);
   }
 
-  /**
-   * @brief Get the allocator used to allocate this object
-   *
-   * @return constexpr std::pmr::memory_resource* - the allocator used to
-   * allocate this object. Returns `nullptr` if the object was statically
-   * allocated.
-   */
-  [[nodiscard]] constexpr std::pmr::memory_resource* get_allocator()
-    const noexcept
+  [[no_unique_address]] Resource m_resource;
+  deferred_destruction_domain* m_domain;
+  deferred_node m_node{};
+};
+
+template<typename Resource>
+constexpr bool is_deferred_resource = false;
+
+template<typename Resource>
+constexpr bool is_deferred_resource<deferred_resource<Resource>> = true;
+
+/**
+ * @brief Link of an object created in a scoped_arena
+ */
+struct scoped_node
+{
+  using flag =
+    std::conditional_t<thread_safe_ref_count, std::atomic<bool>, bool>;
+
+  scoped_node() = default;
+
+  // Resources are passed by value before the object is registered
+  scoped_node(scoped_node const& p_other) noexcept
+    : m_next(p_other.m_next)
+    , m_owner(p_other.m_owner)
+    , m_released(p_other.released())
   {
-    if (m_ctrl == nullptr) {
-      return nullptr;
-    }
-    return m_ctrl->allocator;
   }
 
-private:
-  template<class U>
-  friend class enable_strong_from_this;
+  scoped_node& operator=(scoped_node const&) = delete;
 
-  template<class U, typename... Args>
-  friend constexpr strong_ptr<U> make_strong_ptr(std::pmr::memory_resource*,
-                                                 Args&&...);
+  /// Called once nothing outside of the arena refers to the control block
+  void release() noexcept
+  {
+    release(m_released);
+  }
 
-  template<typename U>
-  friend class strong_ptr;
+  [[nodiscard]] bool released() const noexcept
+  {
+    return released(m_released);
+  }
 
-  template<typename U>
-  friend class weak_ptr;
+  static void release(std::atomic<bool>& p_flag) noexcept
+  {
+    // The last reference may be dropped on another thread than the one
+    // sweeping the arena, pairs with the acquire in released()
+    p_flag.store(true, std::memory_order_release);
+  }
 
-  template<typename U>
-  friend class optional_ptr;
+  static void release(bool& p_flag) noexcept
+  {
+    p_flag = true;
+  }
 
-  constexpr void throw_if_out_of_bounds(std::size_t p_size, std::size_t p_index)
+  static bool released(std::atomic<bool> const& p_flag) noexcept
   {
-    if (p_index >= p_size) {
-      throw mem::out_of_range({ .m_index = p_index, .m_capacity = p_size });
-    }
+    return p_flag.load(std::memory_order_acquire);
   }
 
-  constexpr void add_ref()
+  static bool released(bool const& p_flag) noexcept
   {
-    if (is_dynamic()) {
-      m_ctrl->add_ref();
-    }
+    return p_flag;
   }
 
-  // Internal constructor with control block and pointer - used by make() and
-  // aliasing
-  constexpr strong_ptr(ref_info* p_ctrl, T* p_ptr) noexcept
-    : m_ctrl(p_ctrl)
-    , m_ptr(p_ptr)
+  scoped_node* m_next = nullptr;
+  ref_info* m_owner = nullptr;
+  flag m_released{ false };
+};
+
+/**
+ * @brief The objects created in a scoped_arena, newest first
+ */
+struct scoped_registry
+{
+  void push(scoped_node* p_node, ref_info* p_owner) noexcept
   {
-    add_ref();
+    p_node->m_owner = p_owner;
+    p_node->m_next = m_head;
+    m_head = p_node;
+    m_objects++;
   }
 
-  constexpr void release()
+  void destroy_all() noexcept
   {
-    if (is_dynamic()) {
-      m_ctrl->release();
+    // Newest first, so an object is destroyed before the objects it was
+    // created from. Objects created by a destructor are pushed onto the head
+    // and destroyed by this same sweep.
+    while (m_head != nullptr) {
+      auto* node = m_head;
+      m_head = node->m_next;
+#if not defined(NDEBUG)
+      if (not node->released()) [[unlikely]] {
+        // A strong_ptr or weak_ptr outside of the sweep still refers to this
+        // object, destroying it would leave that reference dangling
+        std::terminate();
+      }
+#endif
+      node->m_owner->manager(node->m_owner, ref_info::operation::finalize);
+      m_objects--;
     }
+    // Nothing was deallocated individually, reclaim the entire block at once
+    m_allocator->release_all();
   }
 
-  ref_info* m_ctrl = nullptr;
-  T* m_ptr = nullptr;
+  monotonic_allocator_base* m_allocator;
+  scoped_node* m_head = nullptr;
+  std::size_t m_objects = 0;
 };
 
 /**
- * @brief CRTP mixin to enable objects to create strong_ptr instances to
- * themselves
+ * @brief Memory resource of an object created in a scoped_arena
  *
- * Similar to `std::enable_shared_from_this`, this class allows an object to
- * safely obtain a strong_ptr to itself. The object must inherit from this class
- * and be managed by a strong_ptr created via make_strong_ptr.
+ * Stored at the end of the rc allocation in place of the plain resource, so
+ * each object carries its own link in the arena's registry.
+ */
+struct scoped_resource
+{
+  [[nodiscard]] constexpr std::pmr::memory_resource* get() const noexcept
+  {
+    return m_registry->m_allocator;
+  }
+
+  scoped_registry* m_registry;
+  scoped_node m_node{};
+};
+
+template<typename Resource>
+constexpr bool is_scoped_resource = std::is_same_v<Resource, scoped_resource>;
+
+/**
+ * @brief Arena whose objects are all destroyed together when it goes out of
+ * scope
  *
- * Example usage:
- * ```cpp
- * class my_driver : public enable_strong_from_this<my_driver> {
- * public:
- *   void register_callback() {
- *     // Get a strong_ptr to ourselves
- *     auto self = strong_from_this();
- *     some_async_system.register_callback([self](){
- *       self->handle_callback();
- *     });
- *   }
- * };
+ * Objects created with `make_scoped_strong_ptr` are recorded in the arena as
+ * they are created. Releasing the last reference to one of them costs only a
+ * reference count decrement: the object becomes unreachable, so
+ * `weak_ptr::lock()` fails, but its destructor does not run and its memory is
+ * not deallocated. When the arena is destroyed, or `clear()` is called, every
+ * object is destroyed in one sweep, newest first, and the whole block is
+ * reclaimed in O(1). This suits request scoped work, where many objects are
+ * created and then discarded together.
  *
- * auto obj = make_strong_ptr<my_driver>(allocator);
- * obj->register_callback(); // Safe to get strong_ptr to self
+ * Every strong_ptr and weak_ptr to an object of the arena must be released
+ * before the sweep reaches that object. As objects are destroyed newest first,
+ * an object may hold strong_ptrs to objects created before it in the same
+ * arena. Builds without NDEBUG call std::terminate if a reference is still
+ * held when the sweep reaches the object.
+ *
+ * The arena is not thread safe. Objects of the arena may still be shared with
+ * other threads when thread safe reference counts are enabled, as long as
+ * those threads are done with them before the sweep.
+ *
+ * Example usage:
+ * ```
+ * void handle(request const& p_request) {
+ *   mem::scoped_arena<4096> arena;
+ *   auto parser = mem::make_scoped_strong_ptr<json_parser>(arena);
+ *   auto reply = mem::make_scoped_strong_ptr<response>(arena, parser);
+ *   send(reply);
+ * }  // reply, then parser, are destroyed by the arena
  * ```
  *
- * @tparam T The derived class type
+ * @tparam StorageSizeBytes - Number of bytes for arena memory
  */
-export template<class T>
-class enable_strong_from_this
+export template<std::size_t StorageSizeBytes>
+class scoped_arena
 {
 public:
-  /**
-   * @brief Get a strong_ptr to this object
-   *
-   * @return strong_ptr<T> pointing to this object
-   */
-  [[nodiscard]] constexpr strong_ptr<T> strong_from_this()
-  {
-    return strong_ptr<T>(&m_ref_counted_self->m_info,
-                         &m_ref_counted_self->m_object);
-  }
+  scoped_arena() = default;
 
-  /**
-   * @brief Get a strong_ptr to this object (const version)
-   *
-   * @return strong_ptr<T const> pointing to this object
-   */
-  [[nodiscard]] constexpr strong_ptr<T const> strong_from_this() const
-  {
-    return strong_ptr<T>(&m_ref_counted_self->m_info,
-                         &m_ref_counted_self->m_object);
-  }
+  scoped_arena(scoped_arena const&) = delete;
+  scoped_arena& operator=(scoped_arena const&) = delete;
+  scoped_arena(scoped_arena&&) = delete;
+  scoped_arena& operator=(scoped_arena&&) = delete;
 
-  /**
-   * @brief Get a weak_ptr to this object
-   *
-   * @return weak_ptr<T> pointing to this object
-   */
-  [[nodiscard]] constexpr weak_ptr<T> weak_from_this() noexcept
+  ~scoped_arena()
   {
-    return strong_from_this();
+    m_registry.destroy_all();
   }
 
   /**
-   * @brief Get a weak_ptr to this object (const version)
+   * @brief Destroy every object of the arena and reclaim its memory
    *
-   * @return weak_ptr<T const> pointing to this object
+   * The arena can be reused afterwards.
    */
-  [[nodiscard]] constexpr weak_ptr<T const> weak_from_this() const noexcept
+  void clear() noexcept
   {
-    return strong_from_this();
+    m_registry.destroy_all();
   }
 
-private:
-  friend T;
-
-  /**
-   * @brief Protected constructor to prevent direct instantiation
-   */
-  enable_strong_from_this() = default;
-
-  // NOLINTBEGIN(bugprone-unhandled-self-assignment)
   /**
-   * @brief Protected assignment operator
+   * @brief Get the number of objects waiting to be destroyed by the arena
    *
-   * Note: The weak_ptr is not assigned - each object keeps its own weak
-   * reference
+   * @return std::size_t - number of objects created since the last sweep
    */
-  constexpr enable_strong_from_this& operator=(
-    enable_strong_from_this const&) noexcept
+  [[nodiscard]] std::size_t size() const noexcept
   {
-    // Intentionally don't assign m_weak_this
-    return *this;
+    return m_registry.m_objects;
   }
-  // NOLINTEND(bugprone-unhandled-self-assignment)
-
-  /**
-   * @brief Protected destructor
-   */
-  ~enable_strong_from_this() = default;
 
   /**
-   * @brief Protected copy constructor
+   * @brief Get the usage statistics of the arena's memory
    *
-   * Note: The weak_ptr is not copied - each object gets its own weak reference
+   * @return monotonic_allocator_stats - current usage statistics
    */
-  enable_strong_from_this(enable_strong_from_this const&) noexcept
+  [[nodiscard]] monotonic_allocator_stats stats() const noexcept
   {
-    // Intentionally don't copy m_weak_this
+    return m_allocator.stats();
   }
 
-  template<class U, typename... Args>
-  friend constexpr strong_ptr<U> make_strong_ptr(std::pmr::memory_resource*,
-                                                 Args&&...);
-
-  /**
-   * @brief Initialize the weak reference (called by make_strong_ptr)
-   *
-   * @param p_self The strong_ptr that manages this object
-   */
-  constexpr void init_weak_this(rc<T>* p_self) noexcept
-  {
-    m_ref_counted_self = p_self;
-  }
+private:
+  friend struct strong_ptr_factory;
 
-  mutable rc<T>* m_ref_counted_self;
+  monotonic_allocator<StorageSizeBytes> m_allocator;
+  scoped_registry m_registry{ .m_allocator = &m_allocator.m_base };
 };
 
-template<typename T>
-class optional_ptr;
+/**
+ * @brief Size in bytes of the cache line used to separate control blocks
+ *
+ * Set with the `LIBHAL_STRONG_PTR_CACHE_LINE_SIZE` macro, defaults to 64.
+ */
+export inline constexpr std::size_t cache_line_size =
+  LIBHAL_STRONG_PTR_CACHE_LINE_SIZE;
+
+static_assert(cache_line_size != 0 &&
+                (cache_line_size & (cache_line_size - 1)) == 0,
+              "LIBHAL_STRONG_PTR_CACHE_LINE_SIZE must be a power of two");
 
 /**
- * @brief A weak reference to a strong_ptr
+ * @brief Opt-in to place the control block on its own cache line
  *
- * weak_ptr provides a non-owning reference to an object managed by strong_ptr.
- * It can be used to break reference cycles or to create an optional_ptr.
+ * With thread safe reference counts, every copy or release of a strong_ptr
+ * writes to the control block. When the control block shares a cache line with
+ * the object, that write evicts the line from every other core reading the
+ * object. Specializing this variable to true aligns the object to
+ * `cache_line_size`, so the counts and the object never share a line. This
+ * costs up to `cache_line_size` bytes of padding per allocation and requires
+ * the memory resource to support over-aligned allocations.
  *
- * A weak_ptr doesn't increase the strong reference count, so it doesn't
- * prevent the object from being destroyed when the last strong_ptr goes away.
+ * Applies to objects created by make_strong_ptr and to the elements of
+ * make_strong_array and make_strong_group.
  *
  * Example usage:
  * ```
- * // Create a strong_ptr to an object
- * auto ptr = mem::make_strong_ptr<my_driver>(allocator, args...);
- *
- * // Create a weak reference
- * weak_ptr<my_driver> weak = ptr;
- *
- * // Later, try to get a strong reference
- * if (auto locked = weak.lock()) {
- *   // Use the object via locked
- *   locked->do_something();
- * } else {
- *   // Object has been destroyed
- * }
+ * template<>
+ * constexpr bool mem::isolate_control_block<sensor_state> = true;
  * ```
  *
- * @tparam T The type of the referenced object
+ * @tparam T - the type of the managed object
  */
-template<typename T>
-class weak_ptr
-{
-public:
-  template<typename U>
-  friend class strong_ptr;
+export template<typename T>
+constexpr bool isolate_control_block = false;
 
-  template<typename U>
-  friend class weak_ptr;
+// Alignment of a managed object within its rc allocation
+template<typename T>
+constexpr std::size_t rc_object_alignment =
+  isolate_control_block<std::remove_cv_t<T>>
+    ? std::max(alignof(T), cache_line_size)
+    : alignof(T);
 
-  using element_type = std::remove_extent_t<T>;
+/**
+ * @brief A wrapper that contains both the ref_info and the actual object
+ *
+ * This structure keeps the control block and managed object together in memory.
+ * The control block is always the first member and is placed directly in front
+ * of the object, unless isolate_control_block moves the object to the next
+ * cache line. The memory resource is stored after the object and occupies
+ * no space when it is known at compile time.
+ *
+ * @tparam T The type of the managed object
+ * @tparam Resource runtime_resource, static_resource_t or deferred_resource
+ */
+template<typename T, typename Resource = runtime_resource>
+struct rc
+{
+  ref_info m_info;
+  alignas(rc_object_alignment<T>) T m_object;
+  [[no_unique_address]] Resource m_resource;
 
-  /**
-   * @brief Default constructor creates empty weak_ptr
-   */
-  weak_ptr() noexcept = default;
+  // Constructor that forwards arguments to the object
+  template<typename... Args>
+  constexpr rc(Resource p_resource, Args&&... args)
+    : m_info(&manage)
+    , m_object(std::forward<Args>(args)...)
+    , m_resource(p_resource)
+  {
+  }
 
-  /**
-   * @brief Create weak_ptr from strong_ptr
-   *
-   * @param p_strong The strong_ptr to create a weak reference to
-   */
-  constexpr weak_ptr(strong_ptr<T> const& p_strong) noexcept
-    : m_ctrl(p_strong.m_ctrl)
-    , m_ptr(p_strong.m_ptr)
+  static std::pmr::memory_resource* manage(ref_info* p_info,
+                                           ref_info::operation p_operation)
   {
-    if (m_ctrl) {
-      m_ctrl->add_weak();
+    // Cast back into the original rc type as m_info is the first member
+    auto* self = reinterpret_cast<rc*>(p_info);
+
+    switch (p_operation) {
+      case ref_info::operation::destroy:
+        if constexpr (is_deferred_resource<Resource>) {
+          // Keep the memory alive until the domain destroys the object
+          self->m_info.add_weak();
+          self->m_resource.defer(&self->m_info);
+        } else if constexpr (not is_scoped_resource<Resource>) {
+          // Scoped objects are destroyed by the arena's sweep
+          std::destroy_at(&self->m_object);
+        }
+        break;
+      case ref_info::operation::finalize:
+        std::destroy_at(&self->m_object);
+        break;
+      case ref_info::operation::deallocate:
+        if constexpr (is_scoped_resource<Resource>) {
+          // The arena reclaims the memory of every object at once
+          self->m_resource.m_node.release();
+        } else {
+          self->m_resource.get()->deallocate(self, sizeof(rc), alignof(rc));
+        }
+        break;
+      case ref_info::operation::destroy_and_deallocate:
+        if constexpr (is_deferred_resource<Resource>) {
+          self->m_resource.defer(&self->m_info);
+        } else if constexpr (is_scoped_resource<Resource>) {
+          self->m_resource.m_node.release();
+        } else {
+          std::destroy_at(&self->m_object);
+          self->m_resource.get()->deallocate(self, sizeof(rc), alignof(rc));
+        }
+        break;
+      case ref_info::operation::get_allocator:
+        return self->m_resource.get();
     }
+    return nullptr;
   }
+};
 
-  /**
-   * @brief Copy constructor
-   *
-   * @param p_other The weak_ptr to copy from
-   */
-  constexpr weak_ptr(weak_ptr const& p_other) noexcept
-    : m_ctrl(p_other.m_ctrl)
-    , m_ptr(p_other.m_ptr)
+/**
+ * @brief Size of the single allocation made by make_strong_ptr
+ *
+ * This is the size of the control block and the object together. Useful for
+ * sizing memory resources and for tracking control block overhead.
+ *
+ * @tparam T - the type of the managed object
+ * @tparam Resource - `static_resource_t<...>` if the memory resource is known at
+ * compile time
+ */
+export template<typename T, typename Resource = runtime_resource>
+constexpr std::size_t rc_size_v = sizeof(rc<T, Resource>);
+
+/**
+ * @brief Offset of the object from the start of its rc allocation
+ *
+ * `m_info` is the first member of rc and the object immediately follows it, so
+ * the offset does not depend on the memory resource stored at the end.
+ */
+template<typename T>
+constexpr std::size_t rc_object_offset =
+  (sizeof(ref_info) + rc_object_alignment<T> - 1) / rc_object_alignment<T> *
+  rc_object_alignment<T>;
+
+struct pool_allocator_base : public std::pmr::memory_resource
+{
+  struct free_slot
   {
-    if (m_ctrl) {
-      m_ctrl->add_weak();
+    free_slot* m_next;
+  };
+
+  pool_allocator_base() = default;
+  pool_allocator_base(pool_allocator_base const&) = delete;
+  pool_allocator_base& operator=(pool_allocator_base const&) = delete;
+  pool_allocator_base(pool_allocator_base&&) = delete;
+  pool_allocator_base& operator=(pool_allocator_base&&) = delete;
+
+  ~pool_allocator_base() override
+  {
+    if (m_allocated_slots != 0) {
+      std::terminate();
     }
   }
 
   /**
-   * @brief Move constructor
+   * @brief Allocate without reporting failure through the error policy
    *
-   * @param p_other The weak_ptr to move from
+   * @return void* - a free slot or nullptr if the request does not fit a slot
+   * or every slot is in use
    */
-  constexpr weak_ptr(weak_ptr&& p_other) noexcept
-    : m_ctrl(p_other.m_ctrl)
-    , m_ptr(p_other.m_ptr)
+  [[nodiscard]] void* try_allocate(std::size_t p_bytes,
+                                   std::size_t p_alignment) noexcept
   {
-    p_other.m_ctrl = nullptr;
-    p_other.m_ptr = nullptr;
+    if (p_bytes > m_slot_size || p_alignment > m_slot_alignment ||
+        m_free_list == nullptr) [[unlikely]] {
+      return nullptr;
+    }
+
+    free_slot* result = m_free_list;
+    m_free_list = result->m_next;
+    m_allocated_slots++;
+    return result;
   }
 
-  /**
-   * @brief Converting copy constructor
-   *
-   * Creates a weak_ptr of T from a weak_ptr of U where U is convertible to T.
-   *
-   * @tparam U A type convertible to T
-   * @param p_other The weak_ptr to copy from
-   */
-  template<typename U>
-  constexpr weak_ptr(weak_ptr<U> const& p_other) noexcept
-    requires(std::is_convertible_v<U*, T*>)
-    : m_ctrl(p_other.m_ctrl)
-    , m_ptr(static_cast<T*>(p_other.m_ptr))
+  void* do_allocate(std::size_t p_bytes, std::size_t p_alignment) override
   {
-    if (m_ctrl) {
-      m_ctrl->add_weak();
+    void* result = try_allocate(p_bytes, p_alignment);
+    if (result == nullptr) [[unlikely]] {
+      throw_bad_alloc();
     }
+    return result;
   }
 
-  /**
-   * @brief Converting move constructor
-   *
-   * Moves a weak_ptr of U to a weak_ptr T where U is convertible to T.
-   *
-   * @tparam U A type convertible to T
-   * @param p_other The weak_ptr to move from. Moved from weak_ptr's are
-   * considered expired.
-   */
-  template<typename U>
-  constexpr weak_ptr(weak_ptr<U>&& p_other) noexcept
-    requires(std::is_convertible_v<U*, T*>)
-    : m_ctrl(p_other.m_ctrl)
-    , m_ptr(static_cast<T*>(p_other.m_ptr))
+  void do_deallocate(void* p_address, std::size_t, std::size_t) override
   {
-    p_other.m_ctrl = nullptr;
-    p_other.m_ptr = nullptr;
+    // Slots are reused in LIFO order which keeps recently used memory hot
+    m_free_list = std::construct_at(static_cast<free_slot*>(p_address),
+                                    free_slot{ m_free_list });
+    m_allocated_slots--;
   }
 
-  /**
-   * @brief Converting constructor from strong_ptr
-   *
-   * Creates a weak_ptr<T> from a strong_ptr where U is convertible to T.
-   *
-   * @tparam U A type convertible to T
-   * @param p_other The strong_ptr to create a weak reference to
-   */
-  template<typename U>
-  constexpr weak_ptr(strong_ptr<U> const& p_other) noexcept
-    requires(std::is_convertible_v<U*, T*>)
-    : m_ctrl(p_other.m_ctrl)
-    , m_ptr(static_cast<T*>(p_other.m_ptr))
+  [[nodiscard]] bool do_is_equal(
+    std::pmr::memory_resource const& p_other) const noexcept override
   {
-    if (m_ctrl) {
-      m_ctrl->add_weak();
-    }
+    return this == &p_other;
   }
 
-  /**
-   * @brief Destructor
-   *
-   * Decrements the weak reference count and potentially deallocates
-   * memory if this was the last reference.
-   */
-  ~weak_ptr()
+  free_slot* m_free_list = nullptr;
+  std::size_t m_slot_size = 0;
+  std::size_t m_slot_alignment = 0;
+  std::size_t m_allocated_slots = 0;
+};
+
+template<std::size_t SlotSize, std::size_t SlotAlignment, std::size_t Count>
+struct pool_allocator
+{
+  pool_allocator()
   {
-    if (m_ctrl) {
-      m_ctrl->release_weak();
+    m_base.m_slot_size = SlotSize;
+    m_base.m_slot_alignment = SlotAlignment;
+    using free_slot = pool_allocator_base::free_slot;
+    // Thread the free list through the storage, first slot at the head
+    for (auto i = Count; i > 0; i--) {
+      auto* slot = m_storage.data() + ((i - 1) * SlotSize);
+      m_base.m_free_list = std::construct_at(
+        reinterpret_cast<free_slot*>(slot), free_slot{ m_base.m_free_list });
     }
   }
 
-  /**
-   * @brief Copy assignment operator
-   *
-   * @param p_other The weak_ptr to copy from
-   * @return Reference to *this
-   */
-  constexpr weak_ptr& operator=(weak_ptr const& p_other) noexcept
+  std::pmr::memory_resource* resource()
   {
-    weak_ptr(p_other).swap(*this);
-    return *this;
+    return &m_base;
   }
 
   /**
-   * @brief Move assignment operator
+   * @brief Allocate memory without going through the virtual interface of
+   * std::pmr::memory_resource
    *
-   * @param p_other The weak_ptr to move from
-   * @return Reference to *this
+   * Memory must be deallocated through `resource()`.
+   *
+   * @param p_bytes - number of bytes to allocate
+   * @param p_alignment - alignment of the allocation
+   * @return void* - the allocated memory
+   * @throws std::bad_alloc if the request cannot be satisfied
    */
-  constexpr weak_ptr& operator=(weak_ptr&& p_other) noexcept
+  [[nodiscard]] void* allocate(std::size_t p_bytes, std::size_t p_alignment)
   {
-    weak_ptr(std::move(p_other)).swap(*this);
-    return *this;
+    // Qualified call to guarantee static dispatch
+    return m_base.pool_allocator_base::do_allocate(p_bytes, p_alignment);
   }
 
   /**
-   * @brief Assignment from strong_ptr
+   * @brief Allocate memory, returning nullptr rather than reporting failure
+   * through the error policy
    *
-   * @param p_strong The strong_ptr to create a weak reference to
-   * @return Reference to *this
+   * Memory must be deallocated through `resource()`.
+   *
+   * @param p_bytes - number of bytes to allocate
+   * @param p_alignment - alignment of the allocation
+   * @return void* - the allocated memory or nullptr if the request cannot be
+   * satisfied
    */
-  constexpr weak_ptr& operator=(strong_ptr<T> const& p_strong) noexcept
+  [[nodiscard]] void* try_allocate(std::size_t p_bytes,
+                                   std::size_t p_alignment) noexcept
   {
-    weak_ptr(p_strong).swap(*this);
-    return *this;
+    return m_base.try_allocate(p_bytes, p_alignment);
   }
 
-  /**
-   * @brief Swap the contents of this weak_ptr with another
-   *
-   * @param p_other The weak_ptr to swap with
-   */
-  constexpr void swap(weak_ptr& p_other) noexcept
+  operator std::pmr::memory_resource*()
   {
-    std::swap(m_ctrl, p_other.m_ctrl);
-    std::swap(m_ptr, p_other.m_ptr);
+    return &m_base;
   }
 
-  /**
-   * @brief Check if the referenced object has been destroyed
-   *
-   * @return true if the object has been destroyed, false otherwise
-   */
-  [[nodiscard]] constexpr bool expired() const noexcept
+  std::pmr::memory_resource* operator->()
   {
-    if (m_ptr == nullptr) {
-      return true;
-    }
+    return &m_base;
+  }
 
-    if (m_ctrl != nullptr) {
-      return m_ctrl->strong_count == 0;
-    }
+  std::pmr::memory_resource& operator*()
+  {
+    return m_base;
+  }
 
-    // If m_ptr != nullptr && m_ctrl == nullptr (static object), return false,
-    // because that object will always exist.
-    return false;
+  template<typename T>
+  operator std::pmr::polymorphic_allocator<T>()
+  {
+    return &m_base;
   }
 
-  /**
-   * @brief Attempt to obtain a strong_ptr to the referenced object
-   *
-   * If the object still exists, returns an optional_ptr containing
-   * a strong_ptr to it. Otherwise, returns an empty optional_ptr.
-   *
-   * @return An optional_ptr that is either empty or contains a strong_ptr
-   */
-  [[nodiscard]] constexpr optional_ptr<T> lock() const noexcept;
+  pool_allocator_base m_base{};
+  alignas(SlotAlignment) std::array<std::byte, SlotSize * Count> m_storage = {};
+};
 
-  /**
-   * @brief Get the current strong reference count
-   *
-   * This is primarily for testing purposes.
-   *
-   * @return The number of strong references to the managed object
-   */
-  [[nodiscard]] constexpr auto use_count() const noexcept
-  {
-    return m_ctrl ? m_ctrl->strong_count : 0;
+/**
+ * @brief Creates a fixed size pool allocator for `strong_ptr<T>` objects with
+ * embedded memory & memory safety checks
+ *
+ * The internal storage is divided into `Count` slots, each large enough and
+ * aligned for the single allocation made by `make_strong_ptr<T>`, meaning the
+ * control block and the object together. Free slots are kept in an intrusive
+ * free list stored inside the slots themselves, so allocation and
+ * deallocation are both constant time and the pool never fragments. Memory
+ * returned to the pool is reused by the next allocation, making this allocator
+ * suitable for long running code that repeatedly creates and drops objects.
+ *
+ * Allocations larger than a slot, with stricter alignment than a slot, or made
+ * when every slot is in use throw `std::bad_alloc`. Smaller allocations, such
+ * as `make_strong_ptr` with a `static_resource` or of a smaller type, are
+ * accepted but still use an entire slot.
+ *
+ * The number of slots in use is recorded. When this allocator is destroyed, if
+ * any slot is still in use, std::terminate is called. This is to ensure that
+ * references to memory within this pool cannot become invalid.
+ *
+ * Example usage:
+ *
+ * ```cpp
+ * auto pool = mem::make_pool_allocator<message, 8>();
+ * for (auto i = 0; i < 1000; i++) {
+ *   // Never runs out of memory as each message is released before the next
+ *   auto msg = mem::make_strong_ptr<message>(pool, i);
+ * }
+ * ```
+ *
+ * @tparam T - type of object that will be created using this pool
+ * @tparam Count - Number of slots in the pool
+ * @return pool_allocator - the pool allocator
+ */
+export template<typename T, std::size_t Count>
+auto make_pool_allocator()
+{
+  constexpr auto slot_alignment =
+    std::max(alignof(rc<T>), alignof(pool_allocator_base::free_slot));
+  constexpr auto slot_size =
+    (std::max(rc_size_v<T>, sizeof(pool_allocator_base::free_slot)) +
+     slot_alignment - 1) /
+    slot_alignment * slot_alignment;
+  return pool_allocator<slot_size, slot_alignment, Count>();
+}
+
+/**
+ * @brief Name of a type, obtained without RTTI
+ *
+ * Extracted from the signature of this function as reported by
+ * std::source_location, so the exact spelling depends on the compiler. Only
+ * intended for reports such as those of `profiling_resource`.
+ *
+ * @tparam T - type to name
+ * @return std::string_view - name of T, or the whole signature if it could not
+ * be located
+ */
+export template<typename T>
+[[nodiscard]] consteval std::string_view type_name() noexcept
+{
+  std::string_view const signature =
+    std::source_location::current().function_name();
+  // GCC and Clang spell the argument as "T = name" followed by ';' or ']'
+  if (auto const start = signature.find("T = ");
+      start != std::string_view::npos) {
+    auto const name = signature.substr(start + 4);
+    return name.substr(0, name.find_first_of(";]"));
   }
+  // MSVC spells the argument as "type_name<name>(void)"
+  if (auto const start = signature.find("type_name<");
+      start != std::string_view::npos) {
+    auto const name = signature.substr(start + 10);
+    return name.substr(0, name.rfind(">("));
+  }
+  return signature;
+}
 
-private:
-  ref_info* m_ctrl = nullptr;
-  T* m_ptr = nullptr;
+// Unique address per type, identifies the type of an allocation without RTTI
+template<typename T>
+inline constexpr char type_tag = 0;
+
+/**
+ * @brief Allocation statistics recorded by a profiling_resource
+ */
+export struct allocation_profile
+{
+  /// Number of buckets of `size_histogram`
+  static constexpr std::size_t size_buckets = 16;
+  /// Number of buckets of `alignment_histogram`
+  static constexpr std::size_t alignment_buckets = 8;
+
+  /// Successful allocations
+  std::uint64_t allocations = 0;
+  /// Deallocations
+  std::uint64_t deallocations = 0;
+  /// Allocations the upstream resource failed to satisfy
+  std::uint64_t failed_allocations = 0;
+  /// Sum of the sizes of every successful allocation
+  std::uint64_t total_bytes = 0;
+  /// Bytes allocated and not yet deallocated
+  std::uint64_t live_bytes = 0;
+  /// Largest value `live_bytes` has reached
+  std::uint64_t peak_live_bytes = 0;
+  /// Bytes skipped by the upstream arena to align allocations, only recorded
+  /// when the upstream resource is a monotonic allocator
+  std::uint64_t padding_bytes = 0;
+  /// Bucket `i` counts the allocations of size in (2^(i-1), 2^i], the last
+  /// bucket also counts every larger allocation
+  std::array<std::uint64_t, size_buckets> size_histogram{};
+  /// Bucket `i` counts the allocations aligned to 2^i, the last bucket also
+  /// counts every larger alignment
+  std::array<std::uint64_t, alignment_buckets> alignment_histogram{};
+  /// Sum of the clock ticks spent in the upstream allocate, needs a clock
+  std::uint64_t allocate_ticks = 0;
+  /// Longest upstream allocate in clock ticks, needs a clock
+  std::uint64_t max_allocate_ticks = 0;
+  /// Sum of the clock ticks spent in the upstream deallocate, needs a clock
+  std::uint64_t deallocate_ticks = 0;
+  /// Longest upstream deallocate in clock ticks, needs a clock
+  std::uint64_t max_deallocate_ticks = 0;
 };
 
 /**
- * @brief Optional, nullable, smart pointer that works with `mem::strong_ptr`.
+ * @brief Allocations made by make_strong_ptr for a single type
+ */
+export struct type_allocation_profile
+{
+  /// Name of the type, see `type_name()`
+  std::string_view name;
+  /// Successful allocations
+  std::uint64_t allocations = 0;
+  /// Sum of the sizes of the allocations, including the control block
+  std::uint64_t bytes = 0;
+  /// Bytes skipped by the upstream arena to align the allocations
+  std::uint64_t padding_bytes = 0;
+};
+
+/**
+ * @brief Memory resource that records statistics about the allocations passed
+ * through it to an upstream resource
  *
- * optional_ptr provides a way to represent a strong_ptr that may or may not
- * be present. Unlike strong_ptr, which is always valid, optional_ptr can be
- * in a "disengaged" state where it doesn't reference any object.
+ * Use it to find out which types drive the exhaustion of an arena or pool, and
+ * to size them from representative runs. Every allocation is recorded in
+ * `profile()`. Passing the profiling_resource itself, rather than a
+ * `std::pmr::memory_resource*` to it, to `make_strong_ptr` also attributes the
+ * allocation to the type created, which is reported by `types()`. Types are
+ * identified without RTTI, so this works with `-fno-rtti`.
  *
- * Use optional_ptr when you need a nullable reference to a reference-counted
- * object, such as:
- * - Representing the absence of a value
- * - Return values from functions that may fail
- * - Results of locking a weak_ptr
+ * When constructed from a monotonic allocator, the bytes the arena skipped to
+ * align each allocation are recorded as well. Latency is recorded once a clock
+ * is provided with `set_clock()`, for example a function returning a cycle
+ * counter.
+ *
+ * The profiling_resource is not thread safe. It must outlive everything
+ * allocated through it, and, like its upstream resource, it calls
+ * std::terminate if it is destroyed while any allocation is live.
  *
  * Example usage:
  * ```
- * // Create an empty optional_ptr
- * optional_ptr<my_driver> opt1;
+ * auto arena = mem::make_monotonic_allocator<4096>();
+ * mem::profiling_resource profiler(arena);
  *
- * // Create an optional_ptr from a strong_ptr
- * auto ptr = make_strong_ptr<my_driver>(allocator, args...);
- * optional_ptr<my_driver> opt2 = ptr;
+ * auto a = mem::make_strong_ptr<sensor>(profiler, bus);
+ * auto b = mem::make_strong_ptr<filter>(profiler);
  *
- * // Check if the optional_ptr is engaged
- * if (opt2) {
- *   // Use the contained object
- *   opt2->do_something();
+ * for (auto const& type : profiler.types()) {
+ *   std::println("{}: {} bytes", type.name, type.bytes);
  * }
- *
- * // Reset to disengage
- * opt2.reset();
  * ```
  *
- * @tparam T - The type pointed to by strong_ptr
+ * @tparam MaxTypes - number of distinct types that can be attributed, further
+ * types are only recorded in `profile()`
  */
-template<typename T>
-class optional_ptr
+export template<std::size_t MaxTypes = 16>
+class profiling_resource : public std::pmr::memory_resource
 {
 public:
-  using element_type = std::remove_extent_t<T>;
-  using weak_type = weak_ptr<T>;
+  /// Function returning a monotonically increasing tick count
+  using clock_function = std::uint64_t() noexcept;
 
   /**
-   * @brief Default constructor creates a disengaged optional
+   * @brief Profile the allocations made from any memory resource
+   *
+   * @param p_upstream - resource that performs the allocations
    */
-  constexpr optional_ptr() noexcept
+  explicit profiling_resource(std::pmr::memory_resource* p_upstream) noexcept
+    : m_upstream(p_upstream)
   {
   }
 
   /**
-   * @brief Constructor for nullptr (creates a disengaged optional)
+   * @brief Profile the allocations made from a monotonic allocator, including
+   * the padding inserted to align them
+   *
+   * @param p_upstream - allocator that performs the allocations
    */
-  constexpr optional_ptr(std::nullptr_t) noexcept
+  template<std::size_t MemorySize, typename Base>
+  explicit profiling_resource(
+    monotonic_allocator<MemorySize, Base>& p_upstream) noexcept
+    : m_upstream(p_upstream.resource())
+    , m_arena(&p_upstream)
+    , m_consumed_bytes([](void const* p_arena) noexcept {
+      return static_cast<monotonic_allocator<MemorySize, Base> const*>(p_arena)
+        ->stats()
+        .consumed_bytes;
+    })
   {
   }
 
-  /**
-   * @brief Move constructor is deleted
-   */
-  constexpr optional_ptr(optional_ptr&& p_other) noexcept = delete;
+  profiling_resource(profiling_resource const&) = delete;
+  profiling_resource& operator=(profiling_resource const&) = delete;
+  profiling_resource(profiling_resource&&) = delete;
+  profiling_resource& operator=(profiling_resource&&) = delete;
 
-  /**
-   * @brief Construct from a strong_ptr lvalue
-   *
-   * @param value The strong_ptr to wrap
-   */
-  constexpr optional_ptr(strong_ptr<T> const& value) noexcept
-    : m_value(value)
+  ~profiling_resource() override
   {
+    if (m_profile.live_bytes != 0) {
+      std::terminate();
+    }
   }
 
   /**
-   * @brief Copy constructor
+   * @brief Record the latency of each upstream call
    *
-   * @param p_other The optional_ptr to copy from
+   * @param p_clock - tick source, or nullptr to stop recording latency
    */
-  constexpr optional_ptr(optional_ptr const& p_other)
+  void set_clock(clock_function* p_clock) noexcept
   {
-    *this = p_other;
+    m_clock = p_clock;
   }
 
   /**
-   * @brief Converting constructor from a strong_ptr
+   * @brief Allocate memory for an object of type T
    *
-   * @tparam U A type convertible to T
-   * @param p_value The strong_ptr to wrap
-   */
-  template<typename U>
-  constexpr optional_ptr(strong_ptr<U> const& p_value)
-    requires(std::is_convertible_v<U*, T*>)
-  {
-    *this = p_value;
-  }
-
-  /**
-   * @brief Move assignment operator is deleted
-   */
-  constexpr optional_ptr& operator=(optional_ptr&& other) noexcept = delete;
-
-  /**
-   * @brief Copy assignment operator
+   * Called by `make_strong_ptr` when given this resource directly. Behaves
+   * like `allocate()` but also attributes the allocation to T.
    *
-   * @param other The optional_ptr to copy from
-   * @return Reference to *this
+   * @tparam T - type of the object the memory is for
+   * @param p_bytes - number of bytes to allocate
+   * @param p_alignment - alignment of the allocation
+   * @return void* - the allocated memory
+   * @throws std::bad_alloc if the upstream resource fails
    */
-  constexpr optional_ptr& operator=(optional_ptr const& other)
+  template<typename T>
+  [[nodiscard]] void* allocate_for(std::size_t p_bytes,
+                                   std::size_t p_alignment)
   {
-    if (this != &other) {
-      if (is_engaged() && other.is_engaged()) {
-        m_value = other.m_value;
-      } else if (is_engaged() && not other.is_engaged()) {
-        reset();
-      } else if (not is_engaged() && other.is_engaged()) {
-        new (&m_value) strong_ptr<T>(other.m_value);
-      }
+    auto const padding_before = m_profile.padding_bytes;
+    void* result = allocate(p_bytes, p_alignment);
+    if (auto* entry = find_or_add(&type_tag<T>, type_name<T>())) {
+      entry->allocations++;
+      entry->bytes += p_bytes;
+      entry->padding_bytes += m_profile.padding_bytes - padding_before;
     }
-    return *this;
+    return result;
   }
 
   /**
-   * @brief Assignment from a strong_ptr
+   * @brief Get the memory resource to store in control blocks
    *
-   * @param value The strong_ptr to wrap
-   * @return Reference to *this
+   * @return std::pmr::memory_resource* - this resource
    */
-  constexpr optional_ptr& operator=(strong_ptr<T> const& value) noexcept
+  [[nodiscard]] std::pmr::memory_resource* resource() noexcept
   {
-    if (is_engaged()) {
-      m_value = value;
-    } else {
-      new (&m_value) strong_ptr<T>(value);
-    }
-    return *this;
+    return this;
   }
 
   /**
-   * @brief Converting assignment from a strong_ptr
+   * @brief Get the statistics of every allocation made so far
    *
-   * @tparam U A type convertible to T
-   * @param p_value The strong_ptr to wrap
-   * @return Reference to *this
+   * @return allocation_profile const& - the statistics
    */
-  template<typename U>
-  constexpr optional_ptr& operator=(strong_ptr<U> const& p_value) noexcept
-    requires(std::is_convertible_v<U*, T*>)
+  [[nodiscard]] allocation_profile const& profile() const noexcept
   {
-    if (is_engaged()) {
-      m_value = p_value;
-    } else {
-      new (&m_value) strong_ptr<U>(p_value);
-    }
-    return *this;
+    return m_profile;
   }
 
   /**
-   * @brief Assignment from nullptr (resets to disengaged state)
+   * @brief Get the allocations attributed to each type, in the order the
+   * types were first allocated
    *
-   * @return Reference to *this
+   * @return std::span<type_allocation_profile const> - one entry per type
    */
-  constexpr optional_ptr& operator=(std::nullptr_t) noexcept
+  [[nodiscard]] std::span<type_allocation_profile const> types()
+    const noexcept
   {
-    reset();
-    return *this;
+    return { m_types.data(), m_type_count };
   }
 
   /**
-   * @brief Destructor
-   *
-   * Properly destroys the contained strong_ptr if engaged.
+   * @brief Clear every statistic, except the bytes that are still live
    */
-  ~optional_ptr()
+  void reset() noexcept
   {
-    if (is_engaged()) {
-      m_value.~strong_ptr<T>();
-    }
+    m_profile = { .live_bytes = m_profile.live_bytes,
+                  .peak_live_bytes = m_profile.live_bytes };
+    m_types = {};
+    m_type_count = 0;
   }
 
-  /**
-   * @brief Check if the optional_ptr is engaged
-   *
-   * @return true if the optional_ptr contains a value, false otherwise
-   */
-  [[nodiscard]] constexpr bool has_value() const noexcept
+private:
+  void* do_allocate(std::size_t p_bytes, std::size_t p_alignment) override
   {
-    return is_engaged();
+    auto const consumed_before = consumed_bytes();
+    auto const start = now();
+    void* result = nullptr;
+#if LIBHAL_STRONG_PTR_EXCEPTIONS
+    try {
+      result = m_upstream->allocate(p_bytes, p_alignment);
+    } catch (...) {
+      m_profile.failed_allocations++;
+      throw;
+    }
+#else
+    result = m_upstream->allocate(p_bytes, p_alignment);
+#endif
+    record_latency(
+      start, m_profile.allocate_ticks, m_profile.max_allocate_ticks);
+
+    if (m_consumed_bytes != nullptr) {
+      m_profile.padding_bytes += consumed_bytes() - consumed_before - p_bytes;
+    }
+    m_profile.allocations++;
+    m_profile.total_bytes += p_bytes;
+    m_profile.live_bytes += p_bytes;
+    m_profile.peak_live_bytes =
+      std::max(m_profile.peak_live_bytes, m_profile.live_bytes);
+    m_profile.size_histogram[std::min<std::size_t>(
+      std::bit_width(p_bytes == 0 ? 0 : p_bytes - 1),
+      allocation_profile::size_buckets - 1)]++;
+    m_profile.alignment_histogram[std::min<std::size_t>(
+      std::countr_zero(p_alignment),
+      allocation_profile::alignment_buckets - 1)]++;
+    return result;
   }
 
-  /**
-   * @brief Check if the optional_ptr is engaged
-   *
-   * @return true if the optional_ptr contains a value, false otherwise
-   */
-  constexpr explicit operator bool() const noexcept
+  void do_deallocate(void* p_address,
+                     std::size_t p_bytes,
+                     std::size_t p_alignment) override
   {
-    return is_engaged();
+    auto const start = now();
+    m_upstream->deallocate(p_address, p_bytes, p_alignment);
+    record_latency(
+      start, m_profile.deallocate_ticks, m_profile.max_deallocate_ticks);
+    m_profile.deallocations++;
+    m_profile.live_bytes -= p_bytes;
   }
 
-  /**
-   * @brief Access the contained value, throw if not engaged
-   *
-   * @return A copy of the contained strong_ptr
-   * @throws mem::nullptr_access if *this is disengaged
-   */
-  [[nodiscard]] constexpr strong_ptr<T>& value()
+  [[nodiscard]] bool do_is_equal(
+    std::pmr::memory_resource const& p_other) const noexcept override
   {
-    if (not is_engaged()) {
-      throw mem::nullptr_access();
-    }
-    return m_value;
+    return this == &p_other;
   }
 
-  /**
-   * @brief Access the contained value, throw if not engaged (const version)
-   *
-   * @return A copy of the contained strong_ptr
-   * @throws mem::nullptr_access if *this is disengaged
-   */
-  [[nodiscard]] constexpr strong_ptr<T> const& value() const
+  type_allocation_profile* find_or_add(void const* p_tag,
+                                       std::string_view p_name) noexcept
   {
-    if (not is_engaged()) {
-      throw mem::nullptr_access();
+    for (std::size_t i = 0; i < m_type_count; i++) {
+      if (m_tags[i] == p_tag) {
+        return &m_types[i];
+      }
     }
-    return m_value;
+    if (m_type_count == MaxTypes) {
+      return nullptr;
+    }
+    m_tags[m_type_count] = p_tag;
+    m_types[m_type_count].name = p_name;
+    return &m_types[m_type_count++];
   }
 
-  /**
-   * @brief Implicitly convert to a strong_ptr<T>
-   *
-   * This allows optional_ptr to be used anywhere a strong_ptr is expected
-   * when the optional_ptr is engaged.
-   *
-   * @return A copy of the contained strong_ptr
-   * @throws mem::nullptr_access if *this is disengaged
-   */
-  [[nodiscard]] constexpr operator strong_ptr<T>()
+  [[nodiscard]] std::size_t consumed_bytes() const noexcept
   {
-    return value();
+    return m_consumed_bytes != nullptr ? m_consumed_bytes(m_arena) : 0;
   }
 
-  /**
-   * @brief Implicitly convert to a strong_ptr<T> (const version)
-   *
-   * @return A copy of the contained strong_ptr
-   * @throws mem::nullptr_access if *this is disengaged
-   */
-  [[nodiscard]] constexpr operator strong_ptr<T>() const
+  [[nodiscard]] std::uint64_t now() const noexcept
   {
-    return value();
+    return m_clock != nullptr ? m_clock() : 0;
   }
 
-  /**
-   * @brief Implicitly convert to a strong_ptr for polymorphic types
-   *
-   * This allows optional_ptr<Derived> to be converted to strong_ptr<Base>
-   * when Derived is convertible to Base.
-   *
-   * @tparam U The target type (must be convertible from T)
-   * @return A copy of the contained strong_ptr, converted to the target type
-   * @throws mem::nullptr_access if *this is disengaged
-   */
-  template<typename U>
-  [[nodiscard]] constexpr operator strong_ptr<U>()
-    requires(std::is_convertible_v<T*, U*> && not std::is_same_v<T, U>)
+  void record_latency(std::uint64_t p_start,
+                      std::uint64_t& p_total,
+                      std::uint64_t& p_max) const noexcept
   {
-    if (not is_engaged()) {
-      throw mem::nullptr_access();
+    if (m_clock != nullptr) {
+      auto const elapsed = m_clock() - p_start;
+      p_total += elapsed;
+      p_max = std::max(p_max, elapsed);
     }
-    // strong_ptr handles the polymorphic conversion
-    return strong_ptr<U>(m_value);
   }
 
-  /**
-   * @brief Implicitly convert to a strong_ptr for polymorphic types (const
-   * version)
-   *
-   * @tparam U The target type (must be convertible from T)
-   * @return A copy of the contained strong_ptr, converted to the target type
-   * @throws mem::nullptr_access if *this is disengaged
-   */
-  template<typename U>
-  [[nodiscard]] constexpr operator strong_ptr<U>() const
-    requires(std::is_convertible_v<T*, U*> && not std::is_same_v<T, U>)
-  {
-    if (not is_engaged()) {
-      throw mem::nullptr_access();
-    }
-    // strong_ptr handles the polymorphic conversion
-    return strong_ptr<U>(m_value);
-  }
+  std::pmr::memory_resource* m_upstream;
+  void const* m_arena = nullptr;
+  std::size_t (*m_consumed_bytes)(void const*) noexcept = nullptr;
+  clock_function* m_clock = nullptr;
+  allocation_profile m_profile{};
+  std::array<void const*, MaxTypes> m_tags{};
+  std::array<type_allocation_profile, MaxTypes> m_types{};
+  std::size_t m_type_count = 0;
+};
 
-  /**
-   * @brief Arrow operator for accessing members of the contained object
-   *
-   * @return Pointer to the object managed by the contained strong_ptr
-   */
-  [[nodiscard]] constexpr auto* operator->()
-  {
-    auto& ref = *(this->value());
-    return &ref;
-  }
+/**
+ * @brief Detects the `std::span<T> const` element view of a strong array
+ *
+ * Used to keep an index literal of `0` from being mistaken for a null pointer
+ * when aliasing an element of a strong array.
+ */
+template<typename T>
+constexpr bool is_strong_array_view = false;
 
-  /**
-   * @brief Arrow operator for accessing members of the contained object (const
-   * version)
-   *
-   * @return Pointer to the object managed by the contained strong_ptr
-   */
-  [[nodiscard]] constexpr auto* operator->() const
-  {
-    auto& ref = *(this->value());
-    return &ref;
-  }
+template<typename T>
+constexpr bool is_strong_array_view<std::span<T> const> = true;
 
-  /**
-   * @brief Dereference operator for accessing the contained object
-   *
-   * @return Reference to the object managed by the contained strong_ptr
-   */
-  [[nodiscard]] constexpr auto& operator*()
-  {
-    auto& ref = *(this->value());
-    return ref;
-  }
+/**
+ * @brief Header of a single allocation holding a runtime number of elements
+ *
+ * The allocation is laid out as the header followed by `count` elements. The
+ * header holds a span over the elements so that a `strong_ptr` to the span can
+ * be handed out, sharing the control block of the whole allocation.
+ *
+ * @tparam T The type of the array elements
+ * @tparam Resource runtime_resource or static_resource_t
+ */
+template<typename T, typename Resource = runtime_resource>
+struct rc_array
+{
+  ref_info m_info;
+  std::span<T> const m_elements;
+  [[no_unique_address]] Resource m_resource;
 
-  /**
-   * @brief Dereference operator for accessing the contained object (const
-   * version)
-   *
-   * @return Reference to the object managed by the contained strong_ptr
-   */
-  [[nodiscard]] constexpr auto& operator*() const
-  {
-    auto& ref = *(this->value());
-    return ref;
-  }
+  /// Offset of the first element from the start of the allocation
+  static constexpr std::size_t elements_offset =
+    (sizeof(rc_array) + rc_object_alignment<T> - 1) / rc_object_alignment<T> *
+    rc_object_alignment<T>;
 
-  /**
-   * @brief Reset the optional to a disengaged state
-   */
-  constexpr void reset() noexcept
-  {
-    if (is_engaged()) {
-      m_value.~strong_ptr<T>();
-      m_raw_ptrs[0] = nullptr;
-      m_raw_ptrs[1] = nullptr;
-    }
-  }
+  /// Alignment of the allocation
+  static constexpr std::size_t alignment =
+    std::max(alignof(rc_array), rc_object_alignment<T>);
 
   /**
-   * @brief Emplace a new value
-   *
-   * Reset the optional and construct a new strong_ptr in-place.
+   * @brief Number of bytes required for the header and p_count elements
    *
-   * @tparam Args Types of arguments to forward to the constructor
-   * @param args Arguments to forward to the constructor
-   * @return Reference to the newly constructed strong_ptr
+   * @param p_count - number of elements
+   * @return std::size_t - allocation size in bytes
+   * @throws std::bad_alloc if the size cannot be represented
    */
-  template<typename... Args>
-  constexpr strong_ptr<T>& emplace(Args&&... args)
+  static constexpr std::size_t allocation_size(std::size_t p_count)
   {
-    reset();
-    new (&m_value) strong_ptr<T>(std::forward<Args>(args)...);
-    return m_value;
+    constexpr auto max_count =
+      (std::numeric_limits<std::size_t>::max() - elements_offset) / sizeof(T);
+    if (p_count > max_count) {
+      throw_bad_alloc();
+    }
+    return elements_offset + (p_count * sizeof(T));
   }
 
-  /**
-   * @brief Get the current reference count
-   *
-   * This is primarily for testing purposes. To determine if an optional_ptr
-   * points to a statically allocated object, this API must return 0 and
-   * `is_engaged()` must return true.
-   *
-   * @return The number of strong references to the managed object. Returns 0 if
-   * this pointer is nullptr.
-   */
-  [[nodiscard]] constexpr auto use_count() const noexcept
+  constexpr rc_array(Resource p_resource, T* p_elements, std::size_t p_count)
+    : m_info(&manage)
+    , m_elements(p_elements, p_count)
+    , m_resource(p_resource)
   {
-    return is_engaged() ? m_value.m_ctrl->strong_count : 0;
   }
 
-  /**
-   * @brief Swap the contents of this optional_ptr with another
-   *
-   * @param other The optional_ptr to swap with
-   */
-  constexpr void swap(optional_ptr& other) noexcept
+  static std::pmr::memory_resource* manage(ref_info* p_info,
+                                           ref_info::operation p_operation)
   {
-    if (is_engaged() && other.is_engaged()) {
-      std::swap(m_value, other.m_value);
-    } else if (is_engaged() && not other.is_engaged()) {
-      new (&other.m_value) strong_ptr<T>(std::move(m_value));
-      reset();
-    } else if (not is_engaged() && other.is_engaged()) {
-      new (&m_value) strong_ptr<T>(std::move(other.m_value));
-      other.reset();
+    // Cast back into the original rc_array type as m_info is the first member
+    auto* self = reinterpret_cast<rc_array*>(p_info);
+
+    switch (p_operation) {
+      case ref_info::operation::destroy:
+      case ref_info::operation::finalize:
+        destroy_elements(self);
+        break;
+      case ref_info::operation::deallocate:
+        deallocate(self);
+        break;
+      case ref_info::operation::destroy_and_deallocate:
+        destroy_elements(self);
+        deallocate(self);
+        break;
+      case ref_info::operation::get_allocator:
+        return self->m_resource.get();
     }
+    return nullptr;
   }
 
-private:
-  /**
-   * @brief Use the strong_ptr's memory directly through a union
-   *
-   * This allows us to detect whether the optional_ptr is engaged
-   * by checking if the internal pointers are non-null.
-   */
-  union
+  static void destroy_elements(rc_array* p_self)
   {
-    std::array<void*, 2> m_raw_ptrs = { nullptr, nullptr };
-    strong_ptr<T> m_value;
-  };
-
-  // Ensure the strong_ptr layout matches our expectations
-  static_assert(sizeof(m_value) == sizeof(m_raw_ptrs),
-                "strong_ptr must be exactly the size of two pointers");
+    if constexpr (not std::is_trivially_destructible_v<T>) {
+      // Destroy in reverse order of construction, like built-in arrays
+      for (auto i = p_self->m_elements.size(); i > 0; i--) {
+        std::destroy_at(&p_self->m_elements[i - 1]);
+      }
+    }
+  }
 
-  /**
-   * @brief Helper to check if the optional is engaged
-   *
-   * @return true if the optional_ptr contains a value, false otherwise
-   */
-  [[nodiscard]] constexpr bool is_engaged() const noexcept
+  static void deallocate(rc_array* p_self)
   {
-    return m_raw_ptrs[0] != nullptr || m_raw_ptrs[1] != nullptr;
+    auto const size = allocation_size(p_self->m_elements.size());
+    p_self->m_resource.get()->deallocate(p_self, size, alignment);
   }
 };
 
-/**
- * @brief Implement weak_ptr::lock() now that optional_ptr is defined
- *
- * This function attempts to obtain a strong_ptr from a weak_ptr.
- * If the referenced object still exists, it returns an optional_ptr
+// Check if a type is an array or std::array
+template<typename T>
+struct is_array_like : std::false_type
+{};
+
+// NOLINTBEGIN(modernize-avoid-c-arrays)
+// Specialization for C-style arrays
+template<typename T, std::size_t N>
+struct is_array_like<T[N]> : std::true_type
+{};
+// NOLINTEND(modernize-avoid-c-arrays)
+
+// Specialization for std::array
+template<typename T, std::size_t N>
+struct is_array_like<std::array<T, N>> : std::true_type
+{};
+
+// Helper variable template
+template<typename T>
+constexpr bool is_array_like_v = is_array_like<T>::value;
+
+// Concept for array-like types
+template<typename T>
+concept array_like = is_array_like_v<T>;
+
+// Concept for non-array-like types
+template<typename T>
+concept non_array_like = not array_like<T>;
+
+/**
+ * @ingroup Error
+ * @brief Base exception class for all hal related exceptions
+ *
+ */
+export class exception : public std::exception
+{
+public:
+  exception(std::errc p_error_code)
+    : m_error_code(p_error_code)
+  {
+  }
+
+  /**
+   * @brief Convert this exception to the closest C++ error code
+   *
+   * Main Use Case: Translation from C++ exceptions to C error codes
+   *
+   * Lets consider a situation when a C++ program must interface with C code or
+   * code that uses a C API to operate. Normally C++ code calls C code, but if
+   * C++ code is given to a C API like a callback and that C api expects an
+   * error code back for its own error handling purposes, this class function
+   * provides that error code. Simply catch the mem::exception, and return an
+   * error code. Perform any other recovery or handling required to make the
+   * system perform as expected.
+   *
+   * Other use cases:
+   *
+   * 1. Logging
+   *
+   * Log the error code value (or the stringified version) of this exception to
+   * alert developers of the kind of underlying exception that was thrown.
+   *
+   * 2. Recovery
+   *
+   * This can be used for recovery, but it is HIGHLY RECOMMENDED to use the
+   * derived classes in their own catch blocks to recover from a specific error
+   * rather than using the base class and extracting its error code.
+   *
+   * @return std::errc - error code represented by the exception
+   */
+  [[nodiscard]] constexpr std::errc error_code() const
+  {
+    return m_error_code;
+  }
+
+  [[nodiscard]] constexpr char const* what() const noexcept override
+  {
+    return "mem::exception";
+  }
+
+  // NOLINTNEXTLINE(modernize-use-equals-default)
+  ~exception() override
+  {
+    // Needed for GCC 14.2 LTO to link 🤷🏾‍♂️
+  }
+
+private:
+  std::errc m_error_code{};
+};
+
+/**
+ * @ingroup Error
+ * @brief Raised when an API attempts to access elements outside of a container
+ * or resource.
+ *
+ */
+export struct out_of_range : public exception
+{
+  struct info
+  {
+    std::size_t m_index;
+    std::size_t m_capacity;
+  };
+
+  out_of_range(info p_info)
+    : exception(std::errc::invalid_argument)
+    , info(p_info)
+  {
+  }
+
+  [[nodiscard]] constexpr char const* what() const noexcept override
+  {
+    return "mem::out_of_range";
+  }
+
+  // NOLINTNEXTLINE(modernize-use-equals-default)
+  ~out_of_range() override
+  {
+    // Needed for GCC 14.2 LTO to link 🤷🏾‍♂️
+  }
+
+  info info;
+};
+
+/**
+ * @ingroup Error
+ * @brief Raised when an API attempts to access the contents of an empty
+ * optional_ptr.
+ *
+ */
+export struct nullptr_access : public exception
+{
+  nullptr_access()
+    : exception(std::errc::invalid_argument)
+  {
+  }
+
+  [[nodiscard]] constexpr char const* what() const noexcept override
+  {
+    return "mem::nullptr_access";
+  }
+
+  // NOLINTNEXTLINE(modernize-use-equals-default)
+  ~nullptr_access() override
+  {
+    // Needed for GCC 14.2 LTO to link 🤷🏾‍♂️
+  }
+};
+
+/**
+ * @ingroup Error
+ * @brief Raised when a strong_ptr does not share the control block an object
+ * records for itself, for example when converting a strong_ptr to a member of
+ * another object into an intrusive_strong_ptr.
+ *
+ */
+export struct ownership_mismatch : public exception
+{
+  ownership_mismatch()
+    : exception(std::errc::invalid_argument)
+  {
+  }
+
+  [[nodiscard]] constexpr char const* what() const noexcept override
+  {
+    return "mem::ownership_mismatch";
+  }
+
+  // NOLINTNEXTLINE(modernize-use-equals-default)
+  ~ownership_mismatch() override
+  {
+    // Needed for GCC 14.2 LTO to link 🤷🏾‍♂️
+  }
+};
+
+// Out of line so each bounds or null check only inlines a compare and a call
+
+[[noreturn]] LIBHAL_STRONG_PTR_NOINLINE void throw_out_of_range(
+  std::size_t p_index,
+  std::size_t p_capacity)
+{
+  throw_exception(
+    mem::out_of_range({ .m_index = p_index, .m_capacity = p_capacity }));
+}
+
+[[noreturn]] LIBHAL_STRONG_PTR_NOINLINE void throw_nullptr_access()
+{
+  throw_exception(mem::nullptr_access());
+}
+
+/**
+ * @brief API tag used to create a strong_ptr which points to static memory
+ *
+ * As the name implies this is unsafe and is up to the developer to ensure that
+ * the object passed to strong_ptr actually has static storage duration.
+ *
+ * Handles to static objects are constant expressions, so global handles and
+ * tables of them can be constant initialized and placed in `.data` or
+ * `.rodata` with no code running at startup:
+ *
+ * ```C++
+ * my_uart uart0;
+ * my_uart uart1;
+ *
+ * // Immutable handle, no constructor or destructor runs
+ * constexpr mem::strong_ptr<my_uart> console(mem::unsafe_assume_static_tag{},
+ *                                            uart0);
+ *
+ * // Constant initialized, but may be reassigned to a dynamic object later
+ * constinit mem::optional_ptr<my_uart> logger = console;
+ *
+ * constexpr std::array<mem::strong_ptr<my_uart>, 2> uarts{
+ *   mem::strong_ptr<my_uart>(mem::unsafe_assume_static_tag{}, uart0),
+ *   mem::strong_ptr<my_uart>(mem::unsafe_assume_static_tag{}, uart1),
+ * };
+ * ```
+ *
+ * A `constinit` handle is mutable and could hold a dynamic object at exit, so
+ * its destructor is still registered to run at exit. Prefer `constexpr` for
+ * handles that never change.
+ */
+export struct unsafe_assume_static_tag
+{};
+
+/**
+ * @brief A non-nullable strong reference counted pointer
+ *
+ * strong_ptr is a smart pointer that maintains shared ownership of an object
+ * through a reference count. It is similar to std::shared_ptr but with these
+ * key differences:
+ *
+ * 1. Cannot be null - must always point to a valid object
+ * 2. Can only be created via make_strong_ptr, not from raw pointers
+ * 3. More memory efficient implementation
+ *
+ * Use strong_ptr when you need shared ownership semantics and can guarantee
+ * the pointer will never be null. For nullable references, use optional_ptr.
+ *
+ * Example usage:
+ *
+ * ```C++
+ * // Create a strong_ptr to an object
+ * auto i2c = mem::make_strong_ptr<my_i2c_driver>(allocator, arg1, arg2);
+ *
+ * // Use the object using dereference (*) operator
+ * (*i2c).configure({ .clock_rate = 250_kHz });
+ *
+ * // OR use the object using arrow (->) operator
+ * i2c->configure({ .clock_rate = 250_kHz });
+ *
+ * // Share ownership with another driver or object
+ * auto sensor = mem::make_strong_ptr<my_sensor>(allocator, i2c, 0x13);
+ * ```
+ *
+ * @tparam T The type of the managed object
+ */
+template<typename T>
+class strong_ptr
+{
+public:
+  using element_type = std::remove_extent_t<T>;
+  using weak_type = weak_ptr<T>;
+
+  /// Delete default constructor - strong_ptr must always be valid
+  strong_ptr() = delete;
+
+  /// Delete nullptr constructor - strong_ptr must always be valid
+  strong_ptr(std::nullptr_t) = delete;
+
+  /**
+   * @brief Create a strong_ptr that points to points to an object with static
+   * storage duration.
+   *
+   * This API MUST only be used with objects with static storage duration.
+   * Without that precondition met, it is UB to create such a strong_ptr.
+   *
+   * There is no way in C++23 and below to determine if an lvalue passed has
+   * static storage duration. With C++26 and `std::has_static_storage_duration`
+   * we can determine this at compile time and provide a compile time error if
+   * the passed lvalue is not an object with static storage duration. This
+   * constructor will be deprecated once the library migrates to C++26.
+   *
+   * Since the original object was statically allocated, there is no need for a
+   * ref counted control block and thus no allocation occurs. `use_count()` will
+   * return 0 meaning that the object is statically allocated.
+   *
+   * @param p_object - a statically allocated object to
+   * @return strong_ptr<T> - A strong_ptr pointing to lvalue which should have
+   * static storage duration.
+   */
+  constexpr strong_ptr(unsafe_assume_static_tag, T& p_object)
+    : m_ptr(&p_object)
+  {
+  }
+
+  /**
+   * @brief Copy constructor
+   *
+   * Creates a new strong reference to the same object.
+   *
+   * @param p_other The strong_ptr to copy from
+   */
+  constexpr strong_ptr(strong_ptr const& p_other) noexcept
+    : m_ctrl(p_other.m_ctrl)
+    , m_ptr(p_other.m_ptr)
+  {
+    add_ref();
+  }
+
+  /**
+   * @brief Converting copy constructor
+   *
+   * Creates a new strong reference to the same object, converting from
+   * a derived type U to base type T.
+   *
+   * @tparam U A type convertible to T
+   * @param p_other The strong_ptr to copy from
+   */
+  template<typename U>
+  constexpr strong_ptr(strong_ptr<U> const& p_other) noexcept
+    requires(std::is_convertible_v<U*, T*>)
+    : m_ctrl(p_other.m_ctrl)
+    , m_ptr(p_other.m_ptr)
+  {
+    add_ref();
+  }
+
+  /**
+   * @brief Move constructor that intentionally behaves like a copy constructor
+   * for safety
+   *
+   * This move constructor deliberately performs a full copy operation rather
+   * than transferring ownership. This is a safety feature to prevent potential
+   * undefined behavior that could occur if code accidentally accessed a
+   * moved-from strong_ptr.
+   *
+   * After this operation, both the source and destination objects remain in
+   * valid states, and the reference count is incremented by 1. This ensures
+   * that even if code incorrectly continues to use the source object after a
+   * move, no undefined behavior will occur.
+   *
+   * To hand over a reference without touching the reference count, hold it in
+   * an optional_ptr, which supports true move semantics, and convert the
+   * rvalue optional_ptr back into a strong_ptr where it is needed.
+   *
+   * @param p_other The strong_ptr to "move" from (actually copied for safety)
+   */
+  constexpr strong_ptr(strong_ptr&& p_other) noexcept
+    : m_ctrl(p_other.m_ctrl)
+    , m_ptr(p_other.m_ptr)
+  {
+    add_ref();
+  }
+
+  /**
+   * @brief Move assignment operator that behaves like a copy assignment for
+   * safety
+   *
+   * This move assignment operator deliberately performs a full copy operation
+   * rather than transferring ownership. This is a safety feature to prevent
+   * potential undefined behavior that could occur if code accidentally accessed
+   * a moved-from strong_ptr.
+   *
+   * After this operation, both the source and destination objects remain in
+   * valid states, and the reference count is incremented by 1. This ensures
+   * that even if code incorrectly continues to use the source object after a
+   * move, no undefined behavior will occur.
+   *
+   * @param p_other The strong_ptr to "move" from (actually copied for safety)
+   * @return Reference to *this
+   */
+  constexpr strong_ptr& operator=(strong_ptr&& p_other) noexcept
+  {
+    if (this != &p_other) {
+      release();
+      m_ctrl = p_other.m_ctrl;
+      m_ptr = p_other.m_ptr;
+      add_ref();
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Compile time error message for bad alias value
+   *
+   * `std::shared_ptr` provides an alias constructor that accepts any `void*`
+   * which is UB if that `void*` doesn't have the same lifetime as the object
+   * referenced by the `std::shared_ptr`. Users attempting to do this will get a
+   * list of constructors that failed to fit. This is not a good error message
+   * for users. Instead, we provide a static_assert message in plain english
+   * that explains why this overload fails at compile time.
+   *
+   * @tparam U - some type for the strong_ptr.
+   */
+  template<typename U>
+  constexpr strong_ptr(strong_ptr<U> const&, void const*) noexcept
+    requires(not is_strong_array_view<U>)
+  {
+    // NOTE: The conditional used here is to prevent the compiler from
+    // jumping-the-gun and emitting the static assert error during template
+    // instantiation of the class. With this conditional, the error only appears
+    // when this constructor is used.
+    static_assert(
+      std::is_same_v<U, void> && not std::is_same_v<U, void>,
+      "Aliasing constructor only works with pointers-to-members "
+      "and does not work with arbitrary pointers like std::shared_ptr allows.");
+  }
+
+  /**
+   * @brief Safe aliasing constructor for object members
+   *
+   * This constructor creates a strong_ptr that points to a member of an object
+   * managed by another strong_ptr. The resulting strong_ptr shares ownership
+   * with the original strong_ptr, keeping the entire parent object alive.
+   *
+   * This version is only enabled for non-array members to prevent potential
+   * undefined behavior when accessing array elements directly. Use the
+   * array-specific versions instead.
+   *
+   * Example usage:
+   * ```
+   * struct container {
+   *   component part;
+   * };
+   *
+   * // Create a strong_ptr to the container
+   * auto container_ptr = make_strong_ptr<container>(allocator);
+   *
+   * // Create a strong_ptr to just the component
+   * auto component_ptr = strong_ptr<component>(container_ptr,
+   * &container::part);
+   * ```
+   *
+   * @tparam U Type of the parent object
+   * @tparam M Type of the member
+   * @param p_other The strong_ptr to the parent object
+   * @param p_member_ptr Pointer-to-member identifying which member to reference
+   */
+  template<typename U, non_array_like M>
+  constexpr strong_ptr(strong_ptr<U> const& p_other,
+                       // clang-format off
+             M U::* p_member_ptr
+                       // clang-format on
+                       ) noexcept
+
+    : m_ctrl(p_other.m_ctrl)
+    , m_ptr(&((*p_other).*p_member_ptr))
+  {
+    add_ref();
+  }
+
+  /**
+   * @brief Safe aliasing constructor for std::array members
+   *
+   * This constructor creates a strong_ptr that points to an element of an array
+   * member in an object managed by another strong_ptr. It performs bounds
+   * checking to ensure the index is valid.
+   *
+   * Example usage:
+   * ```
+   * struct array_container {
+   *   std::array<element, 5> elements;
+   * };
+   *
+   * auto container_ptr = make_strong_ptr<array_container>(allocator);
+   *
+   * // Get strong_ptr to the 2nd element
+   * auto element_ptr = strong_ptr<element>(
+   *   container_ptr,
+   *   &array_container::elements,
+   *   2 // Index to access
+   * );
+   * ```
+   *
+   * @tparam U Type of the parent object
+   * @tparam E Type of the array element
+   * @tparam N Size of the array
+   * @param p_other The strong_ptr to the parent object
+   * @param p_array_ptr Pointer-to-member identifying the array member
+   * @param p_index Index of the element to reference
+   * @throws mem::out_of_range if index is out of bounds
+   */
+  template<typename U, typename E, std::size_t N>
+  constexpr strong_ptr(strong_ptr<U> const& p_other,
+                       // clang-format off
+             std::array<E, N> U::* p_array_ptr,
+                       // clang-format on
+                       std::size_t p_index)
+  {
+    static_assert(std::is_convertible_v<E*, T*>,
+                  "Array element type must be convertible to T");
+    throw_if_out_of_bounds(N, p_index);
+    m_ctrl = p_other.m_ctrl;
+    m_ptr = &((*p_other).*p_array_ptr)[p_index];
+    add_ref();
+  }
+
+  // NOLINTBEGIN(modernize-avoid-c-arrays)
+  /**
+   * @brief Safe aliasing constructor for C-array members
+   *
+   * This constructor creates a strong_ptr that points to an element of a
+   * C-style array member in an object managed by another strong_ptr. It
+   * performs bounds checking to ensure the index is valid.
+   *
+   * Example usage:
+   * ```
+   * struct c_array_container {
+   *   element elements[5];
+   * };
+   *
+   * auto container_ptr = make_strong_ptr<c_array_container>(allocator);
+   *
+   * // Get strong_ptr to the 2nd element
+   * auto element_ptr = strong_ptr<element>(
+   *   container_ptr,
+   *   &c_array_container::elements,
+   *   2 // Index to access
+   * );
+   * ```
+   *
+   * @tparam U Type of the parent object
+   * @tparam E Type of the array element
+   * @tparam N Size of the array
+   * @param p_other The strong_ptr to the parent object
+   * @param p_array_ptr Pointer-to-member identifying the array member
+   * @param p_index Index of the element to reference
+   * @throws mem::out_of_range if index is out of bounds
+   */
+  template<typename U, typename E, std::size_t N>
+  constexpr strong_ptr(strong_ptr<U> const& p_other,
+                       E (U::*p_array_ptr)[N],
+                       std::size_t p_index)
+  {
+    static_assert(std::is_convertible_v<E*, T*>,
+                  "Array element type must be convertible to T");
+    throw_if_out_of_bounds(N, p_index);
+    m_ctrl = p_other.m_ctrl;
+    m_ptr = &((*p_other).*p_array_ptr)[p_index];
+    add_ref();
+  }
+  // NOLINTEND(modernize-avoid-c-arrays)
+
+  /**
+   * @brief Safe aliasing constructor for elements of a strong array
+   *
+   * This constructor creates a strong_ptr that points to an element of an
+   * array created by `make_strong_array`. It performs bounds checking to ensure
+   * the index is valid. The element shares ownership of the whole array.
+   *
+   * Example usage:
+   * ```
+   * auto buffer = make_strong_array<packet>(allocator, 16);
+   *
+   * // Get strong_ptr to the 3rd packet
+   * auto packet_ptr = strong_ptr<packet>(buffer, 2);
+   * ```
+   *
+   * @tparam E Type of the array element
+   * @param p_array The strong_ptr to the array
+   * @param p_index Index of the element to reference
+   * @throws mem::out_of_range if index is out of bounds
+   */
+  template<typename E>
+  constexpr strong_ptr(strong_ptr<std::span<E> const> const& p_array,
+                       std::size_t p_index)
+  {
+    static_assert(std::is_convertible_v<E*, T*>,
+                  "Array element type must be convertible to T");
+    throw_if_out_of_bounds(p_array->size(), p_index);
+    m_ctrl = p_array.m_ctrl;
+    m_ptr = &(*p_array)[p_index];
+    add_ref();
+  }
+
+  /**
+   * @brief Destructor
+   *
+   * Decrements the reference count and destroys the managed object
+   * if this was the last strong reference.
+   */
+  constexpr ~strong_ptr()
+  {
+    release();
+  }
+
+  /**
+   * @brief Copy assignment operator
+   *
+   * Replaces the managed object with the one managed by p_other.
+   *
+   * @param p_other The strong_ptr to copy from
+   * @return Reference to *this
+   */
+  constexpr strong_ptr& operator=(strong_ptr const& p_other) noexcept
+  {
+    if (this != &p_other) {
+      release();
+      m_ctrl = p_other.m_ctrl;
+      m_ptr = p_other.m_ptr;
+      add_ref();
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Converting copy assignment operator
+   *
+   * Replaces the managed object with the one managed by p_other,
+   * converting from type U to type T.
+   *
+   * @tparam U A type convertible to T
+   * @param p_other The strong_ptr to copy from
+   * @return Reference to *this
+   */
+  template<typename U>
+  constexpr strong_ptr& operator=(strong_ptr<U> const& p_other) noexcept
+    requires(std::is_convertible_v<U*, T*>)
+  {
+    release();
+    m_ctrl = p_other.m_ctrl;
+    m_ptr = p_other.m_ptr;
+    add_ref();
+    return *this;
+  }
+
+  /**
+   * @brief Swap the contents of this strong_ptr with another
+   *
+   * @param p_other The strong_ptr to swap with
+   */
+  constexpr void swap(strong_ptr& p_other) noexcept
+  {
+    std::swap(m_ctrl, p_other.m_ctrl);
+    std::swap(m_ptr, p_other.m_ptr);
+  }
+
+  /**
+   * @brief Disable dereferencing for r-values (temporaries)
+   */
+  T& operator*() && = delete;
+
+  /**
+   * @brief Disable member access for r-values (temporaries)
+   */
+  T* operator->() && = delete;
+
+  /**
+   * @brief Dereference operator to access the managed object
+   *
+   * @return Reference to the managed object
+   */
+  [[nodiscard]] constexpr T& operator*() const& noexcept
+  {
+    return *m_ptr;
+  }
+
+  /**
+   * @brief Member access operator to access the managed object
+   *
+   * @return Pointer to the managed object
+   */
+  [[nodiscard]] constexpr T* operator->() const& noexcept
+  {
+    return m_ptr;
+  }
+
+  /**
+   * @brief Get the current reference count
+   *
+   * This is primarily for testing purposes.
+   *
+   * @return The number of strong references to the managed object
+   */
+  [[nodiscard]] constexpr auto use_count() const noexcept
+  {
+    return m_ctrl ? m_ctrl->use_count() : 0;
+  }
+
+  /**
+   * @brief Returns if the object this is pointing to is statically allocated or
+   * not.
+   *
+   * @return true - object has dynamic storage duration.
+   * @return false - object is assumed to have static storage duration.
+   */
+  [[nodiscard]] constexpr bool is_dynamic() const noexcept
+  {
+    return m_ctrl != nullptr;
+  }
+
+  /**
+   * @brief Get the allocator used to allocate this object
+   *
+   * @return constexpr std::pmr::memory_resource* - the allocator used to
+   * allocate this object. Returns `nullptr` if the object was statically
+   * allocated.
+   */
+  [[nodiscard]] constexpr std::pmr::memory_resource* get_allocator()
+    const noexcept
+  {
+    if (m_ctrl == nullptr) {
+      return nullptr;
+    }
+    return m_ctrl->allocator();
+  }
+
+  /**
+   * @brief Order by owning control block rather than by pointed to object
+   *
+   * Aliases of the same object, such as a strong_ptr to a member, share an
+   * owner and are equivalent under this ordering. Objects with static storage
+   * duration have no control block and are ordered by the address held.
+   *
+   * @param p_other - strong_ptr to compare ownership with
+   * @return true if this owner is ordered before the owner of p_other
+   */
+  template<typename U>
+  [[nodiscard]] constexpr bool owner_before(
+    strong_ptr<U> const& p_other) const noexcept
+  {
+    return std::less<>{}(owner_key(), p_other.owner_key());
+  }
+
+  /**
+   * @brief Order by owning control block rather than by pointed to object
+   *
+   * @param p_other - weak_ptr to compare ownership with
+   * @return true if this owner is ordered before the owner of p_other
+   */
+  template<typename U>
+  [[nodiscard]] constexpr bool owner_before(
+    weak_ptr<U> const& p_other) const noexcept
+  {
+    return std::less<>{}(owner_key(), p_other.owner_key());
+  }
+
+  /**
+   * @brief Check if both share the same owning control block
+   *
+   * @param p_other - strong_ptr to compare ownership with
+   * @return true if both have the same owner
+   */
+  template<typename U>
+  [[nodiscard]] constexpr bool owner_equal(
+    strong_ptr<U> const& p_other) const noexcept
+  {
+    return owner_key() == p_other.owner_key();
+  }
+
+  /**
+   * @brief Check if both share the same owning control block
+   *
+   * @param p_other - weak_ptr to compare ownership with
+   * @return true if both have the same owner
+   */
+  template<typename U>
+  [[nodiscard]] constexpr bool owner_equal(
+    weak_ptr<U> const& p_other) const noexcept
+  {
+    return owner_key() == p_other.owner_key();
+  }
+
+  /**
+   * @brief Hash of the owning control block, consistent with `owner_equal()`
+   *
+   * @return std::size_t - hash of the owner
+   */
+  [[nodiscard]] std::size_t owner_hash() const noexcept
+  {
+    return std::hash<void const*>{}(owner_key());
+  }
+
+private:
+  template<class U>
+  friend class enable_strong_from_this;
+
+  template<class U>
+  friend class enable_strong_from_this_compact;
+
+  template<class U>
+  friend class strong_promise;
+
+  friend struct strong_ptr_factory;
+
+  template<typename U>
+  friend class strong_ptr;
+
+  template<typename U>
+  friend class weak_ptr;
+
+  template<typename U>
+  friend class optional_ptr;
+
+  template<typename U>
+  friend class intrusive_strong_ptr;
+
+  template<typename U>
+  friend class strong_ref;
+
+  template<typename U>
+  friend class strong_span;
+
+  // Identifies the owner for owner_before(), owner_equal() and owner_hash().
+  // Objects with static storage duration have no control block, so their
+  // address stands in for it.
+  [[nodiscard]] constexpr void const* owner_key() const noexcept
+  {
+    if (m_ctrl != nullptr) {
+      return m_ctrl;
+    }
+    return m_ptr;
+  }
+
+  constexpr void throw_if_out_of_bounds(std::size_t p_size, std::size_t p_index)
+  {
+    if (p_index >= p_size) {
+      throw_out_of_range(p_index, p_size);
+    }
+  }
+
+  constexpr void add_ref()
+  {
+    if (is_dynamic()) {
+      m_ctrl->add_ref<T>();
+    }
+  }
+
+  // Internal constructor with control block and pointer - used by make() and
+  // weak_ptr::lock(). Adopts a strong reference that the caller has already
+  // accounted for in the control block.
+  constexpr strong_ptr(ref_info* p_ctrl, T* p_ptr) noexcept
+    : m_ctrl(p_ctrl)
+    , m_ptr(p_ptr)
+  {
+  }
+
+  constexpr void release()
+  {
+    if (is_dynamic()) {
+      m_ctrl->release<T>();
+    }
+  }
+
+  ref_info* m_ctrl = nullptr;
+  T* m_ptr = nullptr;
+};
+
+/**
+ * @brief CRTP mixin to enable objects to create strong_ptr instances to
+ * themselves
+ *
+ * Similar to `std::enable_shared_from_this`, this class allows an object to
+ * safely obtain a strong_ptr to itself. The object must inherit from this class
+ * and be managed by a strong_ptr created via make_strong_ptr.
+ *
+ * Example usage:
+ * ```cpp
+ * class my_driver : public enable_strong_from_this<my_driver> {
+ * public:
+ *   void register_callback() {
+ *     // Get a strong_ptr to ourselves
+ *     auto self = strong_from_this();
+ *     some_async_system.register_callback([self](){
+ *       self->handle_callback();
+ *     });
+ *   }
+ * };
+ *
+ * auto obj = make_strong_ptr<my_driver>(allocator);
+ * obj->register_callback(); // Safe to get strong_ptr to self
+ * ```
+ *
+ * @tparam T The derived class type
+ */
+export template<class T>
+class enable_strong_from_this
+{
+public:
+  /**
+   * @brief Get a strong_ptr to this object
+   *
+   * @return strong_ptr<T> pointing to this object
+   */
+  [[nodiscard]] constexpr strong_ptr<T> strong_from_this()
+  {
+    m_ref_counted_self->add_ref<T>();
+    return strong_ptr<T>(m_ref_counted_self, static_cast<T*>(this));
+  }
+
+  /**
+   * @brief Get a strong_ptr to this object (const version)
+   *
+   * @return strong_ptr<T const> pointing to this object
+   */
+  [[nodiscard]] constexpr strong_ptr<T const> strong_from_this() const
+  {
+    m_ref_counted_self->add_ref<T>();
+    return strong_ptr<T const>(m_ref_counted_self, static_cast<T const*>(this));
+  }
+
+  /**
+   * @brief Get a weak_ptr to this object
+   *
+   * @return weak_ptr<T> pointing to this object
+   */
+  [[nodiscard]] constexpr weak_ptr<T> weak_from_this() noexcept
+  {
+    return strong_from_this();
+  }
+
+  /**
+   * @brief Get a weak_ptr to this object (const version)
+   *
+   * @return weak_ptr<T const> pointing to this object
+   */
+  [[nodiscard]] constexpr weak_ptr<T const> weak_from_this() const noexcept
+  {
+    return strong_from_this();
+  }
+
+private:
+  friend T;
+
+  /**
+   * @brief Protected constructor to prevent direct instantiation
+   */
+  enable_strong_from_this() = default;
+
+  // NOLINTBEGIN(bugprone-unhandled-self-assignment)
+  /**
+   * @brief Protected assignment operator
+   *
+   * Note: The weak_ptr is not assigned - each object keeps its own weak
+   * reference
+   */
+  constexpr enable_strong_from_this& operator=(
+    enable_strong_from_this const&) noexcept
+  {
+    // Intentionally don't assign m_weak_this
+    return *this;
+  }
+  // NOLINTEND(bugprone-unhandled-self-assignment)
+
+  /**
+   * @brief Protected destructor
+   */
+  ~enable_strong_from_this() = default;
+
+  /**
+   * @brief Protected copy constructor
+   *
+   * Note: The weak_ptr is not copied - each object gets its own weak reference
+   */
+  enable_strong_from_this(enable_strong_from_this const&) noexcept
+  {
+    // Intentionally don't copy m_weak_this
+  }
+
+  friend struct strong_ptr_factory;
+
+  /**
+   * @brief Initialize the weak reference (called by make_strong_ptr)
+   *
+   * @param p_self The control block that manages this object
+   */
+  constexpr void init_weak_this(ref_info* p_self) noexcept
+  {
+    m_ref_counted_self = p_self;
+  }
+
+  template<typename U>
+  friend class intrusive_strong_ptr;
+
+  ref_info* m_ref_counted_self = nullptr;
+};
+
+/**
+ * @brief A single pointer wide strong reference to an object that tracks its
+ * own control block
+ *
+ * `strong_ptr<T>` stores both a pointer to the control block and a pointer to
+ * the object. Types that inherit from `enable_strong_from_this<T>` already
+ * store a pointer to their control block within the object, so a handle to
+ * them only needs the object pointer. This halves the memory used by tables of
+ * handles, at the cost of one extra indirection to reach the control block
+ * when a handle is copied or destroyed.
+ *
+ * Like strong_ptr, an intrusive_strong_ptr can never be null. It converts to
+ * and from `strong_ptr<T>` so existing APIs keep working.
+ *
+ * Example usage:
+ * ```
+ * class node : public mem::enable_strong_from_this<node> { ... };
+ *
+ * std::array<mem::intrusive_strong_ptr<node>, 64> table = ...;
+ * table[0] = mem::make_strong_ptr<node>(allocator);
+ * mem::strong_ptr<node> regular = table[0];
+ * ```
+ *
+ * @tparam T - type of the object, must inherit from enable_strong_from_this<T>
+ */
+export template<typename T>
+class intrusive_strong_ptr
+{
+public:
+  using element_type = T;
+
+  /**
+   * @brief Create from a strong_ptr that owns the object
+   *
+   * @param p_other - strong_ptr to the object
+   * @throws mem::ownership_mismatch if p_other does not share the object's own
+   * control block, such as a strong_ptr aliasing a member of another object.
+   */
+  constexpr intrusive_strong_ptr(strong_ptr<T> const& p_other)
+    : m_ptr(p_other.m_ptr)
+  {
+    static_assert(std::is_base_of_v<enable_strong_from_this<T>, T>,
+                  "intrusive_strong_ptr<T> requires T to inherit from "
+                  "enable_strong_from_this<T>");
+    if (p_other.m_ctrl != ctrl()) [[unlikely]] {
+      throw_exception(mem::ownership_mismatch());
+    }
+    add_ref();
+  }
+
+  constexpr intrusive_strong_ptr(intrusive_strong_ptr const& p_other) noexcept
+    : m_ptr(p_other.m_ptr)
+  {
+    add_ref();
+  }
+
+  constexpr intrusive_strong_ptr& operator=(
+    intrusive_strong_ptr const& p_other) noexcept
+  {
+    if (this != &p_other) {
+      // Acquire first, in case both refer to the same object
+      p_other.add_ref();
+      release();
+      m_ptr = p_other.m_ptr;
+    }
+    return *this;
+  }
+
+  ~intrusive_strong_ptr()
+  {
+    release();
+  }
+
+  /**
+   * @brief Convert to a regular strong_ptr sharing ownership of the object
+   *
+   * @return strong_ptr<T> - strong_ptr to the same object
+   */
+  [[nodiscard]] constexpr operator strong_ptr<T>() const noexcept
+  {
+    add_ref();
+    return strong_ptr<T>(ctrl(), m_ptr);
+  }
+
+  /**
+   * @brief Disable dereferencing for r-values (temporaries)
+   */
+  T& operator*() && = delete;
+
+  /**
+   * @brief Disable member access for r-values (temporaries)
+   */
+  T* operator->() && = delete;
+
+  [[nodiscard]] constexpr T& operator*() const& noexcept
+  {
+    return *m_ptr;
+  }
+
+  [[nodiscard]] constexpr T* operator->() const& noexcept
+  {
+    return m_ptr;
+  }
+
+  /**
+   * @brief Get the current reference count
+   *
+   * @return The number of strong references to the managed object
+   */
+  [[nodiscard]] auto use_count() const noexcept
+  {
+    auto* info = ctrl();
+    return info ? info->use_count() : 0;
+  }
+
+  constexpr void swap(intrusive_strong_ptr& p_other) noexcept
+  {
+    std::swap(m_ptr, p_other.m_ptr);
+  }
+
+private:
+  [[nodiscard]] constexpr ref_info* ctrl() const noexcept
+  {
+    return static_cast<enable_strong_from_this<T> const*>(m_ptr)
+      ->m_ref_counted_self;
+  }
+
+  constexpr void add_ref() const
+  {
+    // Objects with static storage duration have no control block
+    if (auto* info = ctrl()) {
+      info->template add_ref<T>();
+    }
+  }
+
+  constexpr void release()
+  {
+    if (auto* info = ctrl()) {
+      info->template release<T>();
+    }
+  }
+
+  T* m_ptr;
+};
+
+/**
+ * @brief Equality operator for intrusive_strong_ptr
+ *
+ * @return true if both point to the same object, false otherwise
+ */
+export template<typename T, typename U>
+[[nodiscard]] constexpr bool operator==(
+  intrusive_strong_ptr<T> const& p_lhs,
+  intrusive_strong_ptr<U> const& p_rhs) noexcept
+{
+  return p_lhs.operator->() == p_rhs.operator->();
+}
+
+/**
+ * @brief A non-owning, non-null reference to an object owned by strong_ptr
+ *
+ * Passing `strong_ptr<T>` by value costs a reference count increment and
+ * decrement per call, while passing `T&` loses the ability to extend the
+ * lifetime of the object. strong_ref sits between the two: it is created from
+ * a `strong_ptr<T> const&` without touching the reference count, can be passed
+ * by value through any number of calls, and can be promoted to a
+ * `strong_ptr<T>` when a callee needs to keep the object.
+ *
+ * Like a reference, strong_ref must not outlive the strong_ptr it was created
+ * from. It cannot be created from a temporary strong_ptr. Builds without
+ * NDEBUG check, on promotion, that the object has not been destroyed; this can
+ * only catch an object kept in memory by a weak_ptr.
+ *
+ * Example usage:
+ * ```
+ * void update(mem::strong_ref<sensor> p_sensor) {
+ *   p_sensor->read();  // No reference count traffic
+ *   if (needs_followup()) {
+ *     g_pending = p_sensor.promote();  // Keep the sensor alive
+ *   }
+ * }
+ *
+ * auto sensor = mem::make_strong_ptr<sensor>(allocator);
+ * update(sensor);
+ * ```
+ *
+ * @tparam T - type of the referenced object
+ */
+export template<typename T>
+class strong_ref
+{
+public:
+  using element_type = T;
+
+  /**
+   * @brief Borrow the object of a strong_ptr
+   *
+   * @param p_owner - strong_ptr that must outlive this strong_ref
+   */
+  constexpr strong_ref(strong_ptr<T> const& p_owner) noexcept
+    : m_ctrl(p_owner.m_ctrl)
+    , m_ptr(p_owner.m_ptr)
+  {
+  }
+
+  /**
+   * @brief Borrow the object of a strong_ptr to a derived type
+   *
+   * @tparam U - type convertible to T
+   * @param p_owner - strong_ptr that must outlive this strong_ref
+   */
+  template<typename U>
+  constexpr strong_ref(strong_ptr<U> const& p_owner) noexcept
+    requires(std::is_convertible_v<U*, T*>)
+    : m_ctrl(p_owner.m_ctrl)
+    , m_ptr(p_owner.m_ptr)
+  {
+  }
+
+  /**
+   * @brief Convert from a strong_ref to a derived type
+   *
+   * @tparam U - type convertible to T
+   * @param p_other - strong_ref to convert
+   */
+  template<typename U>
+  constexpr strong_ref(strong_ref<U> const& p_other) noexcept
+    requires(std::is_convertible_v<U*, T*>)
+    : m_ctrl(p_other.m_ctrl)
+    , m_ptr(p_other.m_ptr)
+  {
+  }
+
+  /**
+   * @brief Borrowing from a temporary would leave the strong_ref dangling
+   */
+  strong_ref(strong_ptr<T>&&) = delete;
+
+  /**
+   * @brief Borrowing from a temporary would leave the strong_ref dangling
+   */
+  template<typename U>
+  strong_ref(strong_ptr<U>&&) = delete;
+
+  /**
+   * @brief Get a strong_ptr sharing ownership of the object
+   *
+   * @return strong_ptr<T> - owning pointer to the object
+   */
+  [[nodiscard]] strong_ptr<T> promote() const
+  {
+    if (m_ctrl) {
+#if not defined(NDEBUG)
+      if (m_ctrl->use_count() <= 0) [[unlikely]] {
+        // The strong_ptr this was borrowed from no longer exists
+        std::terminate();
+      }
+#endif
+      m_ctrl->add_ref<T>();
+    }
+    return strong_ptr<T>(m_ctrl, m_ptr);
+  }
+
+  [[nodiscard]] constexpr T& operator*() const noexcept
+  {
+    return *m_ptr;
+  }
+
+  [[nodiscard]] constexpr T* operator->() const noexcept
+  {
+    return m_ptr;
+  }
+
+  /**
+   * @brief Get the current reference count
+   *
+   * @return The number of strong references to the object, borrows excluded
+   */
+  [[nodiscard]] auto use_count() const noexcept
+  {
+    return m_ctrl ? m_ctrl->use_count() : 0;
+  }
+
+private:
+  template<typename U>
+  friend class strong_ref;
+
+  ref_info* m_ctrl;
+  T* m_ptr;
+};
+
+/**
+ * @brief Equality operator for strong_ref
+ *
+ * @return true if both refer to the same object, false otherwise
+ */
+export template<typename T, typename U>
+[[nodiscard]] constexpr bool operator==(strong_ref<T> const& p_lhs,
+                                        strong_ref<U> const& p_rhs) noexcept
+{
+  return p_lhs.operator->() == p_rhs.operator->();
+}
+
+/// Delays the check of thread_safe_ref_count until T is instantiated
+template<typename T>
+constexpr bool thread_safe_ref_count_for = thread_safe_ref_count;
+
+/**
+ * @brief A strong_ptr that can be loaded and replaced concurrently
+ *
+ * Intended for publishing shared state, such as configuration snapshots or
+ * routing tables, to many reader threads. Equivalent in purpose to
+ * `std::atomic<std::shared_ptr<T>>`.
+ *
+ * Implemented with the Left-Right technique: two copies of the current value
+ * are kept, readers always read the copy not being modified, and writers wait
+ * for readers of the copy they are about to modify to leave. As a result:
+ *
+ * - `load()` is wait-free: a fixed number of atomic operations, never blocked
+ *   by writers or other readers.
+ * - `store()`, `exchange()` and `compare_exchange_*()` are serialized with
+ *   each other and block, rather than spin, until in-flight `load()` calls
+ *   finish copying. They are not lock-free, which is why `is_always_lock_free`
+ *   is false.
+ *
+ * This avoids the double width compare-and-swap, which many targets lack,
+ * that a lock-free implementation of a two pointer strong_ptr would require.
+ * Requires a build with LIBHAL_STRONG_PTR_THREAD_SAFE so that the reference
+ * counts themselves are atomic.
+ *
+ * Example usage:
+ * ```
+ * mem::atomic_strong_ptr<config> current(mem::make_strong_ptr<config>(alloc));
+ *
+ * // Reader threads
+ * auto snapshot = current.load();
+ *
+ * // Reload thread
+ * current.store(mem::make_strong_ptr<config>(alloc, new_settings));
+ * ```
+ *
+ * @tparam T - type of the object pointed to
+ */
+export template<typename T>
+class atomic_strong_ptr
+{
+public:
+  using value_type = strong_ptr<T>;
+
+  static constexpr bool is_always_lock_free = false;
+
+  /**
+   * @brief Create with an initial value
+   *
+   * @param p_value - initial value, atomic_strong_ptr is never null
+   */
+  explicit atomic_strong_ptr(strong_ptr<T> const& p_value) noexcept
+    : m_instances{ p_value, p_value }
+  {
+    static_assert(thread_safe_ref_count_for<T>,
+                  "atomic_strong_ptr requires LIBHAL_STRONG_PTR_THREAD_SAFE");
+  }
+
+  atomic_strong_ptr(atomic_strong_ptr const&) = delete;
+  atomic_strong_ptr& operator=(atomic_strong_ptr const&) = delete;
+  atomic_strong_ptr(atomic_strong_ptr&&) = delete;
+  atomic_strong_ptr& operator=(atomic_strong_ptr&&) = delete;
+  ~atomic_strong_ptr() = default;
+
+  /**
+   * @brief Get the current value
+   *
+   * Wait-free.
+   *
+   * @return strong_ptr<T> - the current value
+   */
+  [[nodiscard]] strong_ptr<T> load() const noexcept
+  {
+    auto const version = m_version.load();
+    m_readers[version].fetch_add(1);
+    strong_ptr<T> result = m_instances[m_left_right.load()];
+    if (m_readers[version].fetch_sub(1) == 1) {
+      // The last reader to leave wakes a writer waiting on the indicator
+      m_readers[version].notify_one();
+    }
+    return result;
+  }
+
+  /**
+   * @brief Get the current value
+   *
+   * @return strong_ptr<T> - the current value
+   */
+  operator strong_ptr<T>() const noexcept
+  {
+    return load();
+  }
+
+  /**
+   * @brief Replace the current value
+   *
+   * @param p_desired - new value
+   */
+  void store(strong_ptr<T> const& p_desired) noexcept
+  {
+    [[maybe_unused]] auto previous = exchange(p_desired);
+  }
+
+  /**
+   * @brief Replace the current value and return the previous value
+   *
+   * @param p_desired - new value
+   * @return strong_ptr<T> - the value that was replaced
+   */
+  [[nodiscard]] strong_ptr<T> exchange(strong_ptr<T> const& p_desired) noexcept
+  {
+    writer_lock lock(m_writer);
+    return publish(p_desired);
+  }
+
+  /**
+   * @brief Replace the current value only if it points to the expected object
+   *
+   * @param p_expected - the expected value, updated to the current value on
+   * failure
+   * @param p_desired - new value
+   * @return true - the value was replaced by p_desired
+   * @return false - the value did not point to the expected object
+   */
+  bool compare_exchange_strong(strong_ptr<T>& p_expected,
+                               strong_ptr<T> const& p_desired) noexcept
+  {
+    writer_lock lock(m_writer);
+    // Only writers modify the left-right index and they are serialized
+    auto const& current = m_instances[m_left_right.load()];
+    if (current.operator->() != p_expected.operator->()) {
+      p_expected = current;
+      return false;
+    }
+    [[maybe_unused]] auto previous = publish(p_desired);
+    return true;
+  }
+
+  /**
+   * @brief Same as compare_exchange_strong, never fails spuriously
+   *
+   * @param p_expected - the expected value, updated to the current value on
+   * failure
+   * @param p_desired - new value
+   * @return true - the value was replaced by p_desired
+   * @return false - the value did not point to the expected object
+   */
+  bool compare_exchange_weak(strong_ptr<T>& p_expected,
+                             strong_ptr<T> const& p_desired) noexcept
+  {
+    return compare_exchange_strong(p_expected, p_desired);
+  }
+
+private:
+  class writer_lock
+  {
+  public:
+    explicit writer_lock(std::atomic_flag& p_flag) noexcept
+      : m_flag(p_flag)
+    {
+      while (m_flag.test_and_set(std::memory_order_acquire)) {
+        m_flag.wait(true, std::memory_order_relaxed);
+      }
+    }
+
+    writer_lock(writer_lock const&) = delete;
+    writer_lock& operator=(writer_lock const&) = delete;
+    writer_lock(writer_lock&&) = delete;
+    writer_lock& operator=(writer_lock&&) = delete;
+
+    ~writer_lock()
+    {
+      m_flag.clear(std::memory_order_release);
+      m_flag.notify_one();
+    }
+
+  private:
+    std::atomic_flag& m_flag;
+  };
+
+  void wait_for_readers(std::size_t p_version) const noexcept
+  {
+    // Block rather than spin, a writer that preempted a reader on a single
+    // core would otherwise never let that reader leave
+    auto readers = m_readers[p_version].load();
+    while (readers != 0) {
+      m_readers[p_version].wait(readers);
+      readers = m_readers[p_version].load();
+    }
+  }
+
+  // Must be called with the writer lock held. All operations on the indices
+  // and reader indicators are sequentially consistent, as the algorithm
+  // requires.
+  strong_ptr<T> publish(strong_ptr<T> const& p_desired) noexcept
+  {
+    auto const left_right = m_left_right.load();
+    auto const other = 1 - left_right;
+
+    // No reader can be reading the other instance, the previous writer waited
+    // for all of them to leave.
+    m_instances[other] = p_desired;
+    m_left_right.store(other);
+
+    // Wait for readers that may still be on the previous instance
+    auto const version = m_version.load();
+    auto const next_version = 1 - version;
+    wait_for_readers(next_version);
+    m_version.store(next_version);
+    wait_for_readers(version);
+
+    strong_ptr<T> previous = m_instances[left_right];
+    m_instances[left_right] = p_desired;
+    return previous;
+  }
+
+  std::array<strong_ptr<T>, 2> m_instances;
+  std::atomic<std::size_t> m_left_right = 0;
+  std::atomic<std::size_t> m_version = 0;
+  mutable std::array<std::atomic<std::size_t>, 2> m_readers{};
+  std::atomic_flag m_writer{};
+};
+
+template<typename T>
+class optional_ptr;
+
+/**
+ * @brief A weak reference to a strong_ptr
+ *
+ * weak_ptr provides a non-owning reference to an object managed by strong_ptr.
+ * It can be used to break reference cycles or to create an optional_ptr.
+ *
+ * A weak_ptr doesn't increase the strong reference count, so it doesn't
+ * prevent the object from being destroyed when the last strong_ptr goes away.
+ *
+ * Example usage:
+ * ```
+ * // Create a strong_ptr to an object
+ * auto ptr = mem::make_strong_ptr<my_driver>(allocator, args...);
+ *
+ * // Create a weak reference
+ * weak_ptr<my_driver> weak = ptr;
+ *
+ * // Later, try to get a strong reference
+ * if (auto locked = weak.lock()) {
+ *   // Use the object via locked
+ *   locked->do_something();
+ * } else {
+ *   // Object has been destroyed
+ * }
+ * ```
+ *
+ * @tparam T The type of the referenced object
+ */
+template<typename T>
+class weak_ptr
+{
+public:
+  template<typename U>
+  friend class strong_ptr;
+
+  template<typename U>
+  friend class weak_ptr;
+
+  friend struct strong_ptr_factory;
+
+  using element_type = std::remove_extent_t<T>;
+
+  /**
+   * @brief Default constructor creates empty weak_ptr
+   */
+  weak_ptr() noexcept = default;
+
+  /**
+   * @brief Create weak_ptr from strong_ptr
+   *
+   * @param p_strong The strong_ptr to create a weak reference to
+   */
+  constexpr weak_ptr(strong_ptr<T> const& p_strong) noexcept
+    : m_ctrl(p_strong.m_ctrl)
+    , m_ptr(p_strong.m_ptr)
+  {
+    if (m_ctrl) {
+      m_ctrl->add_weak<T>();
+    }
+  }
+
+  /**
+   * @brief Copy constructor
+   *
+   * @param p_other The weak_ptr to copy from
+   */
+  constexpr weak_ptr(weak_ptr const& p_other) noexcept
+    : m_ctrl(p_other.m_ctrl)
+    , m_ptr(p_other.m_ptr)
+  {
+    if (m_ctrl) {
+      m_ctrl->add_weak<T>();
+    }
+  }
+
+  /**
+   * @brief Move constructor
+   *
+   * @param p_other The weak_ptr to move from
+   */
+  constexpr weak_ptr(weak_ptr&& p_other) noexcept
+    : m_ctrl(p_other.m_ctrl)
+    , m_ptr(p_other.m_ptr)
+  {
+    p_other.m_ctrl = nullptr;
+    p_other.m_ptr = nullptr;
+  }
+
+  /**
+   * @brief Converting copy constructor
+   *
+   * Creates a weak_ptr of T from a weak_ptr of U where U is convertible to T.
+   *
+   * @tparam U A type convertible to T
+   * @param p_other The weak_ptr to copy from
+   */
+  template<typename U>
+  constexpr weak_ptr(weak_ptr<U> const& p_other) noexcept
+    requires(std::is_convertible_v<U*, T*>)
+    : m_ctrl(p_other.m_ctrl)
+    , m_ptr(static_cast<T*>(p_other.m_ptr))
+  {
+    if (m_ctrl) {
+      m_ctrl->add_weak<T>();
+    }
+  }
+
+  /**
+   * @brief Converting move constructor
+   *
+   * Moves a weak_ptr of U to a weak_ptr T where U is convertible to T.
+   *
+   * @tparam U A type convertible to T
+   * @param p_other The weak_ptr to move from. Moved from weak_ptr's are
+   * considered expired.
+   */
+  template<typename U>
+  constexpr weak_ptr(weak_ptr<U>&& p_other) noexcept
+    requires(std::is_convertible_v<U*, T*>)
+    : m_ctrl(p_other.m_ctrl)
+    , m_ptr(static_cast<T*>(p_other.m_ptr))
+  {
+    p_other.m_ctrl = nullptr;
+    p_other.m_ptr = nullptr;
+  }
+
+  /**
+   * @brief Converting constructor from strong_ptr
+   *
+   * Creates a weak_ptr<T> from a strong_ptr where U is convertible to T.
+   *
+   * @tparam U A type convertible to T
+   * @param p_other The strong_ptr to create a weak reference to
+   */
+  template<typename U>
+  constexpr weak_ptr(strong_ptr<U> const& p_other) noexcept
+    requires(std::is_convertible_v<U*, T*>)
+    : m_ctrl(p_other.m_ctrl)
+    , m_ptr(static_cast<T*>(p_other.m_ptr))
+  {
+    if (m_ctrl) {
+      m_ctrl->add_weak<T>();
+    }
+  }
+
+  /**
+   * @brief Destructor
+   *
+   * Decrements the weak reference count and potentially deallocates
+   * memory if this was the last reference.
+   */
+  ~weak_ptr()
+  {
+    if (m_ctrl) {
+      m_ctrl->release_weak<T>();
+    }
+  }
+
+  /**
+   * @brief Copy assignment operator
+   *
+   * @param p_other The weak_ptr to copy from
+   * @return Reference to *this
+   */
+  constexpr weak_ptr& operator=(weak_ptr const& p_other) noexcept
+  {
+    weak_ptr(p_other).swap(*this);
+    return *this;
+  }
+
+  /**
+   * @brief Move assignment operator
+   *
+   * @param p_other The weak_ptr to move from
+   * @return Reference to *this
+   */
+  constexpr weak_ptr& operator=(weak_ptr&& p_other) noexcept
+  {
+    weak_ptr(std::move(p_other)).swap(*this);
+    return *this;
+  }
+
+  /**
+   * @brief Assignment from strong_ptr
+   *
+   * @param p_strong The strong_ptr to create a weak reference to
+   * @return Reference to *this
+   */
+  constexpr weak_ptr& operator=(strong_ptr<T> const& p_strong) noexcept
+  {
+    weak_ptr(p_strong).swap(*this);
+    return *this;
+  }
+
+  /**
+   * @brief Swap the contents of this weak_ptr with another
+   *
+   * @param p_other The weak_ptr to swap with
+   */
+  constexpr void swap(weak_ptr& p_other) noexcept
+  {
+    std::swap(m_ctrl, p_other.m_ctrl);
+    std::swap(m_ptr, p_other.m_ptr);
+  }
+
+  /**
+   * @brief Check if the referenced object has been destroyed
+   *
+   * @return true if the object has been destroyed, false otherwise
+   */
+  [[nodiscard]] constexpr bool expired() const noexcept
+  {
+    if (m_ptr == nullptr) {
+      return true;
+    }
+
+    if (m_ctrl != nullptr) {
+      return m_ctrl->use_count() == 0;
+    }
+
+    // If m_ptr != nullptr && m_ctrl == nullptr (static object), return false,
+    // because that object will always exist.
+    return false;
+  }
+
+  /**
+   * @brief Attempt to obtain a strong_ptr to the referenced object
+   *
+   * If the object still exists, returns an optional_ptr containing
+   * a strong_ptr to it. Otherwise, returns an empty optional_ptr.
+   *
+   * @return An optional_ptr that is either empty or contains a strong_ptr
+   */
+  [[nodiscard]] constexpr optional_ptr<T> lock() const noexcept;
+
+  /**
+   * @brief Attempt to obtain a strong_ptr without going through optional_ptr
+   *
+   * On success `p_out` is replaced with a strong reference to the object and
+   * the reference previously held by `p_out` is released. On failure `p_out`
+   * is left untouched.
+   *
+   * @param p_out destination for the strong reference
+   * @return true if the object still exists and `p_out` now references it
+   */
+  [[nodiscard]] constexpr bool try_lock(strong_ptr<T>& p_out) const noexcept
+  {
+    if (not pin()) {
+      return false;
+    }
+    strong_ptr<T>(m_ctrl, m_ptr).swap(p_out);
+    return true;
+  }
+
+  /**
+   * @brief Call a function with the referenced object if it still exists
+   *
+   * The object is kept alive only for the duration of the call, which avoids
+   * constructing an optional_ptr when the caller never keeps the pointer.
+   * The reference taken is released even if `p_visitor` throws.
+   *
+   * Example usage:
+   * ```
+   * for (auto const& listener : listeners) {
+   *   listener.visit([&](my_listener& p_listener) { p_listener.notify(); });
+   * }
+   * ```
+   *
+   * @tparam Visitor callable invocable with `T&`
+   * @param p_visitor the function to call with the object
+   * @return true if the object still existed and `p_visitor` was invoked
+   */
+  template<typename Visitor>
+  constexpr bool visit(Visitor&& p_visitor) const
+    noexcept(std::is_nothrow_invocable_v<Visitor, T&>)
+    requires(std::is_invocable_v<Visitor, T&>)
+  {
+    if (not pin()) {
+      return false;
+    }
+    // Adopts the reference acquired by pin()
+    strong_ptr<T> const pinned(m_ctrl, m_ptr);
+    std::invoke(std::forward<Visitor>(p_visitor), *m_ptr);
+    return true;
+  }
+
+  /**
+   * @brief Get the current strong reference count
+   *
+   * This is primarily for testing purposes.
+   *
+   * @return The number of strong references to the managed object
+   */
+  [[nodiscard]] constexpr auto use_count() const noexcept
+  {
+    return m_ctrl ? m_ctrl->use_count() : 0;
+  }
+
+  /**
+   * @brief Order by owning control block rather than by pointed to object
+   *
+   * Aliases of the same object, such as a strong_ptr to a member, share an
+   * owner and are equivalent under this ordering. Objects with static storage
+   * duration have no control block and are ordered by the address held.
+   *
+   * @param p_other - strong_ptr to compare ownership with
+   * @return true if this owner is ordered before the owner of p_other
+   */
+  template<typename U>
+  [[nodiscard]] constexpr bool owner_before(
+    strong_ptr<U> const& p_other) const noexcept
+  {
+    return std::less<>{}(owner_key(), p_other.owner_key());
+  }
+
+  /**
+   * @brief Order by owning control block rather than by pointed to object
+   *
+   * @param p_other - weak_ptr to compare ownership with
+   * @return true if this owner is ordered before the owner of p_other
+   */
+  template<typename U>
+  [[nodiscard]] constexpr bool owner_before(
+    weak_ptr<U> const& p_other) const noexcept
+  {
+    return std::less<>{}(owner_key(), p_other.owner_key());
+  }
+
+  /**
+   * @brief Check if both share the same owning control block
+   *
+   * @param p_other - strong_ptr to compare ownership with
+   * @return true if both have the same owner
+   */
+  template<typename U>
+  [[nodiscard]] constexpr bool owner_equal(
+    strong_ptr<U> const& p_other) const noexcept
+  {
+    return owner_key() == p_other.owner_key();
+  }
+
+  /**
+   * @brief Check if both share the same owning control block
+   *
+   * @param p_other - weak_ptr to compare ownership with
+   * @return true if both have the same owner
+   */
+  template<typename U>
+  [[nodiscard]] constexpr bool owner_equal(
+    weak_ptr<U> const& p_other) const noexcept
+  {
+    return owner_key() == p_other.owner_key();
+  }
+
+  /**
+   * @brief Hash of the owning control block, consistent with `owner_equal()`
+   *
+   * The value does not change when the object expires, so it remains valid as a
+   * key for as long as the weak_ptr is held.
+   *
+   * @return std::size_t - hash of the owner
+   */
+  [[nodiscard]] std::size_t owner_hash() const noexcept
+  {
+    return std::hash<void const*>{}(owner_key());
+  }
+
+private:
+  // Identifies the owner for owner_before(), owner_equal() and owner_hash().
+  // Objects with static storage duration have no control block, so their
+  // address stands in for it.
+  [[nodiscard]] constexpr void const* owner_key() const noexcept
+  {
+    if (m_ctrl != nullptr) {
+      return m_ctrl;
+    }
+    return m_ptr;
+  }
+
+  // Acquire a strong reference if the object is still alive. This is a single
+  // atomic step so a concurrent release of the last strong reference cannot be
+  // observed half way through. Objects with static storage duration are never
+  // destroyed and need no reference.
+  constexpr bool pin() const noexcept
+  {
+    if (m_ptr == nullptr) {
+      return false;
+    }
+    if (m_ctrl == nullptr) {
+      return true;
+    }
+    return m_ctrl->try_add_ref<T>();
+  }
+
+  ref_info* m_ctrl = nullptr;
+  T* m_ptr = nullptr;
+};
+
+// Detect the results of the functions passed to optional_ptr's monadic
+// operations
+template<typename T>
+struct strong_ptr_pointee
+{};
+
+template<typename T>
+struct strong_ptr_pointee<strong_ptr<T>>
+{
+  using type = T;
+};
+
+template<typename T>
+constexpr bool is_strong_ptr =
+  requires { typename strong_ptr_pointee<T>::type; };
+
+template<typename T>
+constexpr bool is_optional_ptr = false;
+
+template<typename T>
+constexpr bool is_optional_ptr<optional_ptr<T>> = true;
+
+/**
+ * @brief Optional, nullable, smart pointer that works with `mem::strong_ptr`.
+ *
+ * optional_ptr provides a way to represent a strong_ptr that may or may not
+ * be present. Unlike strong_ptr, which is always valid, optional_ptr can be
+ * in a "disengaged" state where it doesn't reference any object.
+ *
+ * Use optional_ptr when you need a nullable reference to a reference-counted
+ * object, such as:
+ * - Representing the absence of a value
+ * - Return values from functions that may fail
+ * - Results of locking a weak_ptr
+ *
+ * Example usage:
+ * ```
+ * // Create an empty optional_ptr
+ * optional_ptr<my_driver> opt1;
+ *
+ * // Create an optional_ptr from a strong_ptr
+ * auto ptr = make_strong_ptr<my_driver>(allocator, args...);
+ * optional_ptr<my_driver> opt2 = ptr;
+ *
+ * // Check if the optional_ptr is engaged
+ * if (opt2) {
+ *   // Use the contained object
+ *   opt2->do_something();
+ * }
+ *
+ * // Reset to disengage
+ * opt2.reset();
+ *
+ * // Chain lookups without copying any intermediate strong_ptr
+ * optional_ptr<my_sensor> sensor =
+ *   find_bus(id)
+ *     .and_then([](strong_ptr<my_bus> const& p_bus) {
+ *       return p_bus->find(0x13);
+ *     })
+ *     .or_else([] { return fallback_sensor(); });
+ * ```
+ *
+ * @tparam T - The type pointed to by strong_ptr
+ */
+template<typename T>
+class optional_ptr
+{
+public:
+  using element_type = std::remove_extent_t<T>;
+  using weak_type = weak_ptr<T>;
+
+  /**
+   * @brief Default constructor creates a disengaged optional
+   */
+  constexpr optional_ptr() noexcept
+  {
+  }
+
+  /**
+   * @brief Constructor for nullptr (creates a disengaged optional)
+   */
+  constexpr optional_ptr(std::nullptr_t) noexcept
+  {
+  }
+
+  /**
+   * @brief Move constructor
+   *
+   * Transfers the reference held by p_other to this object without modifying
+   * the reference count. p_other is left disengaged.
+   *
+   * @param p_other The optional_ptr to move from
+   */
+  constexpr optional_ptr(optional_ptr&& p_other) noexcept
+  {
+    adopt(p_other);
+  }
+
+  /**
+   * @brief Converting move constructor
+   *
+   * Transfers the reference held by p_other to this object without modifying
+   * the reference count. p_other is left disengaged.
+   *
+   * @tparam U A type convertible to T
+   * @param p_other The optional_ptr to move from
+   */
+  template<typename U>
+  constexpr optional_ptr(optional_ptr<U>&& p_other) noexcept
+    requires(std::is_convertible_v<U*, T*>)
+  {
+    adopt(p_other);
+  }
+
+  /**
+   * @brief Construct from a strong_ptr lvalue
+   *
+   * @param value The strong_ptr to wrap
+   */
+  constexpr optional_ptr(strong_ptr<T> const& value) noexcept
+    : m_value(value)
+  {
+  }
+
+  /**
+   * @brief Copy constructor
+   *
+   * @param p_other The optional_ptr to copy from
+   */
+  constexpr optional_ptr(optional_ptr const& p_other)
+  {
+    *this = p_other;
+  }
+
+  /**
+   * @brief Converting constructor from a strong_ptr
+   *
+   * @tparam U A type convertible to T
+   * @param p_value The strong_ptr to wrap
+   */
+  template<typename U>
+  constexpr optional_ptr(strong_ptr<U> const& p_value)
+    requires(std::is_convertible_v<U*, T*>)
+  {
+    *this = p_value;
+  }
+
+  /**
+   * @brief Move assignment operator
+   *
+   * Releases the currently held reference, if any, then transfers the
+   * reference held by p_other to this object without modifying its reference
+   * count. p_other is left disengaged.
+   *
+   * @param p_other The optional_ptr to move from
+   * @return Reference to *this
+   */
+  constexpr optional_ptr& operator=(optional_ptr&& p_other) noexcept
+  {
+    if (this != &p_other) {
+      reset();
+      adopt(p_other);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Converting move assignment operator
+   *
+   * @tparam U A type convertible to T
+   * @param p_other The optional_ptr to move from
+   * @return Reference to *this
+   */
+  template<typename U>
+  constexpr optional_ptr& operator=(optional_ptr<U>&& p_other) noexcept
+    requires(std::is_convertible_v<U*, T*>)
+  {
+    reset();
+    adopt(p_other);
+    return *this;
+  }
+
+  /**
+   * @brief Copy assignment operator
+   *
+   * @param other The optional_ptr to copy from
+   * @return Reference to *this
+   */
+  constexpr optional_ptr& operator=(optional_ptr const& other)
+  {
+    // A disengaged optional_ptr holds a null strong_ptr, which strong_ptr
+    // assignment already treats as holding no reference
+    m_value = other.m_value;
+    return *this;
+  }
+
+  /**
+   * @brief Assignment from a strong_ptr
+   *
+   * @param value The strong_ptr to wrap
+   * @return Reference to *this
+   */
+  constexpr optional_ptr& operator=(strong_ptr<T> const& value) noexcept
+  {
+    m_value = value;
+    return *this;
+  }
+
+  /**
+   * @brief Converting assignment from a strong_ptr
+   *
+   * @tparam U A type convertible to T
+   * @param p_value The strong_ptr to wrap
+   * @return Reference to *this
+   */
+  template<typename U>
+  constexpr optional_ptr& operator=(strong_ptr<U> const& p_value) noexcept
+    requires(std::is_convertible_v<U*, T*>)
+  {
+    m_value = p_value;
+    return *this;
+  }
+
+  /**
+   * @brief Assignment from nullptr (resets to disengaged state)
+   *
+   * @return Reference to *this
+   */
+  constexpr optional_ptr& operator=(std::nullptr_t) noexcept
+  {
+    reset();
+    return *this;
+  }
+
+  /**
+   * @brief Destructor
+   *
+   * Releases the contained strong_ptr if engaged.
+   */
+  constexpr ~optional_ptr() = default;
+
+  /**
+   * @brief Check if the optional_ptr is engaged
+   *
+   * @return true if the optional_ptr contains a value, false otherwise
+   */
+  [[nodiscard]] constexpr bool has_value() const noexcept
+  {
+    return is_engaged();
+  }
+
+  /**
+   * @brief Check if the optional_ptr is engaged
+   *
+   * @return true if the optional_ptr contains a value, false otherwise
+   */
+  constexpr explicit operator bool() const noexcept
+  {
+    return is_engaged();
+  }
+
+  /**
+   * @brief Access the contained value, throw if not engaged
+   *
+   * @return A copy of the contained strong_ptr
+   * @throws mem::nullptr_access if *this is disengaged
+   */
+  [[nodiscard]] constexpr strong_ptr<T>& value()
+  {
+    if (not is_engaged()) {
+      throw_nullptr_access();
+    }
+    return m_value;
+  }
+
+  /**
+   * @brief Access the contained value, throw if not engaged (const version)
+   *
+   * @return A copy of the contained strong_ptr
+   * @throws mem::nullptr_access if *this is disengaged
+   */
+  [[nodiscard]] constexpr strong_ptr<T> const& value() const
+  {
+    if (not is_engaged()) {
+      throw_nullptr_access();
+    }
+    return m_value;
+  }
+
+  /**
+   * @brief Implicitly convert to a strong_ptr<T>
+   *
+   * This allows optional_ptr to be used anywhere a strong_ptr is expected
+   * when the optional_ptr is engaged.
+   *
+   * @return A copy of the contained strong_ptr
+   * @throws mem::nullptr_access if *this is disengaged
+   */
+  [[nodiscard]] constexpr operator strong_ptr<T>() &
+  {
+    return value();
+  }
+
+  /**
+   * @brief Implicitly convert to a strong_ptr<T> (const version)
+   *
+   * @return A copy of the contained strong_ptr
+   * @throws mem::nullptr_access if *this is disengaged
+   */
+  [[nodiscard]] constexpr operator strong_ptr<T>() const&
+  {
+    return value();
+  }
+
+  /**
+   * @brief Convert an rvalue optional_ptr into a strong_ptr<T>
+   *
+   * The reference held by this optional_ptr is transferred to the returned
+   * strong_ptr without modifying the reference count, leaving this object
+   * disengaged. This makes `strong_ptr<T> ptr = weak.lock();` and
+   * `strong_ptr<T> ptr = std::move(opt);` free of reference count traffic.
+   *
+   * @return The contained strong_ptr
+   * @throws mem::nullptr_access if *this is disengaged
+   */
+  [[nodiscard]] constexpr operator strong_ptr<T>() &&
+  {
+    return release_strong<T>();
+  }
+
+  /**
+   * @brief Implicitly convert to a strong_ptr for polymorphic types
+   *
+   * This allows optional_ptr<Derived> to be converted to strong_ptr<Base>
+   * when Derived is convertible to Base.
+   *
+   * @tparam U The target type (must be convertible from T)
+   * @return A copy of the contained strong_ptr, converted to the target type
+   * @throws mem::nullptr_access if *this is disengaged
+   */
+  template<typename U>
+  [[nodiscard]] constexpr operator strong_ptr<U>() &
+    requires(std::is_convertible_v<T*, U*> && not std::is_same_v<T, U>)
+  {
+    if (not is_engaged()) {
+      throw_nullptr_access();
+    }
+    // strong_ptr handles the polymorphic conversion
+    return strong_ptr<U>(m_value);
+  }
+
+  /**
+   * @brief Implicitly convert to a strong_ptr for polymorphic types (const
+   * version)
+   *
+   * @tparam U The target type (must be convertible from T)
+   * @return A copy of the contained strong_ptr, converted to the target type
+   * @throws mem::nullptr_access if *this is disengaged
+   */
+  template<typename U>
+  [[nodiscard]] constexpr operator strong_ptr<U>() const&
+    requires(std::is_convertible_v<T*, U*> && not std::is_same_v<T, U>)
+  {
+    if (not is_engaged()) {
+      throw_nullptr_access();
+    }
+    // strong_ptr handles the polymorphic conversion
+    return strong_ptr<U>(m_value);
+  }
+
+  /**
+   * @brief Convert an rvalue optional_ptr into a strong_ptr for polymorphic
+   * types
+   *
+   * The reference is transferred without modifying the reference count,
+   * leaving this object disengaged.
+   *
+   * @tparam U The target type (must be convertible from T)
+   * @return The contained strong_ptr, converted to the target type
+   * @throws mem::nullptr_access if *this is disengaged
+   */
+  template<typename U>
+  [[nodiscard]] constexpr operator strong_ptr<U>() &&
+    requires(std::is_convertible_v<T*, U*> && not std::is_same_v<T, U>)
+  {
+    return release_strong<U>();
+  }
+
+  /**
+   * @brief Arrow operator for accessing members of the contained object
+   *
+   * @return Pointer to the object managed by the contained strong_ptr
+   */
+  [[nodiscard]] constexpr auto* operator->()
+  {
+    auto& ref = *(this->value());
+    return &ref;
+  }
+
+  /**
+   * @brief Arrow operator for accessing members of the contained object (const
+   * version)
+   *
+   * @return Pointer to the object managed by the contained strong_ptr
+   */
+  [[nodiscard]] constexpr auto* operator->() const
+  {
+    auto& ref = *(this->value());
+    return &ref;
+  }
+
+  /**
+   * @brief Dereference operator for accessing the contained object
+   *
+   * @return Reference to the object managed by the contained strong_ptr
+   */
+  [[nodiscard]] constexpr auto& operator*()
+  {
+    auto& ref = *(this->value());
+    return ref;
+  }
+
+  /**
+   * @brief Dereference operator for accessing the contained object (const
+   * version)
+   *
+   * @return Reference to the object managed by the contained strong_ptr
+   */
+  [[nodiscard]] constexpr auto& operator*() const
+  {
+    auto& ref = *(this->value());
+    return ref;
+  }
+
+  /**
+   * @brief Reset the optional to a disengaged state
+   */
+  constexpr void reset() noexcept
+  {
+    m_value.release();
+    m_value.m_ctrl = nullptr;
+    m_value.m_ptr = nullptr;
+  }
+
+  /**
+   * @brief Emplace a new value
+   *
+   * Reset the optional and construct a new strong_ptr in-place.
+   *
+   * @tparam Args Types of arguments to forward to the constructor
+   * @param args Arguments to forward to the constructor
+   * @return Reference to the newly constructed strong_ptr
+   */
+  template<typename... Args>
+  constexpr strong_ptr<T>& emplace(Args&&... args)
+  {
+    // The previous value is released by the temporary
+    strong_ptr<T>(std::forward<Args>(args)...).swap(m_value);
+    return m_value;
+  }
+
+  /**
+   * @brief Get the current reference count
+   *
+   * This is primarily for testing purposes. To determine if an optional_ptr
+   * points to a statically allocated object, this API must return 0 and
+   * `is_engaged()` must return true.
+   *
+   * @return The number of strong references to the managed object. Returns 0 if
+   * this pointer is nullptr.
+   */
+  [[nodiscard]] constexpr auto use_count() const noexcept
+  {
+    return is_engaged() ? m_value.use_count() : 0;
+  }
+
+  /**
+   * @brief Call a function returning an optional_ptr with the contained value
+   *
+   * The contained strong_ptr is passed by reference, so no reference is added
+   * unless the function itself creates a new handle.
+   *
+   * @tparam F callable with `strong_ptr<T>&` returning any optional_ptr
+   * @param p_function the function to call if engaged
+   * @return the result of p_function, or a disengaged optional_ptr of the same
+   * type if *this is disengaged
+   */
+  template<typename F>
+  constexpr auto and_then(F&& p_function) &
+  {
+    return and_then_impl(*this, std::forward<F>(p_function));
+  }
+
+  /**
+   * @brief Call a function returning an optional_ptr with the contained value
+   * (const version)
+   *
+   * @tparam F callable with `strong_ptr<T> const&` returning any optional_ptr
+   * @param p_function the function to call if engaged
+   * @return the result of p_function, or a disengaged optional_ptr of the same
+   * type if *this is disengaged
+   */
+  template<typename F>
+  constexpr auto and_then(F&& p_function) const&
+  {
+    return and_then_impl(*this, std::forward<F>(p_function));
+  }
+
+  /**
+   * @brief Call a function returning a strong_ptr with the contained value
+   *
+   * The contained strong_ptr is passed by reference and the strong_ptr
+   * returned by p_function is adopted by the result without adding another
+   * reference.
+   *
+   * @tparam F callable with `strong_ptr<T> const&` returning any strong_ptr
+   * @param p_function the function to call if engaged
+   * @return optional_ptr holding the result of p_function, or disengaged if
+   * *this is disengaged
+   */
+  template<typename F>
+  constexpr auto transform(F&& p_function) const
+  {
+    using result_t =
+      std::remove_cvref_t<std::invoke_result_t<F, strong_ptr<T> const&>>;
+    static_assert(is_strong_ptr<result_t>,
+                  "The function passed to transform must return a strong_ptr");
+    optional_ptr<typename strong_ptr_pointee<result_t>::type> result;
+    if (is_engaged()) {
+      result_t value = std::invoke(std::forward<F>(p_function), m_value);
+      result.m_value.swap(value);
+    }
+    return result;
+  }
+
+  /**
+   * @brief Return *this if engaged, otherwise the result of a function
+   *
+   * @tparam F callable with no arguments returning an optional_ptr<T>
+   * @param p_function the function to call if disengaged
+   * @return optional_ptr<T> - a copy of *this or the result of p_function
+   */
+  template<typename F>
+  constexpr optional_ptr or_else(F&& p_function) const&
+  {
+    static_assert(
+      std::is_convertible_v<std::invoke_result_t<F>, optional_ptr>,
+      "The function passed to or_else must return an optional_ptr<T>");
+    if (is_engaged()) {
+      return *this;
+    }
+    return std::invoke(std::forward<F>(p_function));
+  }
+
+  /**
+   * @brief Return *this if engaged, otherwise the result of a function
+   *
+   * The reference held by *this is transferred to the result without
+   * modifying the reference count.
+   *
+   * @tparam F callable with no arguments returning an optional_ptr<T>
+   * @param p_function the function to call if disengaged
+   * @return optional_ptr<T> - *this or the result of p_function
+   */
+  template<typename F>
+  constexpr optional_ptr or_else(F&& p_function) &&
+  {
+    static_assert(
+      std::is_convertible_v<std::invoke_result_t<F>, optional_ptr>,
+      "The function passed to or_else must return an optional_ptr<T>");
+    if (is_engaged()) {
+      return std::move(*this);
+    }
+    return std::invoke(std::forward<F>(p_function));
+  }
+
+  /**
+   * @brief Get the contained strong_ptr or a default
+   *
+   * @param p_default returned if *this is disengaged
+   * @return strong_ptr<T> - copy of the contained value or of p_default
+   */
+  [[nodiscard]] constexpr strong_ptr<T> value_or(
+    strong_ptr<T> const& p_default) const&
+  {
+    return is_engaged() ? m_value : p_default;
+  }
+
+  /**
+   * @brief Get the contained strong_ptr or a default
+   *
+   * The reference held by *this is transferred to the result without
+   * modifying the reference count, leaving *this disengaged.
+   *
+   * @param p_default returned if *this is disengaged
+   * @return strong_ptr<T> - the contained value or a copy of p_default
+   */
+  [[nodiscard]] constexpr strong_ptr<T> value_or(
+    strong_ptr<T> const& p_default) &&
+  {
+    if (is_engaged()) {
+      return release_strong<T>();
+    }
+    return p_default;
+  }
+
+  /**
+   * @brief Swap the contents of this optional_ptr with another
+   *
+   * @param other The optional_ptr to swap with
+   */
+  constexpr void swap(optional_ptr& other) noexcept
+  {
+    optional_ptr temp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(temp);
+  }
+
+private:
+  template<typename U>
+  friend class optional_ptr;
+
+  template<typename U>
+  friend class weak_ptr;
+
+  friend struct strong_ptr_factory;
+
+  template<typename Self, typename F>
+  static constexpr auto and_then_impl(Self& p_self, F&& p_function)
+  {
+    using result_t =
+      std::remove_cvref_t<std::invoke_result_t<F, decltype((p_self.m_value))>>;
+    static_assert(
+      is_optional_ptr<result_t>,
+      "The function passed to and_then must return an optional_ptr");
+    if (p_self.is_engaged()) {
+      return result_t(std::invoke(std::forward<F>(p_function), p_self.m_value));
+    }
+    return result_t{};
+  }
+
+  // Internal constructor used by weak_ptr::lock() and try_make_strong_ptr.
+  // Adopts a strong reference that the caller has already accounted for in
+  // the control block.
+  constexpr optional_ptr(ref_info* p_ctrl, T* p_ptr) noexcept
+    : m_value(p_ctrl, p_ptr)
+  {
+  }
+
+  /**
+   * @brief Take ownership of the reference held by p_other
+   *
+   * *this must be disengaged. The reference count is unchanged and p_other is
+   * left disengaged without running the strong_ptr destructor, as ownership of
+   * the reference now belongs to *this.
+   *
+   * @tparam U A type convertible to T
+   * @param p_other The optional_ptr to take the reference from
+   */
+  template<typename U>
+  constexpr void adopt(optional_ptr<U>& p_other) noexcept
+  {
+    m_value.m_ctrl = p_other.m_value.m_ctrl;
+    m_value.m_ptr = static_cast<T*>(p_other.m_value.m_ptr);
+    p_other.m_value.m_ctrl = nullptr;
+    p_other.m_value.m_ptr = nullptr;
+  }
+
+  /**
+   * @brief Transfer the held reference into a strong_ptr<U>
+   *
+   * @tparam U The target type (must be convertible from T)
+   * @return strong_ptr<U> - owns the reference previously held by *this
+   * @throws mem::nullptr_access if *this is disengaged
+   */
+  template<typename U>
+  constexpr strong_ptr<U> release_strong()
+  {
+    if (not is_engaged()) {
+      throw_nullptr_access();
+    }
+    auto* ctrl = m_value.m_ctrl;
+    auto* ptr = m_value.m_ptr;
+    m_value.m_ctrl = nullptr;
+    m_value.m_ptr = nullptr;
+    return strong_ptr<U>(ctrl, static_cast<U*>(ptr));
+  }
+
+  /**
+   * @brief The contained strong_ptr, null when disengaged
+   *
+   * Disengaged optional_ptrs hold a strong_ptr whose control block and object
+   * pointers are both null. strong_ptr never releases or adds a reference
+   * without a control block, so the member is always alive and may be used in
+   * constant expressions, unlike a union with an inactive member.
+   */
+  strong_ptr<T> m_value{ static_cast<ref_info*>(nullptr), nullptr };
+
+  // Ensure the strong_ptr layout matches our expectations
+  static_assert(sizeof(strong_ptr<T>) == 2 * sizeof(void*),
+                "strong_ptr must be exactly the size of two pointers");
+
+  /**
+   * @brief Helper to check if the optional is engaged
+   *
+   * An engaged strong_ptr always points to an object, even when it has no
+   * control block because the object is static.
+   *
+   * @return true if the optional_ptr contains a value, false otherwise
+   */
+  [[nodiscard]] constexpr bool is_engaged() const noexcept
+  {
+    return m_value.m_ptr != nullptr;
+  }
+};
+
+/**
+ * @brief Implement weak_ptr::lock() now that optional_ptr is defined
+ *
+ * This function attempts to obtain a strong_ptr from a weak_ptr.
+ * If the referenced object still exists, it returns an optional_ptr
  * containing a strong_ptr to it. Otherwise, it returns an empty optional_ptr.
  *
- * @tparam T The type of the referenced object
- * @return An optional_ptr that is either empty or contains a strong_ptr
+ * @tparam T The type of the referenced object
+ * @return An optional_ptr that is either empty or contains a strong_ptr
+ */
+template<typename T>
+[[nodiscard]] constexpr optional_ptr<T> weak_ptr<T>::lock() const noexcept
+{
+  if (not pin()) {
+    return nullptr;
+  }
+
+  // Bypass the add_ref because the ref count has already been incremented
+  // by pin(). A null control block denotes a static object.
+  return optional_ptr<T>(m_ctrl, m_ptr);
+}
+
+/**
+ * @brief Non-member swap for strong_ptr
+ *
+ * @tparam T The type of the managed object
+ * @param p_lhs First strong_ptr to swap
+ * @param p_rhs Second strong_ptr to swap
+ */
+export template<typename T>
+constexpr void swap(strong_ptr<T>& p_lhs, strong_ptr<T>& p_rhs) noexcept
+{
+  p_lhs.swap(p_rhs);
+}
+
+/**
+ * @brief Non-member swap for weak_ptr
+ *
+ * @tparam T The type of the referenced object
+ * @param p_lhs First weak_ptr to swap
+ * @param p_rhs Second weak_ptr to swap
+ */
+export template<typename T>
+void swap(weak_ptr<T>& p_lhs, weak_ptr<T>& p_rhs) noexcept
+{
+  p_lhs.swap(p_rhs);
+}
+
+/**
+ * @brief Equality operator for strong_ptr
+ *
+ * Compares if two strong_ptr instances point to the same object.
+ *
+ * @tparam T The type of the first strong_ptr
+ * @tparam U The type of the second strong_ptr
+ * @param p_lhs First strong_ptr to compare
+ * @param p_rhs Second strong_ptr to compare
+ * @return true if both point to the same object, false otherwise
+ */
+export template<typename T, typename U>
+[[nodiscard]] constexpr bool operator==(strong_ptr<T> const& p_lhs,
+                                        strong_ptr<U> const& p_rhs) noexcept
+{
+  return p_lhs.operator->() == p_rhs.operator->();
+}
+
+/**
+ * @brief Inequality operator for strong_ptr
+ *
+ * Compares if two strong_ptr instances point to different objects.
+ *
+ * @tparam T The type of the first strong_ptr
+ * @tparam U The type of the second strong_ptr
+ * @param p_lhs First strong_ptr to compare
+ * @param p_rhs Second strong_ptr to compare
+ * @return true if they point to different objects, false otherwise
+ */
+export template<typename T, typename U>
+[[nodiscard]] constexpr bool operator!=(strong_ptr<T> const& p_lhs,
+                                        strong_ptr<U> const& p_rhs) noexcept
+{
+  return not(p_lhs == p_rhs);
+}
+/**
+ * @brief Equality operator for optional_ptr
+ *
+ * Compares if two optional_ptr instances are equal - they are equal if:
+ * 1. Both are disengaged (both empty)
+ * 2. Both are engaged and point to the same object
+ *
+ * @tparam T The type of the first optional_ptr
+ * @tparam U The type of the second optional_ptr
+ * @param p_lhs First optional_ptr to compare
+ * @param p_rhs Second optional_ptr to compare
+ * @return true if both are equal according to the rules above
+ */
+export template<typename T, typename U>
+[[nodiscard]] constexpr bool operator==(optional_ptr<T> const& p_lhs,
+                                        optional_ptr<U> const& p_rhs) noexcept
+{
+  // If both are disengaged, they're equal
+  if (not p_lhs.has_value() && not p_rhs.has_value()) {
+    return true;
+  }
+
+  // If one is engaged and the other isn't, they're not equal
+  if (p_lhs.has_value() != p_rhs.has_value()) {
+    return false;
+  }
+
+  // Both are engaged, compare the underlying pointers
+  return p_lhs.value().operator->() == p_rhs.value().operator->();
+}
+
+/**
+ * @brief Inequality operator for optional_ptr
+ *
+ * Returns the opposite of the equality operator.
+ *
+ * @tparam T The type of the first optional_ptr
+ * @tparam U The type of the second optional_ptr
+ * @param p_lhs First optional_ptr to compare
+ * @param p_rhs Second optional_ptr to compare
+ * @return true if they are not equal
+ */
+export template<typename T, typename U>
+[[nodiscard]] constexpr bool operator!=(optional_ptr<T> const& p_lhs,
+                                        optional_ptr<U> const& p_rhs) noexcept
+{
+  return not(p_lhs == p_rhs);
+}
+
+/**
+ * @brief Equality operator between optional_ptr and nullptr
+ *
+ * An optional_ptr equals nullptr if it's disengaged.
+ *
+ * @tparam T The type of the optional_ptr
+ * @param p_lhs The optional_ptr to compare
+ * @return true if the optional_ptr is disengaged
+ */
+export template<typename T>
+[[nodiscard]] constexpr bool operator==(optional_ptr<T> const& p_lhs,
+                                        std::nullptr_t) noexcept
+{
+  return not p_lhs.has_value();
+}
+
+/**
+ * @brief Equality operator between nullptr and optional_ptr
+ *
+ * nullptr equals an optional_ptr if it's disengaged.
+ *
+ * @tparam T The type of the optional_ptr
+ * @param p_rhs The optional_ptr to compare
+ * @return true if the optional_ptr is disengaged
+ */
+export template<typename T>
+[[nodiscard]] constexpr bool operator==(std::nullptr_t,
+                                        optional_ptr<T> const& p_rhs) noexcept
+{
+  return not p_rhs.has_value();
+}
+
+/**
+ * @brief Inequality operator between optional_ptr and nullptr
+ *
+ * An optional_ptr does not equal nullptr if it's engaged.
+ *
+ * @tparam T The type of the optional_ptr
+ * @param p_lhs The optional_ptr to compare
+ * @return true if the optional_ptr is engaged
+ */
+export template<typename T>
+[[nodiscard]] constexpr bool operator!=(optional_ptr<T> const& p_lhs,
+                                        std::nullptr_t) noexcept
+{
+  return p_lhs.has_value();
+}
+
+/**
+ * @brief Inequality operator between nullptr and optional_ptr
+ *
+ * nullptr does not equal an optional_ptr if it's engaged.
+ *
+ * @tparam T The type of the optional_ptr
+ * @param p_rhs The optional_ptr to compare
+ * @return true if the optional_ptr is engaged
+ */
+export template<typename T>
+[[nodiscard]] constexpr bool operator!=(std::nullptr_t,
+                                        optional_ptr<T> const& p_rhs) noexcept
+{
+  return p_rhs.has_value();
+}
+
+/**
+ * @brief A construction token that can only be created by make_strong_ptr
+ *
+ * Make the first parameter of your class's constructor(s) in order to limit
+ * that constructor to only be used via `make_strong_ptr`.
+ */
+export class strong_ptr_only_token
+{
+private:
+  strong_ptr_only_token() = default;
+
+  friend struct strong_ptr_factory;
+};
+
+/**
+ * @brief Enables strong_from_this without storing anything in the object
+ *
+ * `enable_strong_from_this` stores a pointer to the control block in every
+ * object. This base instead recovers the control block from the address of the
+ * object, as `make_strong_ptr` always places the object at a fixed offset
+ * after its control block. Objects pay no storage and `make_strong_ptr` does
+ * no extra work for them.
+ *
+ * The constructor of this base requires a `strong_ptr_only_token`, which only
+ * `make_strong_ptr` can create. Static objects, objects on the stack, elements
+ * of `make_strong_array` and objects of a type deriving from `T` are rejected
+ * at compile time.
+ *
+ * The token does not prove which object it was created for. A type made by
+ * `make_strong_ptr` receives a token and could forward it to a member or other
+ * subobject using this base, whose `strong_from_this()` would then read a
+ * control block that does not exist. Never pass the token on to subobjects.
+ *
+ * Example usage:
+ * ```
+ * class my_class : public enable_strong_from_this_compact<my_class> {
+ * public:
+ *   my_class(strong_ptr_only_token p_token, int p_value)
+ *     : enable_strong_from_this_compact(p_token), m_value(p_value) {}
+ *
+ *   void register_self(registry& p_registry) {
+ *     p_registry.add(strong_from_this());
+ *   }
+ * };
+ *
+ * auto obj = make_strong_ptr<my_class>(allocator, 42);
+ * ```
+ *
+ * @tparam T The derived class type
+ */
+export template<class T>
+class enable_strong_from_this_compact
+{
+public:
+  /**
+   * @brief Get a strong_ptr to this object
+   *
+   * @return strong_ptr<T> pointing to this object
+   */
+  [[nodiscard]] strong_ptr<T> strong_from_this()
+  {
+    auto* self = static_cast<T*>(this);
+    auto* info = info_of(self);
+    info->template add_ref<T>();
+    return strong_ptr<T>(info, self);
+  }
+
+  /**
+   * @brief Get a strong_ptr to this object (const version)
+   *
+   * @return strong_ptr<T const> pointing to this object
+   */
+  [[nodiscard]] strong_ptr<T const> strong_from_this() const
+  {
+    auto* self = static_cast<T const*>(this);
+    auto* info = info_of(self);
+    info->template add_ref<T>();
+    return strong_ptr<T const>(info, self);
+  }
+
+  /**
+   * @brief Get a weak_ptr to this object
+   *
+   * @return weak_ptr<T> pointing to this object
+   */
+  [[nodiscard]] weak_ptr<T> weak_from_this()
+  {
+    return strong_from_this();
+  }
+
+  /**
+   * @brief Get a weak_ptr to this object (const version)
+   *
+   * @return weak_ptr<T const> pointing to this object
+   */
+  [[nodiscard]] weak_ptr<T const> weak_from_this() const
+  {
+    return strong_from_this();
+  }
+
+private:
+  friend T;
+
+  /**
+   * @brief Constructor, only callable with a token from make_strong_ptr
+   */
+  explicit constexpr enable_strong_from_this_compact(
+    strong_ptr_only_token) noexcept
+  {
+  }
+
+  // Copying would allow objects to be created outside of make_strong_ptr.
+  // Copy the object through a token accepting constructor instead.
+  enable_strong_from_this_compact(enable_strong_from_this_compact const&) =
+    delete;
+
+  /**
+   * @brief Assignment operator
+   *
+   * Does nothing, the location of the object never changes.
+   */
+  constexpr enable_strong_from_this_compact& operator=(
+    enable_strong_from_this_compact const&) noexcept
+  {
+    return *this;
+  }
+
+  ~enable_strong_from_this_compact() = default;
+
+  static ref_info* info_of(T const* p_self) noexcept
+  {
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-const-cast)
+    auto* object = const_cast<std::byte*>(
+      reinterpret_cast<std::byte const*>(p_self));
+    // NOLINTEND(cppcoreguidelines-pro-type-const-cast)
+    return reinterpret_cast<ref_info*>(object - rc_object_offset<T>);
+  }
+};
+
+/**
+ * @brief Deduces the T of the enable_strong_from_this_compact<T> base of a type
+ *
+ * Only used in unevaluated contexts.
+ */
+template<typename T>
+T compact_self_type(enable_strong_from_this_compact<T> const*);
+
+template<typename T>
+concept uses_compact_self =
+  requires(T* p_object) { compact_self_type(p_object); };
+
+/**
+ * @brief Resolve one step of a make_alias path
+ *
+ * @param p_object - object the step is applied to
+ * @param p_step - pointer to data member, or an index into a std::array, C
+ * array or std::span
+ * @return auto& - the member or element selected
+ * @throws mem::out_of_range if an index is out of bounds
+ */
+template<typename Object, typename Step>
+constexpr auto& resolve_alias_step(Object& p_object, Step p_step)
+{
+  if constexpr (std::is_member_object_pointer_v<Step>) {
+    return p_object.*p_step;
+  } else {
+    static_assert(std::is_integral_v<Step>,
+                  "Each step of an alias path must be a pointer to data member "
+                  "or an index");
+    auto const index = static_cast<std::size_t>(p_step);
+    auto const size = std::size(p_object);
+    if (index >= size) {
+      throw_out_of_range(index, size);
+    }
+    return p_object[index];
+  }
+}
+
+template<typename Object>
+constexpr auto& resolve_alias_path(Object& p_object)
+{
+  return p_object;
+}
+
+template<typename Object, typename Step, typename... Rest>
+constexpr auto& resolve_alias_path(Object& p_object,
+                                   Step p_step,
+                                   Rest... p_rest)
+{
+  return resolve_alias_path(resolve_alias_step(p_object, p_step), p_rest...);
+}
+
+/**
+ * @brief Same as resolve_alias_path, but an out of bounds index yields nullptr
+ * rather than being reported through the error policy
+ */
+template<typename Object>
+constexpr auto* try_resolve_alias_path(Object& p_object) noexcept
+{
+  return &p_object;
+}
+
+template<typename Object, typename Step, typename... Rest>
+constexpr auto* try_resolve_alias_path(Object& p_object,
+                                       Step p_step,
+                                       Rest... p_rest) noexcept
+{
+  using leaf_t = std::remove_reference_t<decltype(resolve_alias_path(
+    p_object, p_step, p_rest...))>;
+  if constexpr (std::is_member_object_pointer_v<Step>) {
+    return try_resolve_alias_path(p_object.*p_step, p_rest...);
+  } else {
+    auto const index = static_cast<std::size_t>(p_step);
+    if (index >= std::size(p_object)) {
+      return static_cast<leaf_t*>(nullptr);
+    }
+    return try_resolve_alias_path(p_object[index], p_rest...);
+  }
+}
+
+/**
+ * @brief Allocates and constructs ref counted objects for make_strong_ptr
+ *
+ * Keeps the work common to every make_strong_ptr overload in one place so that
+ * the private parts of strong_ptr, strong_ptr_only_token and
+ * enable_strong_from_this only need to be shared with this one type.
+ */
+struct strong_ptr_factory
+{
+  // Share ownership of p_owner with an object inside of it. Used by
+  // make_alias, which has already located p_object.
+  template<typename T, typename U>
+  static constexpr strong_ptr<T> alias(strong_ptr<U> const& p_owner,
+                                       T* p_object) noexcept
+  {
+    strong_ptr<T> result(p_owner.m_ctrl, p_object);
+    result.add_ref();
+    return result;
+  }
+
+  // The conversions below back the pointer casts. p_convert maps the U*
+  // stored in p_from to a T*, the control block is shared unchanged.
+
+  template<typename T, typename U, typename Convert>
+  static constexpr strong_ptr<T> convert(strong_ptr<U> const& p_from,
+                                         Convert p_convert) noexcept
+  {
+    return alias(p_from, p_convert(p_from.m_ptr));
+  }
+
+  template<typename T, typename U, typename Convert>
+  static constexpr weak_ptr<T> convert(weak_ptr<U> const& p_from,
+                                       Convert p_convert) noexcept
+  {
+    weak_ptr<T> result;
+    result.m_ctrl = p_from.m_ctrl;
+    result.m_ptr = p_convert(p_from.m_ptr);
+    if (result.m_ctrl != nullptr) {
+      result.m_ctrl->template add_weak<T>();
+    }
+    return result;
+  }
+
+  template<typename T, typename U, typename Convert>
+  static constexpr weak_ptr<T> convert(weak_ptr<U>&& p_from,
+                                       Convert p_convert) noexcept
+  {
+    // Transfer the weak reference held by p_from
+    weak_ptr<T> result;
+    result.m_ctrl = std::exchange(p_from.m_ctrl, nullptr);
+    result.m_ptr = p_convert(std::exchange(p_from.m_ptr, nullptr));
+    return result;
+  }
+
+  template<typename T, typename U, typename Convert>
+  static constexpr optional_ptr<T> convert(optional_ptr<U> const& p_from,
+                                           Convert p_convert) noexcept
+  {
+    if (not p_from.is_engaged()) {
+      return nullptr;
+    }
+    return try_alias(p_from.m_value, p_convert(p_from.m_value.m_ptr));
+  }
+
+  template<typename T, typename U, typename Convert>
+  static constexpr optional_ptr<T> convert(optional_ptr<U>&& p_from,
+                                           Convert p_convert) noexcept
+  {
+    if (not p_from.is_engaged()) {
+      return nullptr;
+    }
+    // Transfer the strong reference held by p_from
+    auto* ctrl = std::exchange(p_from.m_value.m_ctrl, nullptr);
+    auto* ptr = std::exchange(p_from.m_value.m_ptr, nullptr);
+    return optional_ptr<T>(ctrl, p_convert(ptr));
+  }
+
+  // Same as alias, but a null p_object, produced by an out of bounds index in
+  // try_make_alias, yields a disengaged optional_ptr
+  template<typename T, typename U>
+  static constexpr optional_ptr<T> try_alias(strong_ptr<U> const& p_owner,
+                                             T* p_object) noexcept
+  {
+    if (p_object == nullptr) {
+      return nullptr;
+    }
+    optional_ptr<T> result(p_owner.m_ctrl, p_object);
+    result.m_value.add_ref();
+    return result;
+  }
+
+  template<class T, class Resource, typename... Args>
+  static constexpr strong_ptr<T> create(Resource p_resource, Args&&... p_args)
+  {
+    return create_with<T>(
+      *p_resource.get(), p_resource, std::forward<Args>(p_args)...);
+  }
+
+  template<class T, class Resource, typename... Args>
+  static strong_ptr<T> create_deferred(deferred_destruction_domain& p_domain,
+                                       Resource p_resource,
+                                       Args&&... p_args)
+  {
+    // Counted before construction so the domain can never be drained to zero
+    // while this object exists
+    p_domain.m_objects.fetch_add(1, std::memory_order_relaxed);
+    domain_guard guard{ .m_domain = &p_domain };
+    auto result = create<T>(
+      deferred_resource<Resource>{ .m_resource = p_resource,
+                                   .m_domain = &p_domain },
+      std::forward<Args>(p_args)...);
+    guard.dismiss();
+    return result;
+  }
+
+  template<class T, std::size_t StorageSizeBytes, typename... Args>
+  static strong_ptr<T> create_scoped(scoped_arena<StorageSizeBytes>& p_arena,
+                                     Args&&... p_args)
+  {
+    auto& registry = p_arena.m_registry;
+    auto result = create_with<T>(p_arena.m_allocator,
+                                 scoped_resource{ .m_registry = &registry },
+                                 std::forward<Args>(p_args)...);
+    // Recorded once constructed, so the sweep only sees complete objects
+    auto* obj = reinterpret_cast<rc<T, scoped_resource>*>(result.m_ctrl);
+    registry.push(&obj->m_resource.m_node, result.m_ctrl);
+    return result;
+  }
+
+  /**
+   * @brief Allocate through p_allocator, which may be a concrete allocator,
+   * allowing the allocation to be inlined. Deallocation always goes through
+   * the memory resource stored in the control block.
+   */
+  template<class T, class Allocator, class Resource, typename... Args>
+  static constexpr strong_ptr<T> create_with(Allocator& p_allocator,
+                                             Resource p_resource,
+                                             Args&&... p_args)
+  {
+    using rc_t = rc<T, Resource>;
+    void* storage = nullptr;
+    if constexpr (requires {
+                    p_allocator.template allocate_for<T>(sizeof(rc_t),
+                                                         alignof(rc_t));
+                  }) {
+      // Lets a profiling_resource attribute the allocation to T
+      storage =
+        p_allocator.template allocate_for<T>(sizeof(rc_t), alignof(rc_t));
+    } else {
+      storage = p_allocator.allocate(sizeof(rc_t), alignof(rc_t));
+    }
+    rc_t* obj =
+      construct<T>(storage, p_resource, std::forward<Args>(p_args)...);
+    return strong_ptr<T>(&obj->m_info, &obj->m_object);
+  }
+
+  /**
+   * @brief Same as create_with, but a failed allocation returns a disengaged
+   * optional_ptr rather than being reported through the error policy
+   */
+  template<class T, class Allocator, class Resource, typename... Args>
+  static constexpr optional_ptr<T> try_create_with(Allocator& p_allocator,
+                                                   Resource p_resource,
+                                                   Args&&... p_args)
+  {
+    using rc_t = rc<T, Resource>;
+    void* storage = try_allocate_from(p_allocator, sizeof(rc_t), alignof(rc_t));
+    if (storage == nullptr) [[unlikely]] {
+      return nullptr;
+    }
+    rc_t* obj =
+      construct<T>(storage, p_resource, std::forward<Args>(p_args)...);
+    return optional_ptr<T>(&obj->m_info, &obj->m_object);
+  }
+
+  template<class T, class Resource, typename... Args>
+  static constexpr strong_ptr<std::span<T> const>
+  create_array(Resource p_resource, std::size_t p_count, Args const&... p_args)
+  {
+    using rc_t = rc_array<T, Resource>;
+
+    static_assert(not uses_compact_self<T>,
+                  "Elements of a strong array are not placed directly after a "
+                  "control block, so they cannot use "
+                  "enable_strong_from_this_compact");
+
+    auto* memory = p_resource.get();
+    auto const size = rc_t::allocation_size(p_count);
+    auto* storage =
+      static_cast<std::byte*>(memory->allocate(size, rc_t::alignment));
+    auto* elements = reinterpret_cast<T*>(storage + rc_t::elements_offset);
+
+    // Destroyed in reverse order: the elements are unwound before the storage
+    // is returned
+    allocation_guard storage_guard{ .m_resource = memory,
+                                    .m_storage = storage,
+                                    .m_size = size,
+                                    .m_alignment = rc_t::alignment };
+    element_guard<T> elements_guard{ .m_elements = elements };
+    for (; elements_guard.m_constructed < p_count;
+         elements_guard.m_constructed++) {
+      if constexpr (std::is_constructible_v<T,
+                                            strong_ptr_only_token,
+                                            Args const&...>) {
+        // Type expects token as first parameter
+        std::construct_at(&elements[elements_guard.m_constructed],
+                          strong_ptr_only_token{},
+                          p_args...);
+      } else {
+        // Normal type, construct without token
+        std::construct_at(&elements[elements_guard.m_constructed], p_args...);
+      }
+    }
+    elements_guard.dismiss();
+    storage_guard.dismiss();
+
+    auto* obj = std::construct_at(
+      reinterpret_cast<rc_t*>(storage), p_resource, elements, p_count);
+    record_ref_event<std::span<T>>(ref_event::strong_increment);
+    strong_ptr<std::span<T> const> result(&obj->m_info, &obj->m_elements);
+
+    // Initialize enable_strong_from_this if the type inherits from it
+    if constexpr (std::is_base_of_v<enable_strong_from_this<T>, T>) {
+      for (auto& element : obj->m_elements) {
+        element.init_weak_this(&obj->m_info);
+      }
+    }
+
+    return result;
+  }
+
+private:
+  // Allocates coroutine frames through try_allocate_from
+  friend struct coroutine_frame;
+
+  // The guards below undo a partially completed construction if a
+  // constructor exits by an exception. They take the place of try/catch so
+  // that the factory also compiles with -fno-exceptions.
+
+  // Returns storage to its memory resource unless dismissed
+  struct allocation_guard
+  {
+    constexpr ~allocation_guard()
+    {
+      if (m_storage != nullptr) {
+        m_resource->deallocate(m_storage, m_size, m_alignment);
+      }
+    }
+
+    constexpr void dismiss() noexcept
+    {
+      m_storage = nullptr;
+    }
+
+    std::pmr::memory_resource* m_resource;
+    void* m_storage;
+    std::size_t m_size;
+    std::size_t m_alignment;
+  };
+
+  // Destroys the first m_constructed elements, in reverse, unless dismissed
+  template<typename T>
+  struct element_guard
+  {
+    constexpr ~element_guard()
+    {
+      for (; m_constructed > 0; m_constructed--) {
+        std::destroy_at(&m_elements[m_constructed - 1]);
+      }
+    }
+
+    constexpr void dismiss() noexcept
+    {
+      m_constructed = 0;
+    }
+
+    T* m_elements;
+    std::size_t m_constructed = 0;
+  };
+
+  // Removes an object that was never created from its domain unless dismissed
+  struct domain_guard
+  {
+    ~domain_guard()
+    {
+      if (m_domain != nullptr) {
+        m_domain->m_objects.fetch_sub(1, std::memory_order_relaxed);
+      }
+    }
+
+    void dismiss() noexcept
+    {
+      m_domain = nullptr;
+    }
+
+    deferred_destruction_domain* m_domain;
+  };
+
+  // Allocate from p_allocator, returning nullptr on failure. Allocators
+  // without try_allocate, such as an arbitrary std::pmr::memory_resource,
+  // can only report failure by throwing std::bad_alloc.
+  template<class Allocator>
+  static constexpr void* try_allocate_from(Allocator& p_allocator,
+                                           std::size_t p_bytes,
+                                           std::size_t p_alignment)
+  {
+    if constexpr (requires {
+                    p_allocator.try_allocate(p_bytes, p_alignment);
+                  }) {
+      return p_allocator.try_allocate(p_bytes, p_alignment);
+    } else {
+#if LIBHAL_STRONG_PTR_EXCEPTIONS
+      try {
+        return p_allocator.allocate(p_bytes, p_alignment);
+      } catch (std::bad_alloc const&) {
+        return nullptr;
+      }
+#else
+      return p_allocator.allocate(p_bytes, p_alignment);
+#endif
+    }
+  }
+
+  // Construct the control block and object in p_storage, which is returned
+  // to p_resource if the constructor exits by an exception
+  template<class T, class Resource, typename... Args>
+  static constexpr rc<T, Resource>* construct(void* p_storage,
+                                              Resource p_resource,
+                                              Args&&... p_args)
+  {
+    using rc_t = rc<T, Resource>;
+
+    if constexpr (uses_compact_self<T>) {
+      static_assert(
+        std::is_same_v<decltype(compact_self_type(std::declval<T*>())),
+                       std::remove_const_t<T>>,
+        "enable_strong_from_this_compact<U> locates the control block from the "
+        "address of U, so only U itself, not a type derived from U, can be "
+        "created with make_strong_ptr");
+    }
+
+    allocation_guard guard{ .m_resource = p_resource.get(),
+                            .m_storage = p_storage,
+                            .m_size = sizeof(rc_t),
+                            .m_alignment = alignof(rc_t) };
+    rc_t* obj = nullptr;
+    if constexpr (std::is_constructible_v<T, strong_ptr_only_token, Args...>) {
+      // Type expects token as first parameter
+      obj = std::construct_at(static_cast<rc_t*>(p_storage),
+                              p_resource,
+                              strong_ptr_only_token{},
+                              std::forward<Args>(p_args)...);
+    } else {
+      // Normal type, construct without token
+      obj = std::construct_at(static_cast<rc_t*>(p_storage),
+                              p_resource,
+                              std::forward<Args>(p_args)...);
+    }
+    guard.dismiss();
+
+    record_ref_event<T>(ref_event::strong_increment);
+
+    // Initialize enable_strong_from_this if the type inherits from it
+    if constexpr (std::is_base_of_v<enable_strong_from_this<T>, T>) {
+      obj->m_object.init_weak_this(&obj->m_info);
+    }
+
+    return obj;
+  }
+};
+
+/**
+ * @brief Factory function to create a strong_ptr with automatic construction
+ * detection
+ *
+ * This is the primary way to create a new strong_ptr.
+ *
+ * To create a strong_ptr, you must provide a `std::pmr::memory_resource`.
+ * That resource must outlive all strong_ptrs created by it. To uphold the
+ * guarantees of strong_ptr, the `std::pmr::memory_resource` MUST terminate the
+ * application if it is destroyed before all of its allocated memory has been
+ * freed. This requirement prevents use-after-free errors.
+ *
+ * The function performs the following operations:
+ *
+ * 1. Allocates memory for both the object and its control block together
+ * 2. Detects at compile time if the type expects a strong_ptr_only_token
+ * 3. Constructs the object with appropriate parameters
+ * 4. Initializes enable_strong_from_this support if the type inherits from it
+ * 5. Returns a strong_ptr managing the newly created object
+ *
+ * **Token-based construction**: If a class constructor takes
+ * `strong_ptr_only_token` as its first parameter, this function automatically
+ * provides that token, ensuring the class can only be constructed via
+ * make_strong_ptr.
+ *
+ * **Normal construction**: For regular classes, construction proceeds normally
+ * with the provided arguments.
+ *
+ * **enable_strong_from_this support**: If the constructed type inherits from
+ * `enable_strong_from_this<T>`, the weak reference is automatically initialized
+ * to enable `strong_from_this()` and `weak_from_this()` functionality.
+ *
+ * Example usage:
+ *
+ * ```cpp
+ * // Token-protected class (can only be created via make_strong_ptr)
+ * class protected_driver {
+ * public:
+ *   protected_driver(strong_ptr_only_token, driver_config config);
+ * };
+ * auto driver = make_strong_ptr<protected_driver>(allocator, config{});
+ *
+ * // Regular class
+ * class regular_class {
+ * public:
+ *   regular_class(int value);
+ * };
+ * auto obj = make_strong_ptr<regular_class>(allocator, 42);
+ *
+ * // Class with enable_strong_from_this support
+ * class self_aware : public enable_strong_from_this<self_aware> {
+ * public:
+ *   self_aware(std::string name);
+ *   void register_callback() {
+ *     auto self = strong_from_this(); // This works automatically
+ *   }
+ * };
+ * auto obj = make_strong_ptr<self_aware>(allocator, "example");
+ * ```
+ *
+ * @tparam T The type of object to create
+ * @tparam Args Types of arguments to forward to the constructor
+ * @param p_memory_resource the memory resource used to allocate memory for the
+ * strong_ptr. The memory resource must call `std::terminate` if it is destroyed
+ * without all of its memory being freed.
+ * @param p_args Arguments to forward to the constructor
+ * @return A strong_ptr managing the newly created object
+ * @throws Any exception thrown by the object's constructor
+ * @throws std::bad_alloc if memory allocation fails
+ */
+export template<class T, typename... Args>
+[[nodiscard]] constexpr strong_ptr<T> make_strong_ptr(
+  std::pmr::memory_resource* p_memory_resource,
+  Args&&... p_args)
+{
+  return strong_ptr_factory::create<T>(runtime_resource{ p_memory_resource },
+                                       std::forward<Args>(p_args)...);
+}
+
+/**
+ * @brief Allocator whose allocation function can be called directly
+ *
+ * Satisfied by the allocators returned from `make_monotonic_allocator` and
+ * `make_pool_allocator`, and by `profiling_resource`. `allocate` must return
+ * memory that can be released through the `std::pmr::memory_resource`
+ * returned by `resource()`.
+ *
+ * @tparam Allocator - concrete allocator type
+ */
+export template<typename Allocator>
+concept direct_allocator =
+  requires(Allocator& p_allocator, std::size_t p_size) {
+    { p_allocator.allocate(p_size, p_size) } -> std::same_as<void*>;
+    {
+      p_allocator.resource()
+    } -> std::convertible_to<std::pmr::memory_resource*>;
+  };
+
+/**
+ * @brief Factory function to create a strong_ptr using a concrete allocator
+ *
+ * Behaves exactly like `make_strong_ptr(std::pmr::memory_resource*, ...)`,
+ * except that memory is allocated by calling `p_allocator.allocate()` directly
+ * rather than through the virtual `do_allocate()` of a memory resource. For
+ * allocators such as `monotonic_allocator` this allows the allocation to be
+ * fully inlined. The control block still stores `p_allocator.resource()`, so
+ * deallocation remains type erased and the resulting strong_ptr is identical
+ * to one made from a `std::pmr::memory_resource*`.
+ *
+ * Example usage:
+ *
+ * ```cpp
+ * auto allocator = mem::make_monotonic_allocator<1024>();
+ * // Selects this overload, as allocator is a concrete type
+ * auto obj = mem::make_strong_ptr<my_class>(allocator, 42);
+ * ```
+ *
+ * @tparam T The type of object to create
+ * @tparam Allocator Concrete allocator type
+ * @tparam Args Types of arguments to forward to the constructor
+ * @param p_allocator the allocator used to allocate memory for the strong_ptr.
+ * Its memory resource must call `std::terminate` if it is destroyed without all
+ * of its memory being freed.
+ * @param p_args Arguments to forward to the constructor
+ * @return A strong_ptr managing the newly created object
+ * @throws Any exception thrown by the object's constructor
+ * @throws std::bad_alloc if memory allocation fails
+ */
+export template<class T, direct_allocator Allocator, typename... Args>
+[[nodiscard]] constexpr strong_ptr<T> make_strong_ptr(Allocator& p_allocator,
+                                                      Args&&... p_args)
+{
+  return strong_ptr_factory::create_with<T>(
+    p_allocator,
+    runtime_resource{ p_allocator.resource() },
+    std::forward<Args>(p_args)...);
+}
+
+/**
+ * @brief Allocator that can report an allocation failure without the error
+ * policy
+ *
+ * Satisfied by the allocators returned from `make_monotonic_allocator`,
+ * `make_concurrent_monotonic_allocator` and `make_pool_allocator`.
+ * `try_allocate` must return nullptr on failure and memory that can be
+ * released through `resource()` on success.
+ *
+ * @tparam Allocator - concrete allocator type
+ */
+export template<typename Allocator>
+concept nothrow_allocator =
+  requires(Allocator& p_allocator, std::size_t p_size) {
+    {
+      p_allocator.try_allocate(p_size, p_size)
+    } noexcept -> std::same_as<void*>;
+    {
+      p_allocator.resource()
+    } -> std::convertible_to<std::pmr::memory_resource*>;
+  };
+
+/**
+ * @brief Factory function to create a strong_ptr that reports allocation
+ * failure by returning a disengaged optional_ptr
+ *
+ * Behaves like `make_strong_ptr(Allocator&, ...)`, except that no exception
+ * is thrown and std::terminate() is not called when the allocator is
+ * exhausted. This is the recommended way to handle running out of memory
+ * when exceptions are disabled, see `exceptions_enabled`.
+ *
+ * Example usage:
+ *
+ * ```cpp
+ * auto arena = mem::make_monotonic_allocator<256>();
+ * auto sensor = mem::try_make_strong_ptr<imu>(arena, bus);
+ * if (not sensor) {
+ *   // Arena exhausted, degrade gracefully
+ * }
+ * ```
+ *
+ * @tparam T The type of object to create
+ * @tparam Allocator concrete allocator type
+ * @tparam Args Types of arguments to forward to the constructor
+ * @param p_allocator allocator used to allocate memory for the object
+ * @param p_args Arguments to forward to the constructor
+ * @return An optional_ptr managing the newly created object, disengaged if
+ * memory could not be allocated
+ * @throws Any exception thrown by the object's constructor
+ */
+export template<class T, nothrow_allocator Allocator, typename... Args>
+[[nodiscard]] constexpr optional_ptr<T> try_make_strong_ptr(
+  Allocator& p_allocator,
+  Args&&... p_args)
+{
+  return strong_ptr_factory::try_create_with<T>(
+    p_allocator,
+    runtime_resource{ p_allocator.resource() },
+    std::forward<Args>(p_args)...);
+}
+
+/**
+ * @brief Factory function to create a strong_ptr from any memory resource,
+ * reporting allocation failure by returning a disengaged optional_ptr
+ *
+ * A `std::pmr::memory_resource` can only report failure by throwing
+ * std::bad_alloc, which is caught and turned into a disengaged result. With
+ * exceptions disabled, a failing memory resource decides for itself what
+ * happens. Prefer the overload taking a `nothrow_allocator` in that case.
+ *
+ * @tparam T The type of object to create
+ * @tparam Args Types of arguments to forward to the constructor
+ * @param p_memory_resource the memory resource used to allocate memory for the
+ * strong_ptr. The memory resource must call `std::terminate` if it is destroyed
+ * without all of its memory being freed.
+ * @param p_args Arguments to forward to the constructor
+ * @return An optional_ptr managing the newly created object, disengaged if
+ * memory could not be allocated
+ * @throws Any exception thrown by the object's constructor
+ */
+export template<class T, typename... Args>
+[[nodiscard]] constexpr optional_ptr<T> try_make_strong_ptr(
+  std::pmr::memory_resource* p_memory_resource,
+  Args&&... p_args)
+{
+  return strong_ptr_factory::try_create_with<T>(
+    *p_memory_resource,
+    runtime_resource{ p_memory_resource },
+    std::forward<Args>(p_args)...);
+}
+
+/**
+ * @brief Factory function to create a strong_ptr from a memory resource known
+ * at compile time
+ *
+ * Behaves exactly like `make_strong_ptr(std::pmr::memory_resource*, ...)`,
+ * except that the memory resource is not stored in the control block, saving a
+ * pointer for every object allocated.
+ *
+ * Example usage:
+ *
+ * ```cpp
+ * std::array<std::byte, 1024> buffer;
+ * std::pmr::monotonic_buffer_resource message_resource(buffer.data(),
+ *                                                      buffer.size());
+ *
+ * auto msg = make_strong_ptr<message>(mem::static_resource<message_resource>,
+ *                                     payload);
+ * ```
+ *
+ * @tparam T The type of object to create
+ * @tparam Resource memory resource with static storage duration
+ * @tparam Args Types of arguments to forward to the constructor
+ * @param p_args Arguments to forward to the constructor
+ * @return A strong_ptr managing the newly created object
+ * @throws Any exception thrown by the object's constructor
+ * @throws std::bad_alloc if memory allocation fails
+ */
+export template<class T, auto& Resource, typename... Args>
+[[nodiscard]] constexpr strong_ptr<T> make_strong_ptr(
+  static_resource_t<Resource> p_memory_resource,
+  Args&&... p_args)
+{
+  return strong_ptr_factory::create<T>(p_memory_resource,
+                                       std::forward<Args>(p_args)...);
+}
+
+/**
+ * @brief Factory function to create a strong_ptr whose destruction is deferred
+ *
+ * Behaves like `make_strong_ptr(std::pmr::memory_resource*, ...)`, except that
+ * releasing the last strong reference only queues the object in `p_domain`.
+ * The destructor runs, and the memory is returned to `p_memory_resource`, when
+ * `p_domain.drain()` reaches the object. The domain link is stored in the
+ * same allocation, after the object.
+ *
+ * @tparam T The type of object to create
+ * @tparam Args Types of arguments to forward to the constructor
+ * @param p_domain the domain that destroys the object, must outlive it
+ * @param p_memory_resource the memory resource used to allocate memory for the
+ * strong_ptr. The memory resource must call `std::terminate` if it is destroyed
+ * without all of its memory being freed.
+ * @param p_args Arguments to forward to the constructor
+ * @return A strong_ptr managing the newly created object
+ * @throws Any exception thrown by the object's constructor
+ * @throws std::bad_alloc if memory allocation fails
+ */
+export template<class T, typename... Args>
+[[nodiscard]] strong_ptr<T> make_deferred_strong_ptr(
+  deferred_destruction_domain& p_domain,
+  std::pmr::memory_resource* p_memory_resource,
+  Args&&... p_args)
+{
+  return strong_ptr_factory::create_deferred<T>(
+    p_domain,
+    runtime_resource{ p_memory_resource },
+    std::forward<Args>(p_args)...);
+}
+
+/**
+ * @brief Factory function to create a strong_ptr destroyed by a scoped_arena
+ *
+ * Behaves like `make_strong_ptr(std::pmr::memory_resource*, ...)`, except that
+ * memory comes from `p_arena`, and releasing the last reference neither runs
+ * the destructor nor deallocates. Both happen for every object of the arena at
+ * once, when the arena is destroyed or cleared. See `scoped_arena`.
+ *
+ * @tparam T The type of object to create
+ * @tparam StorageSizeBytes The size of the arena
+ * @tparam Args Types of arguments to forward to the constructor
+ * @param p_arena the arena that owns the object's memory and destroys it
+ * @param p_args Arguments to forward to the constructor
+ * @return A strong_ptr managing the newly created object
+ * @throws Any exception thrown by the object's constructor
+ * @throws std::bad_alloc if the arena is exhausted
+ */
+export template<class T, std::size_t StorageSizeBytes, typename... Args>
+[[nodiscard]] strong_ptr<T> make_scoped_strong_ptr(
+  scoped_arena<StorageSizeBytes>& p_arena,
+  Args&&... p_args)
+{
+  return strong_ptr_factory::create_scoped<T>(p_arena,
+                                              std::forward<Args>(p_args)...);
+}
+
+/**
+ * @brief Factory function to create an array of objects, of a size only known
+ * at runtime, in a single allocation
+ *
+ * The control block and all `p_count` elements share one allocation from
+ * `p_memory_resource`. The result is a strong_ptr to a span over the
+ * elements, so the span can be used for iteration and indexing while sharing
+ * ownership of the whole array. Use the aliasing constructor
+ * `strong_ptr<T>(array, index)` to hand out a strong_ptr to a single element.
+ *
+ * Every element is constructed from the same `p_args`, which are therefore
+ * passed by const reference rather than forwarded. Elements are destroyed in
+ * reverse order when the last reference is released.
+ *
+ * Example usage:
+ *
+ * ```cpp
+ * auto buffer = mem::make_strong_array<std::byte>(allocator, 1500);
+ * for (auto& byte : *buffer) {
+ *   byte = std::byte{ 0 };
+ * }
+ * auto packets = mem::make_strong_array<packet>(allocator, 8, packet_config);
+ * mem::strong_ptr<packet> first = { packets, 0 };
+ * ```
+ *
+ * @tparam T The type of the array elements
+ * @tparam Args Types of arguments used to construct every element
+ * @param p_memory_resource the memory resource used to allocate memory for the
+ * array. The memory resource must call `std::terminate` if it is destroyed
+ * without all of its memory being freed.
+ * @param p_count Number of elements in the array
+ * @param p_args Arguments used to construct every element
+ * @return strong_ptr<std::span<T> const> managing the newly created array
+ * @throws Any exception thrown by an element's constructor
+ * @throws std::bad_alloc if memory allocation fails
+ */
+export template<class T, typename... Args>
+[[nodiscard]] constexpr strong_ptr<std::span<T> const> make_strong_array(
+  std::pmr::memory_resource* p_memory_resource,
+  std::size_t p_count,
+  Args const&... p_args)
+{
+  return strong_ptr_factory::create_array<T>(
+    runtime_resource{ p_memory_resource }, p_count, p_args...);
+}
+
+/**
+ * @brief Factory function to create an array of objects from a memory resource
+ * known at compile time
+ *
+ * Behaves exactly like
+ * `make_strong_array(std::pmr::memory_resource*, std::size_t, ...)`, except
+ * that the memory resource is not stored in the control block.
+ *
+ * @tparam T The type of the array elements
+ * @tparam Resource memory resource with static storage duration
+ * @tparam Args Types of arguments used to construct every element
+ * @param p_count Number of elements in the array
+ * @param p_args Arguments used to construct every element
+ * @return strong_ptr<std::span<T> const> managing the newly created array
+ * @throws Any exception thrown by an element's constructor
+ * @throws std::bad_alloc if memory allocation fails
+ */
+export template<class T, auto& Resource, typename... Args>
+[[nodiscard]] constexpr strong_ptr<std::span<T> const> make_strong_array(
+  static_resource_t<Resource> p_memory_resource,
+  std::size_t p_count,
+  Args const&... p_args)
+{
+  return strong_ptr_factory::create_array<T>(
+    p_memory_resource, p_count, p_args...);
+}
+
+/**
+ * @brief A group of objects that live and die together under a single control
+ * block
+ *
+ * Created by `make_strong_group`. The objects are stored contiguously in a
+ * single allocation along with one control block. Each object can be handed
+ * out as its own `strong_ptr<T>`, which aliases into the group and keeps the
+ * entire group alive. The group is destroyed, with a single destroy call and a
+ * single deallocation, when the last reference to any of its objects is
+ * released.
+ *
+ * Example usage:
+ *
+ * ```cpp
+ * auto nodes = mem::make_strong_group<node>(allocator, 128);
+ * mem::strong_ptr<node> root = nodes[0];
+ * for (auto& n : nodes) {
+ *   n.connect(root);
+ * }
+ * ```
+ *
+ * @tparam T - type of the objects in the group
+ */
+export template<typename T>
+class strong_group
+{
+public:
+  using element_type = T;
+
+  /**
+   * @brief Create a group from an existing strong array
+   *
+   * @param p_elements - array created by `make_strong_array`
+   */
+  explicit constexpr strong_group(strong_ptr<std::span<T> const> p_elements)
+    : m_elements(std::move(p_elements))
+  {
+  }
+
+  /**
+   * @brief Get a strong_ptr to an object of the group
+   *
+   * @param p_index - index of the object
+   * @return strong_ptr<T> - strong_ptr sharing ownership of the group
+   * @throws mem::out_of_range if p_index is out of bounds
+   */
+  [[nodiscard]] constexpr strong_ptr<T> operator[](std::size_t p_index) const
+  {
+    return strong_ptr<T>(m_elements, p_index);
+  }
+
+  /**
+   * @brief Get a view of the objects of the group
+   *
+   * The view does not extend the lifetime of the group.
+   *
+   * @return std::span<T> - every object of the group
+   */
+  [[nodiscard]] constexpr std::span<T> elements() const noexcept
+  {
+    return *m_elements;
+  }
+
+  [[nodiscard]] constexpr std::size_t size() const noexcept
+  {
+    return m_elements->size();
+  }
+
+  [[nodiscard]] constexpr auto begin() const noexcept
+  {
+    return m_elements->begin();
+  }
+
+  [[nodiscard]] constexpr auto end() const noexcept
+  {
+    return m_elements->end();
+  }
+
+  /**
+   * @brief Get the number of strong references to the group
+   *
+   * Includes this handle and every strong_ptr to any object of the group.
+   *
+   * @return auto - number of strong references
+   */
+  [[nodiscard]] auto use_count() const noexcept
+  {
+    return m_elements.use_count();
+  }
+
+private:
+  strong_ptr<std::span<T> const> m_elements;
+};
+
+/**
+ * @brief A span that shares ownership of the objects it views
+ *
+ * strong_span holds a single strong reference to the control block of the
+ * object that owns the elements, along with a `std::span<T>` of them.
+ * Iterating, indexing and taking subspans work on the span directly, so the
+ * reference count is never touched per element. A `strong_ptr<T>` to an
+ * element is produced with `share()` only when one has to outlive the span.
+ *
+ * Like strong_ptr, a strong_span always refers to a valid set of elements and
+ * moves are copies.
+ *
+ * Example usage:
+ * ```
+ * struct frame {
+ *   std::array<sample, 1024> samples;
+ * };
+ *
+ * auto frame_ptr = mem::make_strong_ptr<frame>(allocator);
+ * mem::strong_span<sample> samples(frame_ptr, &frame::samples);
+ *
+ * // One reference for the whole loop
+ * for (auto& s : samples.subspan(0, 512)) {
+ *   s.normalize();
+ * }
+ *
+ * // Only the escaping element acquires a reference
+ * mem::strong_ptr<sample> peak = samples.share(find_peak(samples));
+ * ```
+ *
+ * @tparam T - the element type
+ */
+export template<typename T>
+class strong_span
+{
+public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using iterator = typename std::span<T>::iterator;
+
+  /**
+   * @brief Create a strong_span over every element of a strong array
+   *
+   * @tparam E - element type of the array, convertible to T
+   * @param p_array - array created by `make_strong_array`
+   */
+  template<typename E>
+  constexpr strong_span(strong_ptr<std::span<E> const> const& p_array) noexcept
+    requires(std::is_convertible_v<E (*)[], T (*)[]>)
+    : strong_span(p_array.m_ctrl, *p_array)
+  {
+  }
+
+  /**
+   * @brief Create a strong_span over a std::array member of an object
+   *
+   * @tparam U - type of the owning object
+   * @tparam E - element type of the array, convertible to T
+   * @tparam N - number of elements
+   * @param p_owner - strong_ptr to the owning object
+   * @param p_array_ptr - pointer to the array member
+   */
+  template<typename U, typename E, std::size_t N>
+  constexpr strong_span(strong_ptr<U> const& p_owner,
+                        // clang-format off
+             std::array<E, N> U::* p_array_ptr
+                        // clang-format on
+                        ) noexcept
+    requires(std::is_convertible_v<E (*)[], T (*)[]>)
+    : strong_span(p_owner.m_ctrl, std::span<T>((*p_owner).*p_array_ptr))
+  {
+  }
+
+  // NOLINTBEGIN(modernize-avoid-c-arrays)
+  /**
+   * @brief Create a strong_span over a C array member of an object
+   *
+   * @tparam U - type of the owning object
+   * @tparam E - element type of the array, convertible to T
+   * @tparam N - number of elements
+   * @param p_owner - strong_ptr to the owning object
+   * @param p_array_ptr - pointer to the array member
+   */
+  template<typename U, typename E, std::size_t N>
+  constexpr strong_span(strong_ptr<U> const& p_owner,
+                        E (U::*p_array_ptr)[N]) noexcept
+    requires(std::is_convertible_v<E (*)[], T (*)[]>)
+    : strong_span(p_owner.m_ctrl, std::span<T>((*p_owner).*p_array_ptr))
+  {
+  }
+  // NOLINTEND(modernize-avoid-c-arrays)
+
+  /**
+   * @brief Convert from a strong_span of a compatible element type
+   *
+   * Typically used to go from `strong_span<T>` to `strong_span<T const>`.
+   *
+   * @tparam U - element type convertible to T
+   * @param p_other - the strong_span to share ownership with
+   */
+  template<typename U>
+  constexpr strong_span(strong_span<U> const& p_other) noexcept
+    requires(std::is_convertible_v<U (*)[], T (*)[]> && not std::is_same_v<U, T>)
+    : strong_span(p_other.m_ctrl, p_other.m_elements)
+  {
+  }
+
+  constexpr strong_span(strong_span const& p_other) noexcept
+    : strong_span(p_other.m_ctrl, p_other.m_elements)
+  {
+  }
+
+  constexpr strong_span& operator=(strong_span const& p_other) noexcept
+  {
+    strong_span(p_other).swap(*this);
+    return *this;
+  }
+
+  constexpr ~strong_span()
+  {
+    if (m_ctrl != nullptr) {
+      m_ctrl->template release<T>();
+    }
+  }
+
+  constexpr void swap(strong_span& p_other) noexcept
+  {
+    std::swap(m_ctrl, p_other.m_ctrl);
+    std::swap(m_elements, p_other.m_elements);
+  }
+
+  /**
+   * @brief Access an element, bounds checked
+   *
+   * The reference does not extend the lifetime of the elements.
+   *
+   * @param p_index - index of the element
+   * @return T& - the element
+   * @throws mem::out_of_range if p_index is out of bounds
+   */
+  [[nodiscard]] constexpr T& operator[](std::size_t p_index) const
+  {
+    throw_if_out_of_bounds(p_index);
+    return m_elements[p_index];
+  }
+
+  /**
+   * @brief Get a strong_ptr to a single element
+   *
+   * The returned strong_ptr shares ownership with this span and may outlive
+   * it. This is the only operation of strong_span that adds a reference
+   * besides copying the span itself.
+   *
+   * @param p_index - index of the element
+   * @return strong_ptr<T> - strong_ptr to the element
+   * @throws mem::out_of_range if p_index is out of bounds
+   */
+  [[nodiscard]] constexpr strong_ptr<T> share(std::size_t p_index) const
+  {
+    throw_if_out_of_bounds(p_index);
+    if (m_ctrl != nullptr) {
+      m_ctrl->template add_ref<T>();
+    }
+    return strong_ptr<T>(m_ctrl, &m_elements[p_index]);
+  }
+
+  /**
+   * @brief Get a strong_span of a range of the elements
+   *
+   * The bounds are checked once for the whole range.
+   *
+   * @param p_offset - index of the first element
+   * @param p_count - number of elements, or std::dynamic_extent for every
+   * element after p_offset
+   * @return strong_span - span sharing ownership with this span
+   * @throws mem::out_of_range if the range is not within this span
+   */
+  [[nodiscard]] constexpr strong_span subspan(
+    std::size_t p_offset,
+    std::size_t p_count = std::dynamic_extent) const
+  {
+    if (p_offset > size()) {
+      throw_out_of_range(p_offset, size());
+    }
+    if (p_count == std::dynamic_extent) {
+      p_count = size() - p_offset;
+    } else if (p_count > size() - p_offset) {
+      throw_out_of_range(p_offset + p_count, size());
+    }
+    return strong_span(m_ctrl, m_elements.subspan(p_offset, p_count));
+  }
+
+  /**
+   * @brief Get a strong_span of the first p_count elements
+   *
+   * @throws mem::out_of_range if p_count exceeds size()
+   */
+  [[nodiscard]] constexpr strong_span first(std::size_t p_count) const
+  {
+    return subspan(0, p_count);
+  }
+
+  /**
+   * @brief Get a strong_span of the last p_count elements
+   *
+   * @throws mem::out_of_range if p_count exceeds size()
+   */
+  [[nodiscard]] constexpr strong_span last(std::size_t p_count) const
+  {
+    if (p_count > size()) {
+      throw_out_of_range(p_count, size());
+    }
+    return subspan(size() - p_count, p_count);
+  }
+
+  /**
+   * @brief Get a view of the elements
+   *
+   * The view does not extend the lifetime of the elements.
+   *
+   * @return std::span<T> - the elements
+   */
+  [[nodiscard]] constexpr std::span<T> elements() const noexcept
+  {
+    return m_elements;
+  }
+
+  [[nodiscard]] constexpr T* data() const noexcept
+  {
+    return m_elements.data();
+  }
+
+  [[nodiscard]] constexpr std::size_t size() const noexcept
+  {
+    return m_elements.size();
+  }
+
+  [[nodiscard]] constexpr bool empty() const noexcept
+  {
+    return m_elements.empty();
+  }
+
+  [[nodiscard]] constexpr iterator begin() const noexcept
+  {
+    return m_elements.begin();
+  }
+
+  [[nodiscard]] constexpr iterator end() const noexcept
+  {
+    return m_elements.end();
+  }
+
+  /**
+   * @brief Get the number of strong references to the owning object
+   *
+   * This is primarily for testing purposes.
+   *
+   * @return auto - number of strong references, 0 if statically allocated
+   */
+  [[nodiscard]] constexpr auto use_count() const noexcept
+  {
+    return m_ctrl ? m_ctrl->use_count() : 0;
+  }
+
+private:
+  template<typename U>
+  friend class strong_span;
+
+  // Shares ownership through p_ctrl, which is null for static objects
+  constexpr strong_span(ref_info* p_ctrl, std::span<T> p_elements) noexcept
+    : m_ctrl(p_ctrl)
+    , m_elements(p_elements)
+  {
+    if (m_ctrl != nullptr) {
+      m_ctrl->template add_ref<T>();
+    }
+  }
+
+  constexpr void throw_if_out_of_bounds(std::size_t p_index) const
+  {
+    if (p_index >= size()) {
+      throw_out_of_range(p_index, size());
+    }
+  }
+
+  ref_info* m_ctrl;
+  std::span<T> m_elements;
+};
+
+/**
+ * @brief Factory function to create many objects sharing one control block
+ *
+ * All `p_count` objects are allocated contiguously, with one control block, in
+ * a single allocation from `p_memory_resource`. Obtain a `strong_ptr<T>` to
+ * any object with `operator[]` of the returned group. Creating the group is a
+ * single allocation and tearing it down is a single deallocation, regardless
+ * of the number of objects.
+ *
+ * Every object is constructed from the same `p_args`, which are therefore
+ * passed by const reference rather than forwarded.
+ *
+ * @tparam T The type of the objects
+ * @tparam Args Types of arguments used to construct every object
+ * @param p_memory_resource the memory resource used to allocate memory for the
+ * group. The memory resource must call `std::terminate` if it is destroyed
+ * without all of its memory being freed.
+ * @param p_count Number of objects in the group
+ * @param p_args Arguments used to construct every object
+ * @return strong_group<T> managing the newly created objects
+ * @throws Any exception thrown by an object's constructor
+ * @throws std::bad_alloc if memory allocation fails
+ */
+export template<class T, typename... Args>
+[[nodiscard]] constexpr strong_group<T> make_strong_group(
+  std::pmr::memory_resource* p_memory_resource,
+  std::size_t p_count,
+  Args const&... p_args)
+{
+  return strong_group<T>(
+    make_strong_array<T>(p_memory_resource, p_count, p_args...));
+}
+
+/**
+ * @brief Create a strong_ptr to an object nested several levels inside another
+ *
+ * Walks a path of pointers to data members and indices from the object managed
+ * by `p_root` and returns a strong_ptr to the object at the end of the path,
+ * sharing ownership with `p_root`. This is equivalent to chaining the aliasing
+ * constructors of strong_ptr, but without the temporary strong_ptr and
+ * reference count traffic created at each level. Only one reference is added,
+ * and each index is bounds checked exactly once.
+ *
+ * Indices may be applied to std::array, C array and std::span members, as well
+ * as to the elements of a strong array returned by `make_strong_array`. As
+ * with the aliasing constructors, the path must end with an index when it
+ * reaches an array, so that every element access is bounds checked.
+ *
+ * Example usage:
+ * ```
+ * struct limits { std::uint32_t rx_window; };
+ * struct config { limits limits; };
+ * struct channel { config config; };
+ * struct stack { std::array<channel, 4> channels; };
+ *
+ * auto root = mem::make_strong_ptr<stack>(allocator);
+ *
+ * // strong_ptr<std::uint32_t> to root->channels[2].config.limits.rx_window
+ * auto rx_window = mem::make_alias(root,
+ *                                  &stack::channels,
+ *                                  2,
+ *                                  &channel::config,
+ *                                  &config::limits,
+ *                                  &limits::rx_window);
+ * ```
+ *
+ * @tparam U Type of the root object
+ * @tparam Path Pointer to data member and integral index types
+ * @param p_root The strong_ptr to the root object
+ * @param p_path The members and indices to walk from the root object
+ * @return strong_ptr to the object at the end of the path
+ * @throws mem::out_of_range if an index is out of bounds
+ */
+export template<typename U, typename... Path>
+[[nodiscard]] constexpr auto make_alias(strong_ptr<U> const& p_root,
+                                        Path... p_path)
+{
+  static_assert(sizeof...(Path) > 0,
+                "An alias path needs at least one member or index");
+  auto& leaf = resolve_alias_path(*p_root, p_path...);
+  using leaf_t = std::remove_reference_t<decltype(leaf)>;
+  static_assert(non_array_like<std::remove_cv_t<leaf_t>>,
+                "End the alias path with an index to alias an array element");
+  return strong_ptr_factory::alias(p_root, &leaf);
+}
+
+/**
+ * @brief Create an optional_ptr to an object nested several levels inside
+ * another, without reporting failure through the error policy
+ *
+ * Behaves exactly like `make_alias`, except that an out of bounds index
+ * results in a disengaged optional_ptr rather than `mem::out_of_range`. Use
+ * this when indices come from untrusted input, such as a message received over
+ * a bus, and especially when building with exceptions disabled.
+ *
+ * Example usage:
+ * ```
+ * auto channel = mem::try_make_alias(root, &stack::channels, p_request.id);
+ * if (not channel) {
+ *   return error_code::invalid_channel;
+ * }
+ * ```
+ *
+ * @tparam U Type of the root object
+ * @tparam Path Pointer to data member and integral index types
+ * @param p_root The strong_ptr to the root object
+ * @param p_path The members and indices to walk from the root object
+ * @return optional_ptr to the object at the end of the path, disengaged if an
+ * index is out of bounds
+ */
+export template<typename U, typename... Path>
+[[nodiscard]] constexpr auto try_make_alias(strong_ptr<U> const& p_root,
+                                            Path... p_path) noexcept
+{
+  static_assert(sizeof...(Path) > 0,
+                "An alias path needs at least one member or index");
+  auto* leaf = try_resolve_alias_path(*p_root, p_path...);
+  using leaf_t = std::remove_pointer_t<decltype(leaf)>;
+  static_assert(non_array_like<std::remove_cv_t<leaf_t>>,
+                "End the alias path with an index to alias an array element");
+  return strong_ptr_factory::try_alias(p_root, leaf);
+}
+
+/**
+ * @brief U* can be converted to T* with static_cast
+ */
+template<typename T, typename U>
+concept static_castable =
+  requires(U* p_pointer) { static_cast<T*>(p_pointer); };
+
+/**
+ * @brief U* can be converted to T* with const_cast
+ */
+template<typename T, typename U>
+concept const_castable = requires(U* p_pointer) { const_cast<T*>(p_pointer); };
+
+/**
+ * @brief U can be checked for being a T without RTTI
+ *
+ * Satisfied when `T::classof(U const&)` exists, following the LLVM `isa<>`
+ * convention. It usually compares a tag stored in the base class:
+ *
+ * ```
+ * struct shape { enum class kind { circle, square } m_kind; };
+ * struct circle : shape {
+ *   static bool classof(shape const& p_shape) {
+ *     return p_shape.m_kind == shape::kind::circle;
+ *   }
+ * };
+ * ```
+ *
+ * @tparam T - type to cast to
+ * @tparam U - type to cast from
  */
-template<typename T>
-[[nodiscard]] constexpr optional_ptr<T> weak_ptr<T>::lock() const noexcept
+export template<typename T, typename U>
+concept checked_castable =
+  static_castable<T, U> and requires(U const& p_object) {
+    { T::classof(p_object) } -> std::convertible_to<bool>;
+  };
+
+/**
+ * @brief Cast the pointer held by a strong_ptr with static_cast
+ *
+ * The result shares ownership with p_ptr through the same control block.
+ * As with static_cast, downcasting to a type that the object is not is
+ * undefined behavior. Use `checked_pointer_cast` when the type must be
+ * verified.
+ *
+ * strong_ptr is never null, so a moved from strong_ptr keeps its reference and
+ * there is no overload that transfers it. Cast an optional_ptr or weak_ptr
+ * rvalue to avoid reference count traffic.
+ *
+ * @tparam T - type to cast to
+ * @param p_ptr - the strong_ptr to cast
+ * @return strong_ptr<T> - shares ownership with p_ptr
+ */
+export template<typename T, typename U>
+  requires static_castable<T, U>
+[[nodiscard]] constexpr strong_ptr<T> static_pointer_cast(
+  strong_ptr<U> const& p_ptr) noexcept
 {
-  if (expired()) {
-    return nullptr;
-  }
+  return strong_ptr_factory::convert<T>(
+    p_ptr, [](U* p_pointer) { return static_cast<T*>(p_pointer); });
+}
 
-  // Try to increment the strong count
-  while (m_ctrl->strong_count > 0) {
-    // Bypass the add_ref because the ref count has already been incremented
-    // above.
-    return strong_ptr<T>(m_ctrl, m_ptr);
-  }
+/**
+ * @brief Cast the pointer held by a weak_ptr with static_cast
+ *
+ * @tparam T - type to cast to
+ * @param p_ptr - the weak_ptr to cast
+ * @return weak_ptr<T> - refers to the same object as p_ptr
+ */
+export template<typename T, typename U>
+  requires static_castable<T, U>
+[[nodiscard]] constexpr weak_ptr<T> static_pointer_cast(
+  weak_ptr<U> const& p_ptr) noexcept
+{
+  return strong_ptr_factory::convert<T>(
+    p_ptr, [](U* p_pointer) { return static_cast<T*>(p_pointer); });
+}
 
-  // Strong count is now 0
-  return nullptr;
+/**
+ * @brief Cast the pointer held by a weak_ptr with static_cast, transferring its
+ * reference without touching the reference counts
+ *
+ * @tparam T - type to cast to
+ * @param p_ptr - the weak_ptr to cast, left empty
+ * @return weak_ptr<T> - refers to the object p_ptr referred to
+ */
+export template<typename T, typename U>
+  requires static_castable<T, U>
+[[nodiscard]] constexpr weak_ptr<T> static_pointer_cast(
+  weak_ptr<U>&& p_ptr) noexcept
+{
+  return strong_ptr_factory::convert<T>(
+    std::move(p_ptr), [](U* p_pointer) { return static_cast<T*>(p_pointer); });
 }
 
 /**
- * @brief Non-member swap for strong_ptr
+ * @brief Cast the pointer held by an optional_ptr with static_cast
  *
- * @tparam T The type of the managed object
- * @param p_lhs First strong_ptr to swap
- * @param p_rhs Second strong_ptr to swap
+ * @tparam T - type to cast to
+ * @param p_ptr - the optional_ptr to cast
+ * @return optional_ptr<T> - shares ownership with p_ptr, disengaged if p_ptr
+ * is disengaged
  */
-export template<typename T>
-constexpr void swap(strong_ptr<T>& p_lhs, strong_ptr<T>& p_rhs) noexcept
+export template<typename T, typename U>
+  requires static_castable<T, U>
+[[nodiscard]] constexpr optional_ptr<T> static_pointer_cast(
+  optional_ptr<U> const& p_ptr) noexcept
 {
-  p_lhs.swap(p_rhs);
+  return strong_ptr_factory::convert<T>(
+    p_ptr, [](U* p_pointer) { return static_cast<T*>(p_pointer); });
 }
 
 /**
- * @brief Non-member swap for weak_ptr
+ * @brief Cast the pointer held by an optional_ptr with static_cast,
+ * transferring its reference without touching the reference counts
  *
- * @tparam T The type of the referenced object
- * @param p_lhs First weak_ptr to swap
- * @param p_rhs Second weak_ptr to swap
+ * @tparam T - type to cast to
+ * @param p_ptr - the optional_ptr to cast, left disengaged
+ * @return optional_ptr<T> - owns the object p_ptr owned
  */
-export template<typename T>
-void swap(weak_ptr<T>& p_lhs, weak_ptr<T>& p_rhs) noexcept
+export template<typename T, typename U>
+  requires static_castable<T, U>
+[[nodiscard]] constexpr optional_ptr<T> static_pointer_cast(
+  optional_ptr<U>&& p_ptr) noexcept
 {
-  p_lhs.swap(p_rhs);
+  return strong_ptr_factory::convert<T>(
+    std::move(p_ptr), [](U* p_pointer) { return static_cast<T*>(p_pointer); });
 }
 
 /**
- * @brief Equality operator for strong_ptr
+ * @brief Cast the pointer held by a strong_ptr with const_cast
  *
- * Compares if two strong_ptr instances point to the same object.
+ * The result shares ownership with p_ptr through the same control block.
+ * Modifying an object through the result that was created const is
+ * undefined behavior, as with const_cast.
  *
- * @tparam T The type of the first strong_ptr
- * @tparam U The type of the second strong_ptr
- * @param p_lhs First strong_ptr to compare
- * @param p_rhs Second strong_ptr to compare
- * @return true if both point to the same object, false otherwise
+ * strong_ptr is never null, so a moved from strong_ptr keeps its reference and
+ * there is no overload that transfers it. Cast an optional_ptr or weak_ptr
+ * rvalue to avoid reference count traffic.
+ *
+ * @tparam T - type to cast to
+ * @param p_ptr - the strong_ptr to cast
+ * @return strong_ptr<T> - shares ownership with p_ptr
  */
 export template<typename T, typename U>
-[[nodiscard]] constexpr bool operator==(strong_ptr<T> const& p_lhs,
-                                        strong_ptr<U> const& p_rhs) noexcept
+  requires const_castable<T, U>
+[[nodiscard]] constexpr strong_ptr<T> const_pointer_cast(
+  strong_ptr<U> const& p_ptr) noexcept
 {
-  return p_lhs.operator->() == p_rhs.operator->();
+  return strong_ptr_factory::convert<T>(
+    p_ptr, [](U* p_pointer) { return const_cast<T*>(p_pointer); });
 }
 
 /**
- * @brief Inequality operator for strong_ptr
+ * @brief Cast the pointer held by a weak_ptr with const_cast
  *
- * Compares if two strong_ptr instances point to different objects.
+ * @tparam T - type to cast to
+ * @param p_ptr - the weak_ptr to cast
+ * @return weak_ptr<T> - refers to the same object as p_ptr
+ */
+export template<typename T, typename U>
+  requires const_castable<T, U>
+[[nodiscard]] constexpr weak_ptr<T> const_pointer_cast(
+  weak_ptr<U> const& p_ptr) noexcept
+{
+  return strong_ptr_factory::convert<T>(
+    p_ptr, [](U* p_pointer) { return const_cast<T*>(p_pointer); });
+}
+
+/**
+ * @brief Cast the pointer held by a weak_ptr with const_cast, transferring its
+ * reference without touching the reference counts
  *
- * @tparam T The type of the first strong_ptr
- * @tparam U The type of the second strong_ptr
- * @param p_lhs First strong_ptr to compare
- * @param p_rhs Second strong_ptr to compare
- * @return true if they point to different objects, false otherwise
+ * @tparam T - type to cast to
+ * @param p_ptr - the weak_ptr to cast, left empty
+ * @return weak_ptr<T> - refers to the object p_ptr referred to
  */
 export template<typename T, typename U>
-[[nodiscard]] constexpr bool operator!=(strong_ptr<T> const& p_lhs,
-                                        strong_ptr<U> const& p_rhs) noexcept
+  requires const_castable<T, U>
+[[nodiscard]] constexpr weak_ptr<T> const_pointer_cast(
+  weak_ptr<U>&& p_ptr) noexcept
 {
-  return not(p_lhs == p_rhs);
+  return strong_ptr_factory::convert<T>(
+    std::move(p_ptr), [](U* p_pointer) { return const_cast<T*>(p_pointer); });
 }
+
 /**
- * @brief Equality operator for optional_ptr
+ * @brief Cast the pointer held by an optional_ptr with const_cast
  *
- * Compares if two optional_ptr instances are equal - they are equal if:
- * 1. Both are disengaged (both empty)
- * 2. Both are engaged and point to the same object
+ * @tparam T - type to cast to
+ * @param p_ptr - the optional_ptr to cast
+ * @return optional_ptr<T> - shares ownership with p_ptr, disengaged if p_ptr
+ * is disengaged
+ */
+export template<typename T, typename U>
+  requires const_castable<T, U>
+[[nodiscard]] constexpr optional_ptr<T> const_pointer_cast(
+  optional_ptr<U> const& p_ptr) noexcept
+{
+  return strong_ptr_factory::convert<T>(
+    p_ptr, [](U* p_pointer) { return const_cast<T*>(p_pointer); });
+}
+
+/**
+ * @brief Cast the pointer held by an optional_ptr with const_cast, transferring
+ * its reference without touching the reference counts
  *
- * @tparam T The type of the first optional_ptr
- * @tparam U The type of the second optional_ptr
- * @param p_lhs First optional_ptr to compare
- * @param p_rhs Second optional_ptr to compare
- * @return true if both are equal according to the rules above
+ * @tparam T - type to cast to
+ * @param p_ptr - the optional_ptr to cast, left disengaged
+ * @return optional_ptr<T> - owns the object p_ptr owned
  */
 export template<typename T, typename U>
-[[nodiscard]] constexpr bool operator==(optional_ptr<T> const& p_lhs,
-                                        optional_ptr<U> const& p_rhs) noexcept
+  requires const_castable<T, U>
+[[nodiscard]] constexpr optional_ptr<T> const_pointer_cast(
+  optional_ptr<U>&& p_ptr) noexcept
 {
-  // If both are disengaged, they're equal
-  if (not p_lhs.has_value() && not p_rhs.has_value()) {
-    return true;
+  return strong_ptr_factory::convert<T>(
+    std::move(p_ptr), [](U* p_pointer) { return const_cast<T*>(p_pointer); });
+}
+
+/**
+ * @brief Downcast a strong_ptr after checking the type with `T::classof()`
+ *
+ * The RTTI free counterpart of std::dynamic_pointer_cast, see
+ * `checked_castable`. The result shares ownership with p_ptr through the same
+ * control block.
+ *
+ * Example usage:
+ * ```
+ * mem::strong_ptr<shape> shape = next_shape();
+ * if (auto circle = mem::checked_pointer_cast<circle>(shape)) {
+ *   draw(circle->radius);
+ * }
+ * ```
+ *
+ * @tparam T - type to cast to
+ * @param p_ptr - the strong_ptr to cast
+ * @return optional_ptr<T> - shares ownership with p_ptr, disengaged if the
+ * object is not a T
+ */
+export template<typename T, typename U>
+  requires checked_castable<T, U>
+[[nodiscard]] constexpr optional_ptr<T> checked_pointer_cast(
+  strong_ptr<U> const& p_ptr)
+{
+  if (not T::classof(*p_ptr)) {
+    return nullptr;
   }
+  return strong_ptr_factory::convert<T>(
+    optional_ptr<U>(p_ptr),
+    [](U* p_pointer) { return static_cast<T*>(p_pointer); });
+}
 
-  // If one is engaged and the other isn't, they're not equal
-  if (p_lhs.has_value() != p_rhs.has_value()) {
-    return false;
+/**
+ * @brief Downcast a weak_ptr after checking the type with `T::classof()`
+ *
+ * The object is locked for the duration of the check.
+ *
+ * @tparam T - type to cast to
+ * @param p_ptr - the weak_ptr to cast
+ * @return weak_ptr<T> - refers to the same object as p_ptr, empty if the
+ * object is not a T or has expired
+ */
+export template<typename T, typename U>
+  requires checked_castable<T, U>
+[[nodiscard]] constexpr weak_ptr<T> checked_pointer_cast(
+  weak_ptr<U> const& p_ptr)
+{
+  bool is_t = false;
+  if (not p_ptr.visit([&is_t](U& p_object) { is_t = T::classof(p_object); }) or
+      not is_t) {
+    return {};
+  }
+  return static_pointer_cast<T>(p_ptr);
+}
+
+/**
+ * @brief Downcast an optional_ptr after checking the type with `T::classof()`
+ *
+ * @tparam T - type to cast to
+ * @param p_ptr - the optional_ptr to cast
+ * @return optional_ptr<T> - shares ownership with p_ptr, disengaged if p_ptr
+ * is disengaged or the object is not a T
+ */
+export template<typename T, typename U>
+  requires checked_castable<T, U>
+[[nodiscard]] constexpr optional_ptr<T> checked_pointer_cast(
+  optional_ptr<U> const& p_ptr)
+{
+  if (not p_ptr or not T::classof(*p_ptr)) {
+    return nullptr;
+  }
+  return static_pointer_cast<T>(p_ptr);
+}
+
+/**
+ * @brief Downcast an optional_ptr after checking the type with `T::classof()`,
+ * transferring its reference without touching the reference counts
+ *
+ * @tparam T - type to cast to
+ * @param p_ptr - the optional_ptr to cast, left disengaged on success
+ * @return optional_ptr<T> - owns the object p_ptr owned, disengaged if p_ptr
+ * is disengaged or the object is not a T
+ */
+export template<typename T, typename U>
+  requires checked_castable<T, U>
+[[nodiscard]] constexpr optional_ptr<T> checked_pointer_cast(
+  optional_ptr<U>&& p_ptr)
+{
+  if (not p_ptr or not T::classof(*p_ptr)) {
+    return nullptr;
+  }
+  return static_pointer_cast<T>(std::move(p_ptr));
+}
+
+/**
+ * @brief Transparent ordering of strong_ptr and weak_ptr by owner
+ *
+ * Use as the comparator of ordered containers keyed on weak_ptr, which has no
+ * other ordering. Heterogeneous lookup with a strong_ptr is supported.
+ */
+export struct owner_less
+{
+  using is_transparent = void;
+
+  template<typename L, typename R>
+  [[nodiscard]] constexpr bool operator()(L const& p_lhs,
+                                          R const& p_rhs) const noexcept
+  {
+    return p_lhs.owner_before(p_rhs);
+  }
+};
+
+/**
+ * @brief Transparent equality of strong_ptr and weak_ptr by owner
+ *
+ * Pair with `owner_hash` to key unordered containers on weak_ptr.
+ */
+export struct owner_equal
+{
+  using is_transparent = void;
+
+  template<typename L, typename R>
+  [[nodiscard]] constexpr bool operator()(L const& p_lhs,
+                                          R const& p_rhs) const noexcept
+  {
+    return p_lhs.owner_equal(p_rhs);
+  }
+};
+
+/**
+ * @brief Transparent hash of strong_ptr and weak_ptr by owner
+ *
+ * Consistent with `owner_equal`.
+ */
+export struct owner_hash
+{
+  using is_transparent = void;
+
+  template<typename P>
+  [[nodiscard]] std::size_t operator()(P const& p_ptr) const noexcept
+  {
+    return p_ptr.owner_hash();
+  }
+};
+
+/**
+ * @brief Cache of shared objects that only lives as long as its users
+ *
+ * weak_cache maps keys to weak_ptr's of objects created on demand. A lookup
+ * of a key whose object is still alive returns that object, otherwise a new
+ * one is created with `make_strong_ptr` from the cache's memory resource. The
+ * cache never keeps an object alive by itself, so expensive objects such as
+ * decoded assets are shared while in use and freed once the last user lets
+ * go.
+ *
+ * Entries of expired objects are removed lazily: each insertion that grows the
+ * cache past twice its size at the last sweep prunes it, which amortizes the
+ * sweep to constant time per insertion. Like any weak_ptr, an entry keeps the
+ * storage of its expired object allocated until it is removed, so call
+ * `prune()` to return that memory to the resource on demand.
+ *
+ * weak_cache is not thread safe. Concurrent use must be synchronized by the
+ * caller.
+ *
+ * Example usage:
+ * ```
+ * mem::weak_cache<std::uint32_t, sprite> sprites(&sprite_arena);
+ *
+ * // Decodes the sprite unless one with the same id is still in use
+ * mem::strong_ptr<sprite> player = sprites.get_or_create(id, id, image_data);
+ * ```
+ *
+ * @tparam Key - type of the keys
+ * @tparam T - type of the cached objects
+ * @tparam Hash - hash function for Key
+ * @tparam KeyEqual - equality comparison for Key
+ */
+export template<typename Key,
+                typename T,
+                typename Hash = std::hash<Key>,
+                typename KeyEqual = std::equal_to<Key>>
+class weak_cache
+{
+public:
+  using key_type = Key;
+  using element_type = T;
+
+  /**
+   * @brief Create a cache that allocates its objects and entries from one
+   * memory resource
+   *
+   * @param p_resource - memory resource for the objects and the entries
+   */
+  explicit weak_cache(std::pmr::memory_resource* p_resource)
+    : weak_cache(p_resource, p_resource)
+  {
+  }
+
+  /**
+   * @brief Create a cache with separate memory resources for its objects and
+   * its entries
+   *
+   * Keeping the entries out of an object arena avoids wasting arena space on
+   * the table's rehashing.
+   *
+   * @param p_resource - memory resource for the cached objects
+   * @param p_entry_resource - memory resource for the table of entries
+   */
+  weak_cache(std::pmr::memory_resource* p_resource,
+             std::pmr::memory_resource* p_entry_resource)
+    : m_resource(p_resource)
+    , m_entries(p_entry_resource)
+  {
+  }
+
+  /**
+   * @brief Get the cached object for a key, creating it if none is alive
+   *
+   * @param p_key - key of the object
+   * @param p_args - arguments used to construct the object on a miss, unused on
+   * a hit
+   * @return strong_ptr<T> - the cached or newly created object
+   * @throws std::bad_alloc if the object or the entry cannot be allocated
+   */
+  template<typename... Args>
+  [[nodiscard]] strong_ptr<T> get_or_create(Key const& p_key, Args&&... p_args)
+  {
+    auto [entry, inserted] = m_entries.try_emplace(p_key);
+    if (not inserted) {
+      if (auto cached = entry->second.lock()) {
+        return cached.value();
+      }
+    }
+
+    // An entry left empty because construction failed counts as expired
+    auto object = make_strong_ptr<T>(m_resource, std::forward<Args>(p_args)...);
+    entry->second = object;
+    if (inserted and m_entries.size() > m_prune_threshold) {
+      prune();
+    }
+    return object;
+  }
+
+  /**
+   * @brief Get the cached object for a key without creating one
+   *
+   * @param p_key - key of the object
+   * @return optional_ptr<T> - the cached object, disengaged if there is none
+   * or it has expired
+   */
+  [[nodiscard]] optional_ptr<T> find(Key const& p_key) const
+  {
+    auto const entry = m_entries.find(p_key);
+    if (entry == m_entries.end()) {
+      return nullptr;
+    }
+    return entry->second.lock();
+  }
+
+  /**
+   * @brief Remove the entry of a key
+   *
+   * The object itself is unaffected and lives on while it is in use.
+   *
+   * @param p_key - key to remove
+   * @return true if an entry was removed
+   */
+  bool erase(Key const& p_key)
+  {
+    return m_entries.erase(p_key) != 0;
+  }
+
+  /**
+   * @brief Remove the entries of all expired objects
+   *
+   * @return std::size_t - number of entries removed
+   */
+  std::size_t prune() noexcept
+  {
+    auto const removed = std::erase_if(
+      m_entries, [](auto const& p_entry) { return p_entry.second.expired(); });
+    m_prune_threshold = std::max(minimum_prune_threshold, 2 * m_entries.size());
+    return removed;
+  }
+
+  /**
+   * @brief Remove all entries
+   */
+  void clear() noexcept
+  {
+    m_entries.clear();
+    m_prune_threshold = minimum_prune_threshold;
+  }
+
+  /**
+   * @brief Get the number of entries, including those of expired objects that
+   * have not been pruned yet
+   *
+   * @return std::size_t - number of entries
+   */
+  [[nodiscard]] std::size_t size() const noexcept
+  {
+    return m_entries.size();
+  }
+
+  /**
+   * @brief Get the memory resource used to create objects
+   *
+   * @return std::pmr::memory_resource* - the memory resource of the objects
+   */
+  [[nodiscard]] std::pmr::memory_resource* resource() const noexcept
+  {
+    return m_resource;
   }
 
-  // Both are engaged, compare the underlying pointers
-  return p_lhs.value().operator->() == p_rhs.value().operator->();
-}
+private:
+  static constexpr std::size_t minimum_prune_threshold = 8;
+
+  std::pmr::memory_resource* m_resource;
+  std::pmr::unordered_map<Key, weak_ptr<T>, Hash, KeyEqual> m_entries;
+  std::size_t m_prune_threshold = minimum_prune_threshold;
+};
 
 /**
- * @brief Inequality operator for optional_ptr
- *
- * Returns the opposite of the equality operator.
+ * @brief Control block placed in front of a coroutine frame by strong_promise
  *
- * @tparam T The type of the first optional_ptr
- * @tparam U The type of the second optional_ptr
- * @param p_lhs First optional_ptr to compare
- * @param p_rhs Second optional_ptr to compare
- * @return true if they are not equal
+ * The frame is destroyed through a type erased coroutine_handle, so a single
+ * manager serves every promise type. The frame directly follows this header,
+ * whose alignment keeps the frame at the alignment `operator new` guarantees.
  */
-export template<typename T, typename U>
-[[nodiscard]] constexpr bool operator!=(optional_ptr<T> const& p_lhs,
-                                        optional_ptr<U> const& p_rhs) noexcept
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) coroutine_frame
 {
-  return not(p_lhs == p_rhs);
-}
+  ref_info m_info;
+  std::pmr::memory_resource* m_resource;
+  std::size_t m_bytes;
+  // The reference the frame was created with has been given to a handle
+  bool m_adopted = false;
+  // The frame is being destroyed by the manager, which owns the memory
+  bool m_destroying = false;
+
+  [[nodiscard]] void* frame() noexcept
+  {
+    return this + 1;
+  }
 
-/**
- * @brief Equality operator between optional_ptr and nullptr
- *
- * An optional_ptr equals nullptr if it's disengaged.
- *
- * @tparam T The type of the optional_ptr
- * @param p_lhs The optional_ptr to compare
- * @return true if the optional_ptr is disengaged
- */
-export template<typename T>
-[[nodiscard]] constexpr bool operator==(optional_ptr<T> const& p_lhs,
-                                        std::nullptr_t) noexcept
-{
-  return not p_lhs.has_value();
-}
+  [[nodiscard]] static coroutine_frame* of(void* p_frame) noexcept
+  {
+    return static_cast<coroutine_frame*>(p_frame) - 1;
+  }
 
-/**
- * @brief Equality operator between nullptr and optional_ptr
- *
- * nullptr equals an optional_ptr if it's disengaged.
- *
- * @tparam T The type of the optional_ptr
- * @param p_rhs The optional_ptr to compare
- * @return true if the optional_ptr is disengaged
- */
-export template<typename T>
-[[nodiscard]] constexpr bool operator==(std::nullptr_t,
-                                        optional_ptr<T> const& p_rhs) noexcept
-{
-  return not p_rhs.has_value();
-}
+  // Allocate a frame of p_bytes from p_allocator, which is a memory resource
+  // pointer or an allocator convertible to one. Failures are reported through
+  // the error policy.
+  template<class Allocator>
+  [[nodiscard]] static void* allocate(Allocator& p_allocator,
+                                      std::size_t p_bytes)
+  {
+    auto* resource = static_cast<std::pmr::memory_resource*>(p_allocator);
+    std::size_t const bytes = sizeof(coroutine_frame) + p_bytes;
+    return create(resource->allocate(bytes, alignof(coroutine_frame)),
+                  resource,
+                  bytes);
+  }
 
-/**
- * @brief Inequality operator between optional_ptr and nullptr
- *
- * An optional_ptr does not equal nullptr if it's engaged.
- *
- * @tparam T The type of the optional_ptr
- * @param p_lhs The optional_ptr to compare
- * @return true if the optional_ptr is engaged
- */
-export template<typename T>
-[[nodiscard]] constexpr bool operator!=(optional_ptr<T> const& p_lhs,
-                                        std::nullptr_t) noexcept
-{
-  return p_lhs.has_value();
-}
+  // Same as allocate, but a failure returns nullptr
+  template<class Allocator>
+  [[nodiscard]] static void* try_allocate(Allocator& p_allocator,
+                                          std::size_t p_bytes) noexcept
+  {
+    auto* resource = static_cast<std::pmr::memory_resource*>(p_allocator);
+    std::size_t const bytes = sizeof(coroutine_frame) + p_bytes;
+    void* storage = nullptr;
+    if constexpr (std::is_pointer_v<Allocator>) {
+      storage = strong_ptr_factory::try_allocate_from(
+        *p_allocator, bytes, alignof(coroutine_frame));
+    } else {
+      storage = strong_ptr_factory::try_allocate_from(
+        p_allocator, bytes, alignof(coroutine_frame));
+    }
+    if (storage == nullptr) [[unlikely]] {
+      return nullptr;
+    }
+    return create(storage, resource, bytes);
+  }
 
-/**
- * @brief Inequality operator between nullptr and optional_ptr
- *
- * nullptr does not equal an optional_ptr if it's engaged.
- *
- * @tparam T The type of the optional_ptr
- * @param p_rhs The optional_ptr to compare
- * @return true if the optional_ptr is engaged
- */
-export template<typename T>
-[[nodiscard]] constexpr bool operator!=(std::nullptr_t,
-                                        optional_ptr<T> const& p_rhs) noexcept
-{
-  return p_rhs.has_value();
-}
+  [[nodiscard]] static void* create(void* p_storage,
+                                    std::pmr::memory_resource* p_resource,
+                                    std::size_t p_bytes) noexcept
+  {
+    auto* header = new (p_storage) coroutine_frame{
+      .m_info = ref_info(&manage),
+      .m_resource = p_resource,
+      .m_bytes = p_bytes,
+    };
+    return header->frame();
+  }
 
-/**
- * @brief A construction token that can only be created by make_strong_ptr
- *
- * Make the first parameter of your class's constructor(s) in order to limit
- * that constructor to only be used via `make_strong_ptr`.
- */
-export class strong_ptr_only_token
-{
-private:
-  strong_ptr_only_token() = default;
+  // Called by the promise's operator delete. Frames destroyed by the manager
+  // keep their memory until no weak_ptr remains. Any other destruction is
+  // only valid before a handle owns the frame, such as when the promise's
+  // constructor throws.
+  LIBHAL_STRONG_PTR_NOINLINE static void release_storage(void* p_frame) noexcept
+  {
+    auto* self = of(p_frame);
+    if (self->m_destroying) {
+      return;
+    }
+    if (self->m_adopted) {
+      // The frame was destroyed behind the back of its owners, for instance
+      // by a final_suspend() that does not suspend. Their handles would
+      // dangle.
+      std::terminate();
+    }
+    deallocate(self);
+  }
+
+  static void deallocate(coroutine_frame* p_self) noexcept
+  {
+    p_self->m_resource->deallocate(
+      p_self, p_self->m_bytes, alignof(coroutine_frame));
+  }
+
+  static void destroy_coroutine(coroutine_frame* p_self) noexcept
+  {
+    p_self->m_destroying = true;
+    std::coroutine_handle<>::from_address(p_self->frame()).destroy();
+  }
 
-  template<class U, typename... Args>
-  friend constexpr strong_ptr<U> make_strong_ptr(std::pmr::memory_resource*,
-                                                 Args&&...);
+  static std::pmr::memory_resource* manage(ref_info* p_info,
+                                           ref_info::operation p_operation)
+  {
+    // Cast back into the header as m_info is the first member
+    auto* self = reinterpret_cast<coroutine_frame*>(p_info);
+
+    switch (p_operation) {
+      case ref_info::operation::destroy:
+      case ref_info::operation::finalize:
+        destroy_coroutine(self);
+        break;
+      case ref_info::operation::deallocate:
+        deallocate(self);
+        break;
+      case ref_info::operation::destroy_and_deallocate:
+        destroy_coroutine(self);
+        deallocate(self);
+        break;
+      case ref_info::operation::get_allocator:
+        return self->m_resource;
+    }
+    return nullptr;
+  }
 };
 
+// Coroutine arguments that include one providing the memory of the frame
+template<typename... Args>
+concept provides_frame_resource =
+  (std::is_convertible_v<Args&, std::pmr::memory_resource*> or ...);
+
+// Promise types that return a fallback object when the frame cannot be
+// allocated, rather than reporting the failure through the error policy
+template<typename Promise>
+concept reports_allocation_failure =
+  requires { Promise::get_return_object_on_allocation_failure(); };
+
 /**
- * @brief Factory function to create a strong_ptr with automatic construction
- * detection
+ * @brief Number of bytes strong_promise adds to every coroutine frame
  *
- * This is the primary way to create a new strong_ptr.
+ * Useful for sizing the slots of a pool or an arena dedicated to coroutine
+ * frames. The size of the frame itself is chosen by the compiler, measure it
+ * with `profiling_resource`.
+ */
+export inline constexpr std::size_t coroutine_frame_overhead =
+  sizeof(coroutine_frame);
+
+/**
+ * @brief CRTP mixin for coroutine promise types that places the coroutine
+ * frame under the management of strong_ptr
  *
- * To create a strong_ptr, you must provide a `std::pmr::memory_resource`.
- * That resource must outlive all strong_ptrs created by it. To uphold the
- * guarantees of strong_ptr, the `std::pmr::memory_resource` MUST terminate the
- * application if it is destroyed before all of its allocated memory has been
- * freed. This requirement prevents use-after-free errors.
+ * The frame is allocated from the first argument of the coroutine that
+ * converts to `std::pmr::memory_resource*`, such as a memory resource pointer
+ * or a reference to a `monotonic_allocator` or `pool_allocator`, with a
+ * control block in front of it. A coroutine without such an argument does not
+ * compile. The frame is then owned through `strong_ptr<Promise>` like any
+ * other object: it is destroyed, at whatever point it is suspended, when the
+ * last strong_ptr drops and its memory is returned once no weak_ptr remains.
  *
- * The function performs the following operations:
+ * `adopt_frame()` hands the reference the frame is created with to the task
+ * returned by `get_return_object()`. `strong_from_this()` adds references, so
+ * a suspended coroutine can keep itself alive by giving one to whatever will
+ * resume it, which costs a reference count increment instead of an
+ * allocation.
  *
- * 1. Allocates memory for both the object and its control block together
- * 2. Detects at compile time if the type expects a strong_ptr_only_token
- * 3. Constructs the object with appropriate parameters
- * 4. Initializes enable_strong_from_this support if the type inherits from it
- * 5. Returns a strong_ptr managing the newly created object
+ * The provided `final_suspend()` suspends, so that the frame is only destroyed
+ * through its handles. A promise that overrides it must suspend as well, a
+ * frame destroyed by the coroutine itself while owned calls std::terminate.
  *
- * **Token-based construction**: If a class constructor takes
- * `strong_ptr_only_token` as its first parameter, this function automatically
- * provides that token, ensuring the class can only be constructed via
- * make_strong_ptr.
+ * If Promise has a static `get_return_object_on_allocation_failure()`, an
+ * allocation failure returns its result instead of being reported through the
+ * error policy.
  *
- * **Normal construction**: For regular classes, construction proceeds normally
- * with the provided arguments.
+ * The control block is found from the coroutine_handle's address, which GCC
+ * and Clang place at the start of the memory returned by `operator new`.
+ * Builds without NDEBUG verify this and call std::terminate if it does not
+ * hold.
  *
- * **enable_strong_from_this support**: If the constructed type inherits from
- * `enable_strong_from_this<T>`, the weak reference is automatically initialized
- * to enable `strong_from_this()` and `weak_from_this()` functionality.
+ * GCC reports `-Wmismatched-new-delete` for coroutines using this mixin, as it
+ * does not pair an `operator new` template with the class's `operator delete`.
+ * The warning is a false positive and can be disabled around such coroutines.
  *
  * Example usage:
+ * ```
+ * struct task {
+ *   struct promise_type : mem::strong_promise<promise_type> {
+ *     task get_return_object() { return task{ adopt_frame() }; }
+ *     std::suspend_always initial_suspend() noexcept { return {}; }
+ *     void return_void() {}
+ *     void unhandled_exception() { std::terminate(); }
+ *   };
  *
- * ```cpp
- * // Token-protected class (can only be created via make_strong_ptr)
- * class protected_driver {
- * public:
- *   protected_driver(strong_ptr_only_token, driver_config config);
- * };
- * auto driver = make_strong_ptr<protected_driver>(allocator, config{});
+ *   void resume() {
+ *     std::coroutine_handle<promise_type>::from_promise(*m_frame).resume();
+ *   }
  *
- * // Regular class
- * class regular_class {
- * public:
- *   regular_class(int value);
+ *   mem::strong_ptr<promise_type> m_frame;
  * };
- * auto obj = make_strong_ptr<regular_class>(allocator, 42);
  *
- * // Class with enable_strong_from_this support
- * class self_aware : public enable_strong_from_this<self_aware> {
- * public:
- *   self_aware(std::string name);
- *   void register_callback() {
- *     auto self = strong_from_this(); // This works automatically
- *   }
- * };
- * auto obj = make_strong_ptr<self_aware>(allocator, "example");
+ * task blink(std::pmr::memory_resource* p_resource, output_pin& p_led);
  * ```
  *
- * @tparam T The type of object to create
- * @tparam Args Types of arguments to forward to the constructor
- * @param p_memory_resource the memory resource used to allocate memory for the
- * strong_ptr. The memory resource must call `std::terminate` if it is destroyed
- * without all of its memory being freed.
- * @param p_args Arguments to forward to the constructor
- * @return A strong_ptr managing the newly created object
- * @throws Any exception thrown by the object's constructor
- * @throws std::bad_alloc if memory allocation fails
+ * @tparam Promise - the derived promise type
  */
-export template<class T, typename... Args>
-[[nodiscard]] constexpr strong_ptr<T> make_strong_ptr(
-  std::pmr::memory_resource* p_memory_resource,
-  Args&&... p_args)
+export template<class Promise>
+class strong_promise
 {
-  using rc_t = rc<T>;
+public:
+  /**
+   * @brief Allocate the coroutine frame and its control block
+   *
+   * @param p_size - size of the coroutine frame
+   * @param p_args - the arguments of the coroutine
+   * @return void* - the coroutine frame
+   */
+  template<typename... Args>
+    requires(provides_frame_resource<Args...> and
+             not reports_allocation_failure<Promise>)
+  [[nodiscard]] static void* operator new(std::size_t p_size, Args&... p_args)
+  {
+    return coroutine_frame::allocate(frame_allocator(p_args...), p_size);
+  }
+
+  /**
+   * @brief Allocate the coroutine frame and its control block, for promises
+   * that handle allocation failure
+   *
+   * @param p_size - size of the coroutine frame
+   * @param p_args - the arguments of the coroutine
+   * @return void* - the coroutine frame, nullptr if the allocation failed
+   */
+  template<typename... Args>
+    requires(provides_frame_resource<Args...> and
+             reports_allocation_failure<Promise>)
+  [[nodiscard]] static void* operator new(std::size_t p_size,
+                                          Args&... p_args) noexcept
+  {
+    return coroutine_frame::try_allocate(frame_allocator(p_args...), p_size);
+  }
 
-  rc_t* obj = nullptr;
+  /**
+   * @brief Release the memory of the coroutine frame
+   *
+   * @param p_frame - the coroutine frame
+   */
+  static void operator delete(void* p_frame, std::size_t) noexcept
+  {
+    coroutine_frame::release_storage(p_frame);
+  }
 
-  std::pmr::polymorphic_allocator<> allocator(p_memory_resource);
-  if constexpr (std::is_constructible_v<T, strong_ptr_only_token, Args...>) {
-    // Type expects token as first parameter
-    obj = allocator.new_object<rc_t>(p_memory_resource,
-                                     strong_ptr_only_token{},
-                                     std::forward<Args>(p_args)...);
-  } else {
-    // Normal type, construct without token
-    obj = allocator.new_object<rc_t>(p_memory_resource,
-                                     std::forward<Args>(p_args)...);
+  /**
+   * @brief Take the reference the coroutine frame was created with
+   *
+   * Call exactly once, from `get_return_object()`. Calling it again calls
+   * std::terminate.
+   *
+   * @return strong_ptr<Promise> - owner of the coroutine frame
+   */
+  [[nodiscard]] strong_ptr<Promise> adopt_frame() noexcept
+  {
+    auto& self = static_cast<Promise&>(*this);
+    auto* header = header_of(self);
+    if (std::exchange(header->m_adopted, true)) {
+      std::terminate();
+    }
+    return strong_ptr<Promise>(&header->m_info, &self);
   }
 
-  strong_ptr<T> result(&obj->m_info, &obj->m_object);
+  /**
+   * @brief Get a strong_ptr to this promise, which keeps the coroutine frame
+   * alive
+   *
+   * @return strong_ptr<Promise> - shares ownership of the coroutine frame
+   */
+  [[nodiscard]] strong_ptr<Promise> strong_from_this() noexcept
+  {
+    auto& self = static_cast<Promise&>(*this);
+    auto* header = header_of(self);
+    header->m_info.template add_ref<Promise>();
+    return strong_ptr<Promise>(&header->m_info, &self);
+  }
 
-  // Initialize enable_strong_from_this if the type inherits from it
-  if constexpr (std::is_base_of_v<enable_strong_from_this<T>, T>) {
-    result->init_weak_this(obj);
+  /**
+   * @brief Get a weak_ptr to this promise
+   *
+   * @return weak_ptr<Promise> - expires when the coroutine frame is destroyed
+   */
+  [[nodiscard]] weak_ptr<Promise> weak_from_this() noexcept
+  {
+    return strong_from_this();
   }
 
-  return result;
-}
+  /**
+   * @brief Suspend at the end of the coroutine, leaving the destruction of the
+   * frame to its handles
+   */
+  [[nodiscard]] std::suspend_always final_suspend() const noexcept
+  {
+    return {};
+  }
+
+private:
+  friend Promise;
+
+  strong_promise() = default;
+
+  // Find the argument of the coroutine that provides the memory
+  template<typename First, typename... Rest>
+  static constexpr decltype(auto) frame_allocator(First& p_first,
+                                                  Rest&... p_rest) noexcept
+  {
+    if constexpr (std::is_convertible_v<First&, std::pmr::memory_resource*>) {
+      return (p_first);
+    } else {
+      return frame_allocator(p_rest...);
+    }
+  }
+
+  static coroutine_frame* header_of(Promise& p_promise) noexcept
+  {
+    auto handle = std::coroutine_handle<Promise>::from_promise(p_promise);
+    auto* header = coroutine_frame::of(handle.address());
+#if not defined(NDEBUG)
+    if (header->m_info.manager != &coroutine_frame::manage) {
+      // The frame does not start where operator new allocated it
+      std::terminate();
+    }
+#endif
+    return header;
+  }
+};
 }  // namespace mem::inline v1
+
+/**
+ * @brief Hash of the object a strong_ptr points to, consistent with
+ * `operator==`
+ */
+template<typename T>
+struct std::hash<mem::strong_ptr<T>>
+{
+  [[nodiscard]] std::size_t operator()(
+    mem::strong_ptr<T> const& p_ptr) const noexcept
+  {
+    return std::hash<T const*>{}(p_ptr.operator->());
+  }
+};
+
+/**
+ * @brief Hash of the object an optional_ptr points to, consistent with
+ * `operator==`
+ *
+ * All disengaged optional_ptr's hash alike.
+ */
+template<typename T>
+struct std::hash<mem::optional_ptr<T>>
+{
+  [[nodiscard]] std::size_t operator()(
+    mem::optional_ptr<T> const& p_ptr) const noexcept
+  {
+    if (not p_ptr.has_value()) {
+      return std::hash<T const*>{}(nullptr);
+    }
+    return std::hash<T const*>{}(p_ptr.value().operator->());
+  }
+};
@@ -0,0 +1,125 @@
+// Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <atomic>
+#include <thread>
+
+#include <boost/ut.hpp>
+
+import test_util;
+import strong_ptr;
+
+using namespace boost::ut;
+using namespace mem;
+
+namespace {
+constexpr int reader_count = 4;
+constexpr int updates = 2'000;
+
+// atomic_strong_ptr only compiles in thread safe builds, keep its
+// instantiation inside a discarded branch otherwise.
+template<bool ThreadSafe>
+void run_atomic_tests()
+{
+  if constexpr (ThreadSafe) {
+    "load_store_exchange"_test = [&] {
+      atomic_strong_ptr<concurrent_test_class> current(
+        make_strong_ptr<concurrent_test_class>(test_allocator, 1));
+
+      auto value = current.load();
+      expect(that % 1 == value->value());
+      current.store(make_strong_ptr<concurrent_test_class>(test_allocator, 2));
+      expect(that % 1 == value->value()) << "Loaded values are unaffected\n";
+      value = current.load();
+      expect(that % 2 == value->value());
+      value = make_strong_ptr<concurrent_test_class>(test_allocator, 0);
+
+      auto previous = current.exchange(
+        make_strong_ptr<concurrent_test_class>(test_allocator, 3));
+      expect(that % 2 == previous->value());
+      expect(that % 1 == previous.use_count())
+        << "Replaced value is only held by the caller\n";
+
+      strong_ptr<concurrent_test_class> converted = current;
+      expect(that % 3 == converted->value());
+    };
+
+    "compare_exchange"_test = [&] {
+      auto first = make_strong_ptr<concurrent_test_class>(test_allocator, 1);
+      auto second = make_strong_ptr<concurrent_test_class>(test_allocator, 2);
+      atomic_strong_ptr<concurrent_test_class> current(first);
+
+      auto expected = second;
+      expect(not current.compare_exchange_strong(expected, second));
+      expect(expected == first) << "Expected is updated on failure\n";
+
+      expect(current.compare_exchange_weak(expected, second));
+      expect(current.load() == second);
+      expect(that % 2 == first.use_count())
+        << "Replaced value only held by first and expected\n";
+    };
+
+    "concurrent_readers_and_writer"_test = [&] {
+      {
+        atomic_strong_ptr<concurrent_test_class> current(
+          make_strong_ptr<concurrent_test_class>(test_allocator, 0));
+        std::atomic<bool> done = false;
+        std::array<std::thread, reader_count> readers;
+
+        for (auto& reader : readers) {
+          reader = std::thread([&] {
+            int last_version = 0;
+            while (not done) {
+              auto value = current.load();
+              // Readers must always observe a living object and versions must
+              // never go backwards
+              expect(value->alive());
+              expect(that % value->value() >= last_version);
+              last_version = value->value();
+            }
+          });
+        }
+
+        for (int i = 1; i <= updates; i++) {
+          current.store(
+            make_strong_ptr<concurrent_test_class>(test_allocator, i));
+        }
+        done = true;
+
+        for (auto& reader : readers) {
+          reader.join();
+        }
+        auto last = current.load();
+        expect(that % updates == last->value());
+      }
+      expect(that % 0 == concurrent_test_class::instance_count.load())
+        << "Every object should be destroyed exactly once\n";
+    };
+  }
+}
+}  // namespace
+
+void run_test() noexcept
+{
+  // NOLINTBEGIN(performance-unnecessary-copy-initialization)
+  run_atomic_tests<thread_safe_ref_count>();
+  // NOLINTEND(performance-unnecessary-copy-initialization)
+}
+
+int main()
+{
+  run_test();
+  return 0;
+}
@@ -0,0 +1,194 @@
+// Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+#include <boost/ut.hpp>
+
+import test_util;
+import strong_ptr;
+
+using namespace boost::ut;
+using namespace mem;
+
+namespace {
+std::array<std::byte, 1024> static_buffer{};
+std::pmr::monotonic_buffer_resource static_arena{ static_buffer.data(),
+                                                  static_buffer.size() };
+auto static_monotonic = mem::make_monotonic_allocator<256>();
+
+using static_arena_t = static_resource_t<static_arena>;
+
+constexpr std::size_t align_up(std::size_t p_size, std::size_t p_align)
+{
+  return (p_size + p_align - 1) / p_align * p_align;
+}
+
+// A control block is a manager function pointer plus two counts
+constexpr std::size_t control_block_size =
+  align_up(sizeof(void*) + (2 * sizeof(ref_count_t)), alignof(void*));
+
+// Guard against the control block quietly growing
+static_assert(rc_size_v<std::uint8_t, static_arena_t> ==
+                align_up(control_block_size + 1, alignof(void*)),
+              "Control block with a static resource has grown");
+static_assert(rc_size_v<std::uint64_t, static_arena_t> ==
+                control_block_size + sizeof(std::uint64_t),
+              "Control block with a static resource has grown");
+static_assert(rc_size_v<std::uint8_t> ==
+                rc_size_v<std::uint8_t, static_arena_t> + sizeof(void*),
+              "A runtime memory resource should cost exactly one pointer");
+static_assert(rc_size_v<std::uint64_t> ==
+                rc_size_v<std::uint64_t, static_arena_t> + sizeof(void*),
+              "A runtime memory resource should cost exactly one pointer");
+
+// Read by every core while other cores copy strong_ptrs to it
+struct hot_object
+{
+  std::uint32_t value = 0;
+};
+
+class isolated_compact_class
+  : public enable_strong_from_this_compact<isolated_compact_class>
+{
+public:
+  explicit isolated_compact_class(strong_ptr_only_token p_token)
+    : enable_strong_from_this_compact(p_token)
+  {
+  }
+};
+}  // namespace
+
+template<>
+constexpr bool mem::isolate_control_block<hot_object> = true;
+
+template<>
+constexpr bool mem::isolate_control_block<isolated_compact_class> = true;
+
+static_assert(rc_size_v<hot_object, static_arena_t> == 2 * cache_line_size,
+              "Control block and object occupy separate cache lines");
+static_assert(rc_size_v<hot_object> == 2 * cache_line_size,
+              "The resource shares the object's cache line");
+
+void run_test() noexcept
+{
+  // NOLINTBEGIN(performance-unnecessary-copy-initialization)
+  "static_resource_construction"_test = [&] {
+    {
+      auto ptr = make_strong_ptr<test_class>(static_resource<static_arena>, 42);
+      expect(that % 42 == ptr->value());
+      expect(that % 1 == ptr.use_count());
+      expect(that % 1 == test_class::instance_count);
+      expect(ptr.get_allocator() == &static_arena)
+        << "Allocator is recovered without being stored\n";
+
+      weak_ptr<test_class> weak = ptr;
+      auto copy = ptr;
+      expect(that % 2 == ptr.use_count());
+      expect(not weak.expired());
+    }
+    expect(that % 0 == test_class::instance_count);
+  };
+
+  "static_monotonic_allocator_is_balanced"_test = [&] {
+    {
+      auto ptr =
+        make_strong_ptr<self_aware_class>(static_resource<static_monotonic>, 7);
+      auto self = ptr->get_self();
+      expect(that % 7 == self->value());
+      expect(that % 2 == ptr.use_count());
+      expect(ptr.get_allocator() == static_monotonic.resource());
+    }
+    // The allocator terminates at exit if anything was left allocated
+  };
+
+  "final_release_paths"_test = [&] {
+    auto allocator = mem::make_monotonic_allocator<256>();
+    {
+      auto ptr = make_strong_ptr<std::uint32_t>(allocator, 1U);
+      expect(that % rc_size_v<std::uint32_t> == allocator.stats().live_bytes);
+    }
+    expect(that % 0U == allocator.stats().live_bytes)
+      << "Unobserved release destroys and deallocates at once\n";
+
+    weak_ptr<test_class> weak;
+    {
+      auto ptr = make_strong_ptr<test_class>(allocator, 2);
+      weak = ptr;
+    }
+    expect(that % 0 == test_class::instance_count);
+    expect(that % rc_size_v<test_class> == allocator.stats().live_bytes)
+      << "Observed release keeps the control block\n";
+    weak = weak_ptr<test_class>{};
+    expect(that % 0U == allocator.stats().live_bytes);
+
+    {
+      auto array = make_strong_array<test_class>(allocator, 3, 4);
+      expect(that % 3 == test_class::instance_count);
+    }
+    expect(that % 0 == test_class::instance_count);
+    expect(that % 0U == allocator.stats().live_bytes);
+  };
+
+  "isolated_control_block"_test = [&] {
+    auto const line_of = [](void const* p_address) {
+      return reinterpret_cast<std::uintptr_t>(p_address) / cache_line_size;
+    };
+
+    auto ptr = make_strong_ptr<hot_object>(test_allocator);
+    auto const* object = &*ptr;
+    expect(that % 0U ==
+           reinterpret_cast<std::uintptr_t>(object) % cache_line_size)
+      << "Object must start on a cache line\n";
+
+    // The control block sits immediately in front of the object
+    auto const* control_block =
+      reinterpret_cast<std::byte const*>(object) - cache_line_size;
+    expect(line_of(control_block) != line_of(object));
+
+    auto copy = ptr;
+    copy->value = 5;
+    expect(that % 5U == ptr->value);
+    expect(that % 2 == ptr.use_count());
+  };
+
+  "isolated_compact_self"_test = [&] {
+    auto ptr = make_strong_ptr<isolated_compact_class>(test_allocator);
+    auto self = ptr->strong_from_this();
+    expect(that % 2 == ptr.use_count())
+      << "Control block is found across the padding\n";
+  };
+
+  "isolated_strong_array"_test = [&] {
+    auto allocator = mem::make_monotonic_allocator<4 * cache_line_size>();
+    {
+      auto array = make_strong_array<hot_object>(allocator, 3);
+      expect(that % 0U == reinterpret_cast<std::uintptr_t>(array->data()) %
+                            cache_line_size);
+      expect(that % 3U == array->size());
+    }
+    expect(that % 0U == allocator.stats().live_bytes);
+  };
+
+  // NOLINTEND(performance-unnecessary-copy-initialization)
+}
+
+int main()
+{
+  run_test();
+  return 0;
+}
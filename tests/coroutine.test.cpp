@@ -0,0 +1,263 @@
+// Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <coroutine>
+#include <exception>
+#include <memory_resource>
+#include <utility>
+
+#include <boost/ut.hpp>
+
+import test_util;
+import strong_ptr;
+
+using namespace boost::ut;
+using namespace mem;
+
+namespace {
+struct task
+{
+  struct promise_type : strong_promise<promise_type>
+  {
+    task get_return_object()
+    {
+      return task{ adopt_frame() };
+    }
+
+    std::suspend_always initial_suspend() noexcept
+    {
+      return {};
+    }
+
+    void return_value(int p_value)
+    {
+      result = p_value;
+    }
+
+    void unhandled_exception()
+    {
+      std::terminate();
+    }
+
+    int result = 0;
+  };
+
+  void resume()
+  {
+    std::coroutine_handle<promise_type>::from_promise(*frame).resume();
+  }
+
+  [[nodiscard]] bool done() const
+  {
+    auto& promise = *frame;
+    return std::coroutine_handle<promise_type>::from_promise(promise).done();
+  }
+
+  strong_ptr<promise_type> frame;
+};
+
+// Task that reports a failed frame allocation by being empty
+struct fallible_task
+{
+  struct promise_type : strong_promise<promise_type>
+  {
+    static fallible_task get_return_object_on_allocation_failure()
+    {
+      return fallible_task{};
+    }
+
+    fallible_task get_return_object()
+    {
+      return fallible_task{ adopt_frame() };
+    }
+
+    std::suspend_always initial_suspend() noexcept
+    {
+      return {};
+    }
+
+    void return_void()
+    {
+    }
+
+    void unhandled_exception()
+    {
+      std::terminate();
+    }
+  };
+
+  optional_ptr<promise_type> frame;
+};
+
+// Stands in for an I/O driver that resumes the coroutine waiting on it
+struct event
+{
+  void fire()
+  {
+    auto waiter = std::exchange(waiting, nullptr);
+    std::coroutine_handle<task::promise_type>::from_promise(*waiter).resume();
+  }
+
+  optional_ptr<task::promise_type> waiting;
+};
+
+struct wait_for
+{
+  [[nodiscard]] bool await_ready() const noexcept
+  {
+    return false;
+  }
+
+  void await_suspend(std::coroutine_handle<task::promise_type> p_handle)
+  {
+    // The suspended coroutine keeps itself alive through the event
+    source->waiting = p_handle.promise().strong_from_this();
+  }
+
+  void await_resume() const noexcept
+  {
+  }
+
+  event* source;
+};
+
+// GCC does not pair the operator new template of a promise with its operator
+// delete, and reports every coroutine using strong_promise as mismatched
+#if defined(__GNUC__) and not defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+task add(std::pmr::memory_resource*, int p_lhs, int p_rhs)
+{
+  co_return p_lhs + p_rhs;
+}
+
+task wait_then_return(monotonic_allocator<1024>&, event& p_event)
+{
+  test_class const local(11);
+  co_await wait_for{ &p_event };
+  co_return local.value();
+}
+
+fallible_task nothing(monotonic_allocator<64>&)
+{
+  co_return;
+}
+
+#if defined(__GNUC__) and not defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+}  // namespace
+
+void run_test() noexcept
+{
+  // NOLINTBEGIN(performance-unnecessary-copy-initialization)
+  "frame_from_memory_resource"_test = [&] {
+    auto allocator = make_monotonic_allocator<1024>();
+    {
+      auto running = add(allocator, 1, 2);
+      expect(that % coroutine_frame_overhead < allocator.stats().live_bytes)
+        << "The frame and its control block come from the resource\n";
+      expect(that % allocator.resource() == running.frame.get_allocator());
+      expect(that % 1 == running.frame.use_count());
+
+      running.resume();
+      expect(running.done());
+      expect(that % 3 == running.frame->result);
+      expect(that % 0U < allocator.stats().live_bytes)
+        << "A finished frame lives until its last handle drops\n";
+    }
+    expect(that % 0U == allocator.stats().live_bytes);
+  };
+
+  "destroyed_while_suspended"_test = [&] {
+    auto allocator = make_monotonic_allocator<1024>();
+    event pending;
+    {
+      auto waiting = wait_then_return(allocator, pending);
+      waiting.resume();
+      expect(not waiting.done());
+      expect(that % 2 == waiting.frame.use_count());
+      expect(that % 1 == test_class::instance_count);
+    }
+    expect(that % 1 == test_class::instance_count)
+      << "The suspended coroutine keeps itself alive\n";
+
+    pending.waiting.reset();
+    expect(that % 0 == test_class::instance_count)
+      << "Dropping the last handle destroys the suspended frame\n";
+    expect(that % 0U == allocator.stats().live_bytes);
+  };
+
+  "self_owning_task_runs_to_completion"_test = [&] {
+    auto allocator = make_monotonic_allocator<1024>();
+    event pending;
+    weak_ptr<task::promise_type> observer;
+    {
+      auto waiting = wait_then_return(allocator, pending);
+      observer = waiting.frame->weak_from_this();
+      waiting.resume();
+    }
+    expect(not observer.expired());
+
+    pending.fire();
+    expect(observer.expired())
+      << "The frame is destroyed when the resumer drops its handle\n";
+    expect(that % 0 == test_class::instance_count);
+    expect(that % 0U < allocator.stats().live_bytes)
+      << "The weak_ptr keeps the memory, but not the frame, alive\n";
+
+    observer = weak_ptr<task::promise_type>{};
+    expect(that % 0U == allocator.stats().live_bytes);
+  };
+
+  "result_survives_until_handle_drops"_test = [&] {
+    auto allocator = make_monotonic_allocator<1024>();
+    event pending;
+    auto waiting = wait_then_return(allocator, pending);
+    waiting.resume();
+    pending.fire();
+    expect(waiting.done());
+    expect(that % 11 == waiting.frame->result);
+    expect(that % 1 == waiting.frame.use_count());
+  };
+
+  "allocation_failure"_test = [&] {
+    auto allocator = make_monotonic_allocator<64>();
+    auto failed = nothing(allocator);
+    expect(that % false == failed.frame.has_value())
+      << "A frame that does not fit yields the fallback object\n";
+    expect(that % 0U == allocator.stats().live_bytes);
+  };
+
+// NOTE: Abort testing does not work on Windows
+#if not defined(_WIN32) and not defined(_WIN64)
+  "adopting_twice_terminates"_test = [&] {
+    expect(aborts([] {
+      auto allocator = make_monotonic_allocator<1024>();
+      auto running = add(allocator, 1, 2);
+      auto second = running.frame->adopt_frame();
+    }))
+      << "std::terminate not called.\n";
+  };
+#endif
+  // NOLINTEND(performance-unnecessary-copy-initialization)
+}
+
+int main()
+{
+  run_test();
+  return 0;
+}
@@ -0,0 +1,130 @@
+// Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <boost/ut.hpp>
+
+import test_util;
+import strong_ptr;
+
+using namespace boost::ut;
+using namespace mem;
+
+namespace {
+// Releases another deferred object from its destructor
+struct chain_link
+{
+  explicit chain_link(optional_ptr<chain_link> p_next)
+    : next(std::move(p_next))
+  {
+  }
+
+  optional_ptr<chain_link> next;
+};
+}  // namespace
+
+void run_test() noexcept
+{
+  // NOLINTBEGIN(performance-unnecessary-copy-initialization)
+  "destruction_is_deferred"_test = [&] {
+    deferred_destruction_domain domain;
+    weak_ptr<test_class> weak;
+    {
+      auto ptr = make_deferred_strong_ptr<test_class>(domain, test_allocator, 4);
+      weak = ptr;
+      expect(domain.empty());
+    }
+
+    expect(that % 1 == test_class::instance_count)
+      << "Releasing the last reference must not run the destructor\n";
+    expect(weak.expired()) << "Deferred objects can no longer be locked\n";
+    expect(not weak.lock());
+    expect(not domain.empty());
+
+    expect(that % 1U == domain.drain());
+    expect(that % 0 == test_class::instance_count);
+    expect(domain.empty());
+  };
+
+  "drain_budget"_test = [&] {
+    deferred_destruction_domain domain;
+    for (int i = 0; i < 5; i++) {
+      auto ptr = make_deferred_strong_ptr<test_class>(domain, test_allocator, i);
+    }
+    expect(that % 5 == test_class::instance_count);
+
+    expect(that % 2U == domain.drain(2));
+    expect(that % 3 == test_class::instance_count);
+    expect(that % 3U == domain.drain(10));
+    expect(that % 0U == domain.drain());
+  };
+
+  "memory_returned_after_drain"_test = [&] {
+    auto allocator = mem::make_monotonic_allocator<256>();
+    deferred_destruction_domain domain;
+    {
+      auto ptr = make_deferred_strong_ptr<test_class>(domain, allocator, 1);
+    }
+    expect(that % 0U < allocator.stats().live_bytes)
+      << "Memory stays allocated until drained\n";
+    domain.drain();
+    expect(that % 0U == allocator.stats().live_bytes);
+  };
+
+  "weak_ptr_outlives_drain"_test = [&] {
+    deferred_destruction_domain domain;
+    weak_ptr<test_class> weak;
+    {
+      auto ptr = make_deferred_strong_ptr<test_class>(domain, test_allocator, 1);
+      weak = ptr;
+    }
+    domain.drain();
+    expect(that % 0 == test_class::instance_count);
+    expect(weak.expired()) << "Control block still valid for the weak_ptr\n";
+  };
+
+  "destructor_releases_more_objects"_test = [&] {
+    deferred_destruction_domain domain;
+    {
+      auto tail = make_deferred_strong_ptr<chain_link>(
+        domain, test_allocator, optional_ptr<chain_link>{});
+      auto head = make_deferred_strong_ptr<chain_link>(
+        domain, test_allocator, optional_ptr<chain_link>(tail));
+    }
+    expect(that % 1U == domain.drain(1)) << "Only head is queued at first\n";
+    expect(not domain.empty()) << "Head destructor queued the tail\n";
+    expect(that % 1U == domain.drain());
+    expect(domain.empty());
+  };
+
+// NOTE: Abort testing does not work on Windows
+#if not defined(_WIN32) and not defined(_WIN64)
+  "domain_outlived_by_object"_test = [&] {
+    expect(aborts([] {
+      auto allocator = mem::make_monotonic_allocator<256>();
+      auto domain = new deferred_destruction_domain;
+      [[maybe_unused]] auto ptr =
+        make_deferred_strong_ptr<int>(*domain, allocator, 1);
+      delete domain;
+    }))
+      << "std::terminate not called.\n";
+  };
+#endif
+  // NOLINTEND(performance-unnecessary-copy-initialization)
+}
+
+int main()
+{
+  run_test();
+  return 0;
+}
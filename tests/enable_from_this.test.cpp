@@ -20,6 +20,37 @@ import strong_ptr;
 using namespace boost::ut;
 using namespace mem;
 
+namespace {
+class compact_class : public enable_strong_from_this_compact<compact_class>
+{
+public:
+  compact_class(strong_ptr_only_token p_token, int p_value)
+    : enable_strong_from_this_compact(p_token)
+    , m_value(p_value)
+  {
+  }
+
+  [[nodiscard]] int value() const
+  {
+    return m_value;
+  }
+
+private:
+  int m_value;
+};
+
+// Over aligned to check that the object offset follows the rc layout
+class alignas(32) aligned_compact_class
+  : public enable_strong_from_this_compact<aligned_compact_class>
+{
+public:
+  explicit aligned_compact_class(strong_ptr_only_token p_token)
+    : enable_strong_from_this_compact(p_token)
+  {
+  }
+};
+}  // namespace
+
 void run_test() noexcept
 {
   // NOLINTBEGIN(performance-unnecessary-copy-initialization)
@@ -66,10 +97,15 @@ void run_test() noexcept
 
     // Just verify that normal usage works
     auto obj = make_strong_ptr<self_aware_class>(test_allocator, 42);
-    expect(nothrow([&] {
+    auto get_self = [&] {
       auto self = obj->get_self();
       expect(that % 42 == self->value());
-    }));
+    };
+#if defined(__cpp_exceptions)
+    expect(nothrow(get_self));
+#else
+    get_self();
+#endif
   };
 
   "weak_reference_lifecycle"_test = [&] {
@@ -111,6 +147,45 @@ void run_test() noexcept
     expect(that % 100 == locked2->value())
       << "Second object should retain its value";
   };
+
+  "compact_functionality"_test = [&] {
+    static_assert(sizeof(compact_class) == sizeof(int),
+                  "Compact base must not add any storage");
+    auto obj = make_strong_ptr<compact_class>(test_allocator, 42);
+
+    auto self = obj->strong_from_this();
+    expect(that % 2 == obj.use_count()) << "Should share ownership";
+    expect(obj.operator->() == self.operator->())
+      << "Should point to same object";
+    expect(that % 42 == self->value());
+
+    auto const& const_obj = *obj;
+    auto const_self = const_obj.strong_from_this();
+    expect(that % 3 == obj.use_count());
+
+    weak_ptr<compact_class> weak = obj->weak_from_this();
+    expect(not weak.expired());
+  };
+
+  "compact_lifecycle"_test = [&] {
+    weak_ptr<compact_class> weak;
+    {
+      auto obj = make_strong_ptr<compact_class>(test_allocator, 7);
+      weak = obj->weak_from_this();
+      auto locked = weak.lock();
+      expect(that % 7 == locked->value());
+    }
+    expect(weak.expired()) << "Object should be destroyed";
+
+    auto allocator = mem::make_monotonic_allocator<256>();
+    {
+      auto aligned = make_strong_ptr<aligned_compact_class>(allocator);
+      auto self = aligned->strong_from_this();
+      expect(that % 2 == aligned.use_count());
+      expect(that % allocator.resource() == self.get_allocator())
+        << "Recovered control block must be the real one";
+    }
+  };
   // NOLINTEND(performance-unnecessary-copy-initialization)
 }
 
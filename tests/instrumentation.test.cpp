@@ -0,0 +1,94 @@
+// Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <boost/ut.hpp>
+
+import test_util;
+import strong_ptr;
+
+using namespace boost::ut;
+using namespace mem;
+
+void run_test() noexcept
+{
+  // NOLINTBEGIN(performance-unnecessary-copy-initialization)
+  if constexpr (ref_count_instrumentation) {
+    "strong_operations"_test = [&] {
+      reset_ref_count_stats<test_class>();
+      {
+        auto ptr = make_strong_ptr<test_class>(test_allocator, 1);
+        auto copy = ptr;
+        auto another = copy;
+      }
+      auto const stats = ref_count_stats_for<test_class>();
+      expect(that % 3U == stats.strong_increments)
+        << "Creation and two copies\n";
+      expect(that % 3U == stats.strong_decrements);
+      expect(that % 1U == stats.destructions);
+    };
+
+    "weak_operations"_test = [&] {
+      reset_ref_count_stats<test_class>();
+      weak_ptr<test_class> weak;
+      {
+        auto ptr = make_strong_ptr<test_class>(test_allocator, 1);
+        weak = ptr;
+        auto locked = weak.lock();
+      }
+      auto failed = weak.lock();
+      weak = weak_ptr<test_class>{};
+
+      auto const stats = ref_count_stats_for<test_class>();
+      expect(that % 2U == stats.strong_increments)
+        << "Creation and a successful lock\n";
+      expect(that % 1U == stats.failed_locks);
+      expect(that % stats.weak_increments == stats.weak_decrements);
+      expect(that % 1U <= stats.weak_increments);
+    };
+
+    "per_type_and_totals"_test = [&] {
+      reset_ref_count_stats<>();
+      reset_ref_count_stats<test_class>();
+      reset_ref_count_stats<int>();
+      {
+        auto object = make_strong_ptr<test_class>(test_allocator, 1);
+        auto number = make_strong_ptr<int>(test_allocator, 2);
+        strong_ptr<int const> constant = number;
+      }
+
+      expect(that % 1U == ref_count_stats_for<test_class>().strong_increments);
+      expect(that % 2U == ref_count_stats_for<int>().strong_increments)
+        << "int const is counted as int\n";
+      expect(that % 3U == ref_count_stats_for<>().strong_increments)
+        << "Totals include every type\n";
+      expect(that % 2U == ref_count_stats_for<>().destructions);
+    };
+  } else {
+    "disabled"_test = [&] {
+      auto ptr = make_strong_ptr<test_class>(test_allocator, 1);
+      auto copy = ptr;
+      auto const stats = ref_count_stats_for<test_class>();
+      expect(that % 0U == stats.strong_increments)
+        << "Nothing is recorded when instrumentation is disabled\n";
+      expect(that % 0U == ref_count_stats_for<>().strong_increments);
+    };
+  }
+  // NOLINTEND(performance-unnecessary-copy-initialization)
+}
+
+int main()
+{
+  run_test();
+  return 0;
+}
@@ -0,0 +1,114 @@
+// Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+
+#include <boost/ut.hpp>
+
+import test_util;
+import strong_ptr;
+
+using namespace boost::ut;
+using namespace mem;
+
+namespace {
+struct holder
+{
+  self_aware_class inner{ 3 };
+};
+}  // namespace
+
+void run_test() noexcept
+{
+  // NOLINTBEGIN(performance-unnecessary-copy-initialization)
+  "single_pointer"_test = [&] {
+    using handle = intrusive_strong_ptr<self_aware_class>;
+    static_assert(sizeof(handle) == sizeof(void*));
+    static_assert(sizeof(std::array<handle, 8>) ==
+                  sizeof(std::array<strong_ptr<self_aware_class>, 4>));
+  };
+
+  "conversion"_test = [&] {
+    auto strong = make_strong_ptr<self_aware_class>(test_allocator, 42);
+    intrusive_strong_ptr<self_aware_class> intrusive = strong;
+
+    expect(that % 2 == strong.use_count());
+    expect(that % 2 == intrusive.use_count());
+    expect(that % 42 == intrusive->value());
+
+    strong_ptr<self_aware_class> back = intrusive;
+    expect(that % 3 == back.use_count());
+    expect(&*back == &*intrusive);
+  };
+
+  "copy_and_assignment"_test = [&] {
+    intrusive_strong_ptr<self_aware_class> first =
+      make_strong_ptr<self_aware_class>(test_allocator, 1);
+    intrusive_strong_ptr<self_aware_class> second =
+      make_strong_ptr<self_aware_class>(test_allocator, 2);
+    expect(that % 1 == first.use_count());
+
+    weak_ptr<self_aware_class> weak = strong_ptr<self_aware_class>(second);
+    {
+      auto copy = first;
+      expect(that % 2 == first.use_count());
+    }
+    expect(that % 1 == first.use_count());
+
+    second = first;
+    expect(weak.expired()) << "Previous object should be released\n";
+    expect(that % 2 == first.use_count());
+    expect(that % 1 == second->value());
+  };
+
+  "lifetime"_test = [&] {
+    weak_ptr<self_aware_class> weak;
+    {
+      intrusive_strong_ptr<self_aware_class> intrusive =
+        make_strong_ptr<self_aware_class>(test_allocator, 5);
+      weak = intrusive->get_weak_self();
+      expect(not weak.expired())
+        << "Intrusive handle alone keeps the object alive\n";
+    }
+    expect(weak.expired());
+  };
+
+  "ownership_mismatch"_test = [&] {
+    auto parent = make_strong_ptr<holder>(test_allocator);
+    strong_ptr<self_aware_class> member(parent, &holder::inner);
+
+#if defined(__cpp_exceptions)
+    expect(throws<mem::ownership_mismatch>([&] {
+      intrusive_strong_ptr<self_aware_class> intrusive = member;
+    }))
+      << "Member aliases do not own the object they point to\n";
+#endif
+    expect(that % 2 == parent.use_count());
+  };
+
+  "array_element"_test = [&] {
+    auto array = make_strong_array<self_aware_class>(test_allocator, 2, 8);
+    intrusive_strong_ptr<self_aware_class> element =
+      strong_ptr<self_aware_class>(array, 1);
+    expect(that % 2 == array.use_count());
+    expect(that % 8 == element->value());
+  };
+  // NOLINTEND(performance-unnecessary-copy-initialization)
+}
+
+int main()
+{
+  run_test();
+  return 0;
+}
@@ -12,6 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
 #include <boost/ut.hpp>
 
 import test_util;
@@ -20,6 +27,53 @@ import strong_ptr;
 using namespace boost::ut;
 using namespace mem;
 
+namespace {
+// Records which path was used to allocate memory
+struct counting_resource : public std::pmr::memory_resource
+{
+  void* do_allocate(std::size_t p_bytes, std::size_t p_alignment) override
+  {
+    virtual_allocations++;
+    return m_upstream->allocate(p_bytes, p_alignment);
+  }
+
+  void do_deallocate(void* p_address,
+                     std::size_t p_bytes,
+                     std::size_t p_alignment) override
+  {
+    deallocations++;
+    m_upstream->deallocate(p_address, p_bytes, p_alignment);
+  }
+
+  [[nodiscard]] bool do_is_equal(
+    std::pmr::memory_resource const& p_other) const noexcept override
+  {
+    return this == &p_other;
+  }
+
+  std::pmr::memory_resource* m_upstream = test_allocator;
+  int virtual_allocations = 0;
+  int deallocations = 0;
+};
+
+struct counting_allocator
+{
+  [[nodiscard]] void* allocate(std::size_t p_bytes, std::size_t p_alignment)
+  {
+    direct_allocations++;
+    return m_resource.m_upstream->allocate(p_bytes, p_alignment);
+  }
+
+  std::pmr::memory_resource* resource()
+  {
+    return &m_resource;
+  }
+
+  counting_resource m_resource;
+  int direct_allocations = 0;
+};
+}  // namespace
+
 void run_test() noexcept
 {
   // NOLINTBEGIN(performance-unnecessary-copy-initialization)
@@ -56,6 +110,7 @@ void run_test() noexcept
     expect(that % 1 == *int_ptr1) << "Int assignment failed.\n";
     expect(that % 2 == *int_ptr2) << "Int assignment failed.\n";
 
+#if defined(__cpp_exceptions)
     expect(throws<std::bad_alloc>([&] {
       auto volatile ptr3 =
         allocator->allocate(sizeof(std::uint32_t), alignof(std::uint32_t));
@@ -69,11 +124,163 @@ void run_test() noexcept
       expect(that % 3 == *int_ptr3) << "Int assignment failed.\n";
     }))
       << "Exception not thrown when bad alloc happens.\n";
+#endif
 
     allocator->deallocate(ptr1, sizeof(std::uint32_t));
     allocator->deallocate(ptr2, sizeof(std::uint32_t));
   };
 
+  "stats_test"_test = [&] {
+    auto allocator = mem::make_monotonic_allocator<64>();
+    auto stats = allocator.stats();
+    expect(that % 0U == stats.live_bytes);
+    expect(that % 0U == stats.consumed_bytes);
+    expect(that % 64U == stats.remaining_bytes);
+    expect(that % 64U == stats.capacity_bytes);
+
+    auto* ptr1 = allocator->allocate(sizeof(char), alignof(char));
+    auto* ptr2 =
+      allocator->allocate(sizeof(std::uint64_t), alignof(std::uint64_t));
+    stats = allocator.stats();
+
+    expect(that % (sizeof(char) + sizeof(std::uint64_t)) == stats.live_bytes);
+    expect(that % stats.consumed_bytes >= stats.live_bytes)
+      << "Consumed bytes include alignment padding.\n";
+    expect(that % 64U == stats.consumed_bytes + stats.remaining_bytes);
+    expect(that % stats.consumed_bytes == stats.high_water_mark_bytes);
+
+    allocator->deallocate(ptr1, sizeof(char));
+    allocator->deallocate(ptr2, sizeof(std::uint64_t));
+    expect(that % 0U == allocator.stats().live_bytes);
+  };
+
+  "rewind_test"_test = [&] {
+    auto allocator =
+      mem::make_monotonic_allocator<rc_size_v<std::uint64_t>>();
+
+    {
+      auto ptr = make_strong_ptr<std::uint64_t>(allocator, 1U);
+      expect(not allocator.rewind())
+        << "Rewind must be refused while memory is live.\n";
+      expect(that % 1U == *ptr);
+    }
+    auto const high_water_mark = allocator.stats().high_water_mark_bytes;
+#if defined(__cpp_exceptions)
+    expect(throws<std::bad_alloc>(
+      [&] { auto ptr = make_strong_ptr<std::uint64_t>(allocator, 2U); }))
+      << "Arena should be exhausted before rewinding.\n";
+#endif
+
+    expect(allocator.rewind());
+    expect(that % 0U == allocator.stats().consumed_bytes);
+    expect(that % high_water_mark == allocator.stats().high_water_mark_bytes)
+      << "High water mark survives rewinding.\n";
+
+    // Reuse the same arena for another frame
+    for (int frame = 0; frame < 4; frame++) {
+      {
+        auto ptr = make_strong_ptr<std::uint64_t>(allocator, 3U);
+        expect(that % 3U == *ptr);
+      }
+      expect(allocator.rewind());
+    }
+  };
+
+  "direct_allocation_test"_test = [&] {
+    static_assert(direct_allocator<decltype(make_monotonic_allocator<8>())>);
+    static_assert(not direct_allocator<std::pmr::memory_resource*>);
+
+    counting_allocator allocator;
+    {
+      auto ptr = make_strong_ptr<test_class>(allocator, 5);
+      expect(that % 5 == ptr->value());
+      expect(that % 1 == allocator.direct_allocations);
+      expect(that % 0 == allocator.m_resource.virtual_allocations)
+        << "Concrete allocators must bypass do_allocate.\n";
+      expect(that % allocator.resource() == ptr.get_allocator())
+        << "The control block stores the type erased resource.\n";
+    }
+    expect(that % 1 == allocator.m_resource.deallocations);
+
+    auto arena = make_monotonic_allocator<64>();
+    {
+      auto ptr = make_strong_ptr<test_class>(arena, 7);
+      expect(that % 7 == ptr->value());
+      expect(that % rc_size_v<test_class> == arena.stats().live_bytes);
+    }
+    expect(that % 0U == arena.stats().live_bytes);
+  };
+
+  "concurrent_allocation_test"_test = [&] {
+    constexpr std::size_t thread_count = 4;
+    constexpr std::size_t blocks_per_thread = 64;
+    constexpr std::size_t block_size = 16;
+    auto allocator = mem::make_concurrent_monotonic_allocator<
+      (thread_count * blocks_per_thread * block_size) + block_size>();
+    std::array<std::vector<void*>, thread_count> blocks;
+    std::array<std::thread, thread_count> threads;
+
+    for (std::size_t i = 0; i < thread_count; i++) {
+      threads[i] = std::thread([&, i] {
+        for (std::size_t j = 0; j < blocks_per_thread; j++) {
+          auto* block = allocator->allocate(block_size, block_size);
+          std::memset(block, static_cast<int>(i), block_size);
+          blocks[i].push_back(block);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    auto const stats = allocator.stats();
+    expect(that % (thread_count * blocks_per_thread * block_size) ==
+           stats.live_bytes);
+    expect(that % stats.consumed_bytes == stats.high_water_mark_bytes);
+    for (std::size_t i = 0; i < thread_count; i++) {
+      for (auto* block : blocks[i]) {
+        auto const* bytes = static_cast<unsigned char const*>(block);
+        expect(that % i == bytes[0]) << "Blocks must never overlap\n";
+        expect(that % i == bytes[block_size - 1]);
+      }
+    }
+
+    // Free every block on a different thread than the one that allocated it
+    for (std::size_t i = 0; i < thread_count; i++) {
+      threads[i] = std::thread([&, i] {
+        for (auto* block : blocks[(i + 1) % thread_count]) {
+          allocator->deallocate(block, block_size, block_size);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    expect(that % 0U == allocator.stats().live_bytes);
+    expect(allocator.rewind());
+    expect(that % 0U == allocator.stats().consumed_bytes);
+  };
+
+  "concurrent_strong_ptr_test"_test = [&] {
+    auto allocator = mem::make_concurrent_monotonic_allocator<
+      4 * rc_size_v<std::uint64_t>>();
+    static_assert(direct_allocator<decltype(allocator)>);
+    {
+      auto ptr = make_strong_ptr<std::uint64_t>(allocator, 8U);
+      std::thread([ptr = std::move(ptr)] { expect(that % 8U == *ptr); })
+        .join();
+    }
+    expect(that % 0U == allocator.stats().live_bytes)
+      << "Released on another thread\n";
+#if defined(__cpp_exceptions)
+    expect(throws<std::bad_alloc>([&] {
+      [[maybe_unused]] auto volatile ptr = allocator->allocate(
+        (4 * rc_size_v<std::uint64_t>) + 1, alignof(std::uint64_t));
+    }));
+#endif
+  };
+
 // NOTE: Abort testing does not work on Windows
 #if not defined(_WIN32) and not defined(_WIN64)
   "termination_test"_test = [&] {
@@ -84,6 +291,15 @@ void run_test() noexcept
     }))
       << "std::terminate not called.\n";
   };
+
+  "concurrent_termination_test"_test = [&] {
+    expect(aborts([] {
+      auto allocator = mem::make_concurrent_monotonic_allocator<32>();
+      [[maybe_unused]] auto ptr =
+        allocator->allocate(sizeof(std::uint32_t), alignof(std::uint32_t));
+    }))
+      << "std::terminate not called.\n";
+  };
 #endif
   // NOLINTEND(performance-unnecessary-copy-initialization)
 }
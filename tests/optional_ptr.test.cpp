@@ -12,6 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 #include <boost/ut.hpp>
 
 import test_util;
@@ -23,6 +27,112 @@ using namespace mem;
 void run_test() noexcept
 {
   // NOLINTBEGIN(performance-unnecessary-copy-initialization)
+  "and_then"_test = [&] {
+    struct node
+    {
+      optional_ptr<test_class> child;
+    };
+    auto leaf = make_strong_ptr<test_class>(test_allocator, 5);
+    auto root = make_strong_ptr<node>(test_allocator, node{ leaf });
+    optional_ptr<node> opt_root = root;
+
+    bool const_called = false;
+    auto found = opt_root.and_then(
+      [&](strong_ptr<node> const& p_node) -> optional_ptr<test_class> {
+        expect(that % 2 == p_node.use_count())
+          << "The contained strong_ptr is passed without a copy\n";
+        return p_node->child;
+      });
+    expect(found.has_value());
+    expect(that % 5 == found->value());
+    expect(that % 3 == leaf.use_count());
+
+    auto const& const_root = opt_root;
+    auto const_found = const_root.and_then(
+      [&](strong_ptr<node> const& p_node) -> optional_ptr<test_class> {
+        const_called = true;
+        return p_node->child;
+      });
+    expect(const_called);
+    expect(const_found.has_value());
+
+    optional_ptr<node> empty;
+    bool called = false;
+    auto missing = empty.and_then([&](strong_ptr<node>&) {
+      called = true;
+      return optional_ptr<test_class>{};
+    });
+    static_assert(std::is_same_v<decltype(missing), optional_ptr<test_class>>);
+    expect(not called);
+    expect(not missing.has_value());
+  };
+
+  "transform"_test = [&] {
+    struct wrapper
+    {
+      test_class inner{ 8 };
+    };
+    optional_ptr<wrapper> opt = make_strong_ptr<wrapper>(test_allocator);
+
+    auto inner = opt.transform([](strong_ptr<wrapper> const& p_wrapper) {
+      return strong_ptr<test_class>(p_wrapper, &wrapper::inner);
+    });
+    static_assert(std::is_same_v<decltype(inner), optional_ptr<test_class>>);
+    expect(inner.has_value());
+    expect(that % 8 == inner->value());
+    expect(that % 2 == opt.use_count())
+      << "The returned strong_ptr is adopted, not copied\n";
+
+    optional_ptr<wrapper> empty;
+    auto nothing = empty.transform([](strong_ptr<wrapper> const& p_wrapper) {
+      return strong_ptr<test_class>(p_wrapper, &wrapper::inner);
+    });
+    expect(not nothing.has_value());
+  };
+
+  "or_else"_test = [&] {
+    auto primary = make_strong_ptr<test_class>(test_allocator, 1);
+    auto fallback = make_strong_ptr<test_class>(test_allocator, 2);
+    optional_ptr<test_class> engaged = primary;
+    optional_ptr<test_class> empty;
+
+    bool called = false;
+    auto kept = engaged.or_else([&] {
+      called = true;
+      return optional_ptr<test_class>(fallback);
+    });
+    expect(not called);
+    expect(that % 1 == kept->value());
+
+    auto replaced = empty.or_else([&] { return optional_ptr(fallback); });
+    expect(that % 2 == replaced->value());
+
+    auto moved =
+      std::move(engaged).or_else([] { return optional_ptr<test_class>{}; });
+    expect(that % 3 == primary.use_count())
+      << "Rvalue or_else transfers the reference\n";
+    expect(not engaged.has_value());
+    expect(that % 1 == moved->value());
+  };
+
+  "value_or"_test = [&] {
+    auto primary = make_strong_ptr<test_class>(test_allocator, 1);
+    auto fallback = make_strong_ptr<test_class>(test_allocator, 2);
+    optional_ptr<test_class> engaged = primary;
+    optional_ptr<test_class> empty;
+
+    auto const kept = engaged.value_or(fallback);
+    auto const defaulted = empty.value_or(fallback);
+    expect(that % 1 == kept->value());
+    expect(that % 2 == defaulted->value());
+    expect(that % 3 == primary.use_count());
+
+    strong_ptr<test_class> taken = std::move(engaged).value_or(fallback);
+    expect(not engaged.has_value()) << "Rvalue value_or transfers ownership\n";
+    expect(that % 3 == primary.use_count());
+    expect(that % 1 == taken->value());
+  };
+
   "implicit_conversion_to_strong_ptr"_test = [&] {
     auto strong = make_strong_ptr<test_class>(test_allocator, 42);
     optional_ptr<test_class> opt = strong;
@@ -33,10 +143,15 @@ void run_test() noexcept
       return ptr->value();
     };
 
-    expect(nothrow([&] {
+    auto convert = [&] {
       int result = convert_test(opt);  // Should implicitly convert
       expect(that % 42 == result);
-    }));
+    };
+#if defined(__cpp_exceptions)
+    expect(nothrow(convert));
+#else
+    convert();
+#endif
 
     // Test explicit conversion
     strong_ptr<test_class> converted = opt;
@@ -45,6 +160,7 @@ void run_test() noexcept
       << "Should have three references now";
   };
 
+#if defined(__cpp_exceptions)
   "conversion_with_empty_optional"_test = [&] {
     optional_ptr<test_class> empty;
 
@@ -53,6 +169,7 @@ void run_test() noexcept
       expect(that % 0 == converted->value());
     }));
   };
+#endif
 
   "const_conversion"_test = [&] {
     auto strong = make_strong_ptr<test_class>(test_allocator, 42);
@@ -64,10 +181,15 @@ void run_test() noexcept
       return ptr->value();
     };
 
-    expect(nothrow([&] {
+    auto convert = [&] {
       int result = const_convert_test(opt);  // Should work with const optional
       expect(that % 42 == result);
-    }));
+    };
+#if defined(__cpp_exceptions)
+    expect(nothrow(convert));
+#else
+    convert();
+#endif
   };
 
   "value_method_returns_copy"_test = [&] {
@@ -99,12 +221,17 @@ void run_test() noexcept
       return ptr->value();
     };
 
-    expect(nothrow([&] {
+    auto convert = [&] {
       // This should work due to strong_ptr's polymorphic conversion
       // plus optional_ptr's implicit conversion
       int result = base_convert_test(opt_derived);
       expect(that % 42 == result);
-    }));
+    };
+#if defined(__cpp_exceptions)
+    expect(nothrow(convert));
+#else
+    convert();
+#endif
   };
 
   "optional_ptr::construction"_test = [&] {
@@ -145,10 +272,12 @@ void run_test() noexcept
     auto strong = make_strong_ptr<test_class>(test_allocator, 42);
     optional_ptr<test_class> opt = strong;
 
+#if defined(__cpp_exceptions)
     expect(nothrow([&] { [[maybe_unused]] auto _ = opt->value(); }))
       << "Arrow operator should work on valid optional\n";
     expect(nothrow([&] { [[maybe_unused]] auto _ = (*opt).value(); }))
       << "Dereference operator should work on valid optional\n";
+#endif
 
     // Test value method
     expect(that % 42 == opt->value());
@@ -158,6 +287,7 @@ void run_test() noexcept
     expect(that % 100 == strong->value())
       << "Changes through optional should affect underlying object\n";
 
+#if defined(__cpp_exceptions)
     // Test exception on accessing null optional
     optional_ptr<test_class> empty;
     expect(throws<mem::nullptr_access>([&] {
@@ -170,6 +300,7 @@ void run_test() noexcept
       expect(that % 0 == value);
     }))
       << "Accessing null optional with dereference operator should throw\n";
+#endif
   };
 
   "optional_ptr reset"_test = [&] {
@@ -235,6 +366,85 @@ void run_test() noexcept
     expect(opt1 != nullptr) << "Valid optional should not equal nullptr\n";
     expect(nullptr != opt1) << "nullptr should not equal valid optional\n";
   };
+
+  "move_transfers_without_ref_count"_test = [&] {
+    auto strong = make_strong_ptr<test_class>(test_allocator, 42);
+    optional_ptr<test_class> opt = strong;
+    expect(that % 2 == strong.use_count());
+
+    optional_ptr<test_class> moved = std::move(opt);
+    expect(that % 2 == strong.use_count())
+      << "Move construction should not change the reference count\n";
+    // NOLINTNEXTLINE(bugprone-use-after-move)
+    expect(that % false == bool(opt)) << "Moved from optional is disengaged\n";
+    expect(that % 42 == moved->value());
+
+    optional_ptr<test_class> assigned;
+    assigned = std::move(moved);
+    expect(that % 2 == strong.use_count())
+      << "Move assignment should not change the reference count\n";
+    // NOLINTNEXTLINE(bugprone-use-after-move)
+    expect(that % false == bool(moved));
+
+    // Move assigning over an engaged optional releases its old reference
+    auto other = make_strong_ptr<test_class>(test_allocator, 7);
+    optional_ptr<test_class> other_opt = other;
+    assigned = std::move(other_opt);
+    expect(that % 1 == strong.use_count());
+    expect(that % 2 == other.use_count());
+    expect(that % 7 == assigned->value());
+
+    // Moving into a base class optional
+    auto derived = make_strong_ptr<derived_class>(test_allocator, 5);
+    optional_ptr<derived_class> derived_opt = derived;
+    optional_ptr<base_class> base_opt = std::move(derived_opt);
+    expect(that % 2 == derived.use_count());
+    expect(that % 5 == base_opt->value());
+  };
+
+  "rvalue_conversion_to_strong_ptr"_test = [&] {
+    auto strong = make_strong_ptr<test_class>(test_allocator, 42);
+    optional_ptr<test_class> opt = strong;
+
+    strong_ptr<test_class> taken = std::move(opt);
+    expect(that % 2 == strong.use_count())
+      << "Reference should be transferred, not copied\n";
+    // NOLINTNEXTLINE(bugprone-use-after-move)
+    expect(that % false == bool(opt));
+
+    weak_ptr<test_class> weak = strong;
+    strong_ptr<test_class> locked = weak.lock();
+    expect(that % 3 == strong.use_count());
+
+#if defined(__cpp_exceptions)
+    optional_ptr<test_class> empty;
+    expect(throws<mem::nullptr_access>([&] {
+      strong_ptr<test_class> from_empty = std::move(empty);
+      expect(that % 0 == from_empty->value());
+    }));
+#endif
+  };
+
+  "swap_and_container_relocation"_test = [&] {
+    auto strong = make_strong_ptr<test_class>(test_allocator, 42);
+    optional_ptr<test_class> engaged = strong;
+    optional_ptr<test_class> empty;
+
+    engaged.swap(empty);
+    expect(that % false == bool(engaged));
+    expect(that % true == bool(empty));
+    expect(that % 2 == strong.use_count());
+
+    std::vector<optional_ptr<test_class>> list;
+    for (int i = 0; i < 32; i++) {
+      list.emplace_back(strong);
+    }
+    // Growing the vector relocates elements using the noexcept move
+    // constructor, so every reference is accounted for exactly once.
+    expect(that % 34 == strong.use_count());
+    list.clear();
+    expect(that % 2 == strong.use_count());
+  };
   // NOLINTEND(performance-unnecessary-copy-initialization)
 }
 
@@ -0,0 +1,222 @@
+// Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <type_traits>
+#include <utility>
+
+#include <boost/ut.hpp>
+
+import test_util;
+import strong_ptr;
+
+using namespace boost::ut;
+using namespace mem;
+
+namespace {
+// Hierarchy tagged with its kind, so it can be checked without RTTI
+struct shape
+{
+  enum class kind : unsigned char
+  {
+    circle,
+    square,
+  };
+
+  explicit shape(kind p_kind)
+    : m_kind(p_kind)
+  {
+  }
+
+  kind m_kind;
+};
+
+struct circle : shape
+{
+  explicit circle(int p_radius)
+    : shape(kind::circle)
+    , radius(p_radius)
+  {
+  }
+
+  static bool classof(shape const& p_shape)
+  {
+    return p_shape.m_kind == kind::circle;
+  }
+
+  int radius;
+};
+
+struct square : shape
+{
+  explicit square(int p_side)
+    : shape(kind::square)
+    , side(p_side)
+  {
+  }
+
+  static bool classof(shape const& p_shape)
+  {
+    return p_shape.m_kind == kind::square;
+  }
+
+  int side;
+};
+
+static_assert(checked_castable<circle, shape>);
+static_assert(not checked_castable<derived_class, base_class>,
+              "No classof() means no checked cast");
+}  // namespace
+
+void run_test() noexcept
+{
+  // NOLINTBEGIN(performance-unnecessary-copy-initialization)
+  "static_pointer_cast_strong_ptr"_test = [&] {
+    strong_ptr<base_class> base =
+      make_strong_ptr<derived_class>(test_allocator, 42);
+    auto derived = static_pointer_cast<derived_class>(base);
+    static_assert(
+      std::is_same_v<decltype(derived), strong_ptr<derived_class>>);
+    expect(that % 42 == derived->value());
+    expect(that % 2 == base.use_count()) << "The control block is shared\n";
+    expect(that % &*base == static_cast<base_class*>(&*derived));
+  };
+
+  "static_pointer_cast_weak_ptr"_test = [&] {
+    strong_ptr<base_class> base =
+      make_strong_ptr<derived_class>(test_allocator, 7);
+    weak_ptr<base_class> weak = base;
+
+    auto copied = static_pointer_cast<derived_class>(weak);
+    expect(not weak.expired());
+    expect(that % 7 == copied.lock()->value());
+    expect(that % 1 == base.use_count());
+
+    auto moved = static_pointer_cast<derived_class>(std::move(weak));
+    expect(weak.expired()) << "The weak reference is transferred\n";
+    expect(not moved.expired());
+
+    base = make_strong_ptr<derived_class>(test_allocator, 8);
+    expect(moved.expired());
+    expect(copied.expired());
+  };
+
+  "static_pointer_cast_optional_ptr"_test = [&] {
+    auto owner = make_strong_ptr<derived_class>(test_allocator, 3);
+    optional_ptr<base_class> base = owner;
+    expect(that % 2 == owner.use_count());
+
+    auto copied = static_pointer_cast<derived_class>(base);
+    expect(that % 3 == owner.use_count());
+    expect(that % 3 == copied->value());
+
+    auto moved = static_pointer_cast<derived_class>(std::move(base));
+    expect(that % false == base.has_value());
+    expect(that % 3 == owner.use_count())
+      << "Casting an rvalue must not touch the reference count\n";
+    expect(that % 3 == moved->value());
+
+    optional_ptr<base_class> empty;
+    expect(that % false ==
+           static_pointer_cast<derived_class>(empty).has_value());
+    expect(that % false ==
+           static_pointer_cast<derived_class>(std::move(empty)).has_value());
+  };
+
+  "const_pointer_cast"_test = [&] {
+    strong_ptr<test_class const> constant =
+      make_strong_ptr<test_class>(test_allocator, 1);
+    auto mutable_ptr = const_pointer_cast<test_class>(constant);
+    static_assert(
+      std::is_same_v<decltype(mutable_ptr), strong_ptr<test_class>>);
+    mutable_ptr->set_value(5);
+    expect(that % 5 == constant->value());
+    expect(that % 2 == constant.use_count());
+
+    weak_ptr<test_class const> weak = constant;
+    expect(that % 5 == const_pointer_cast<test_class>(weak).lock()->value());
+
+    optional_ptr<test_class const> maybe = constant;
+    auto maybe_mutable = const_pointer_cast<test_class>(std::move(maybe));
+    expect(that % 3 == constant.use_count());
+    expect(that % 5 == maybe_mutable->value());
+  };
+
+  "checked_pointer_cast_strong_ptr"_test = [&] {
+    strong_ptr<shape> shape_ptr = make_strong_ptr<circle>(test_allocator, 4);
+
+    auto as_circle = checked_pointer_cast<circle>(shape_ptr);
+    static_assert(std::is_same_v<decltype(as_circle), optional_ptr<circle>>);
+    expect(that % true == as_circle.has_value());
+    expect(that % 4 == as_circle->radius);
+    expect(that % 2 == shape_ptr.use_count());
+
+    auto as_square = checked_pointer_cast<square>(shape_ptr);
+    expect(that % false == as_square.has_value())
+      << "A circle is not a square\n";
+    expect(that % 2 == shape_ptr.use_count())
+      << "A failed check must not add a reference\n";
+  };
+
+  "checked_pointer_cast_optional_ptr"_test = [&] {
+    strong_ptr<shape> owner = make_strong_ptr<square>(test_allocator, 6);
+    optional_ptr<shape> maybe = owner;
+
+    expect(that % false == checked_pointer_cast<circle>(maybe).has_value());
+    expect(that % false ==
+           checked_pointer_cast<circle>(std::move(maybe)).has_value());
+    expect(that % true == maybe.has_value())
+      << "A failed check leaves the source engaged\n";
+
+    auto as_square = checked_pointer_cast<square>(std::move(maybe));
+    expect(that % false == maybe.has_value());
+    expect(that % 2 == owner.use_count());
+    expect(that % 6 == as_square->side);
+
+    optional_ptr<shape> empty;
+    expect(that % false == checked_pointer_cast<square>(empty).has_value());
+  };
+
+  "checked_pointer_cast_weak_ptr"_test = [&] {
+    strong_ptr<shape> owner = make_strong_ptr<circle>(test_allocator, 2);
+    weak_ptr<shape> weak = owner;
+
+    auto as_circle = checked_pointer_cast<circle>(weak);
+    expect(that % 2 == as_circle.lock()->radius);
+    expect(that % 1 == owner.use_count());
+
+    auto as_square = checked_pointer_cast<square>(weak);
+    expect(as_square.expired()) << "A failed check yields an empty weak_ptr\n";
+
+    owner = make_strong_ptr<square>(test_allocator, 1);
+    expect(checked_pointer_cast<circle>(weak).expired())
+      << "An expired weak_ptr cannot be checked\n";
+  };
+
+  "cast_static_object"_test = [&] {
+    static circle object(9);
+    strong_ptr<shape> shape_ptr =
+      strong_ptr<circle>(unsafe_assume_static_tag{}, object);
+    auto as_circle = checked_pointer_cast<circle>(shape_ptr);
+    expect(that % 9 == as_circle->radius);
+    auto same = static_pointer_cast<circle>(shape_ptr);
+    expect(that % &object == &*same);
+  };
+  // NOLINTEND(performance-unnecessary-copy-initialization)
+}
+
+int main()
+{
+  run_test();
+  return 0;
+}
@@ -0,0 +1,136 @@
+// Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <boost/ut.hpp>
+
+import test_util;
+import strong_ptr;
+
+using namespace boost::ut;
+using namespace mem;
+
+// The free list points into the pool's own storage, so a pool must not be
+// copied or moved once constructed
+static_assert(not std::is_copy_constructible_v<
+              decltype(make_pool_allocator<test_class, 2>())>);
+static_assert(not std::is_move_constructible_v<
+              decltype(make_pool_allocator<test_class, 2>())>);
+
+void run_test() noexcept
+{
+  // NOLINTBEGIN(performance-unnecessary-copy-initialization)
+  "reuse_test"_test = [&] {
+    auto pool = mem::make_pool_allocator<test_class, 2>();
+
+    // Far more objects than slots, the pool must recycle released memory
+    for (int i = 0; i < 1000; i++) {
+      auto ptr = make_strong_ptr<test_class>(pool, i);
+      expect(that % i == ptr->value());
+    }
+    expect(that % 0 == test_class::instance_count);
+  };
+
+  "slot_recycling_test"_test = [&] {
+    auto pool = mem::make_pool_allocator<test_class, 2>();
+
+    void const* first_address = nullptr;
+    {
+      auto ptr = make_strong_ptr<test_class>(pool, 1);
+      first_address = &*ptr;
+    }
+    auto ptr = make_strong_ptr<test_class>(pool, 2);
+    expect(that % first_address == static_cast<void const*>(&*ptr))
+      << "Most recently released slot should be reused\n";
+  };
+
+  "exhaustion_test"_test = [&] {
+    auto pool = mem::make_pool_allocator<test_class, 2>();
+    auto ptr1 = make_strong_ptr<test_class>(pool, 1);
+    auto ptr2 = make_strong_ptr<test_class>(pool, 2);
+
+#if defined(__cpp_exceptions)
+    expect(throws<std::bad_alloc>(
+      [&] { auto ptr3 = make_strong_ptr<test_class>(pool, 3); }))
+      << "Exception not thrown when every slot is in use.\n";
+#endif
+
+    expect(that % 1 == ptr1->value());
+    expect(that % 2 == ptr2->value());
+  };
+
+  "weak_ptr_keeps_slot_test"_test = [&] {
+    auto pool = mem::make_pool_allocator<test_class, 1>();
+    weak_ptr<test_class> weak;
+    {
+      auto ptr = make_strong_ptr<test_class>(pool, 1);
+      weak = ptr;
+    }
+#if defined(__cpp_exceptions)
+    expect(throws<std::bad_alloc>(
+      [&] { auto ptr = make_strong_ptr<test_class>(pool, 2); }))
+      << "Control block is alive until the last weak_ptr is released.\n";
+#endif
+
+    weak = weak_ptr<test_class>{};
+    auto ptr = make_strong_ptr<test_class>(pool, 3);
+    expect(that % 3 == ptr->value());
+  };
+
+  "slot_fit_test"_test = [&] {
+    auto pool = mem::make_pool_allocator<std::uint32_t, 4>();
+
+    auto* small = pool->allocate(sizeof(std::uint8_t), alignof(std::uint8_t));
+    expect(that % 0U == reinterpret_cast<std::uintptr_t>(small) %
+                          alignof(std::uint32_t));
+
+#if defined(__cpp_exceptions)
+    expect(throws<std::bad_alloc>([&] {
+      auto* large = pool->allocate(rc_size_v<std::uint32_t> + 1, 1);
+      pool->deallocate(large, rc_size_v<std::uint32_t> + 1, 1);
+    }))
+      << "Allocations larger than a slot must be rejected.\n";
+
+    expect(throws<std::bad_alloc>([&] {
+      auto* over_aligned = pool->allocate(1, 2 * alignof(std::max_align_t));
+      pool->deallocate(over_aligned, 1, 2 * alignof(std::max_align_t));
+    }))
+      << "Allocations with stricter alignment than a slot must be rejected.\n";
+#endif
+
+    pool->deallocate(small, sizeof(std::uint8_t), alignof(std::uint8_t));
+  };
+
+// NOTE: Abort testing does not work on Windows
+#if not defined(_WIN32) and not defined(_WIN64)
+  "termination_test"_test = [&] {
+    expect(aborts([] {
+      auto pool = mem::make_pool_allocator<test_class, 2>();
+      [[maybe_unused]] auto ptr = pool->allocate(rc_size_v<test_class>,
+                                                 alignof(std::uint32_t));
+    }))
+      << "std::terminate not called.\n";
+  };
+#endif
+  // NOLINTEND(performance-unnecessary-copy-initialization)
+}
+
+int main()
+{
+  run_test();
+  return 0;
+}
@@ -0,0 +1,158 @@
+// Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include <boost/ut.hpp>
+
+import test_util;
+import strong_ptr;
+
+using namespace boost::ut;
+using namespace mem;
+
+namespace {
+struct alignas(16) wide_object
+{
+  std::array<std::uint8_t, 16> bytes;
+};
+
+std::uint64_t fake_ticks = 0;
+
+std::uint64_t fake_clock() noexcept
+{
+  // Every call advances by 5 ticks, so each upstream call takes 5 ticks
+  return fake_ticks += 5;
+}
+}  // namespace
+
+void run_test() noexcept
+{
+  // NOLINTBEGIN(performance-unnecessary-copy-initialization)
+  "type_name"_test = [&] {
+    expect(type_name<test_class>().find("test_class") !=
+           std::string_view::npos);
+    expect(type_name<std::uint32_t>() != type_name<std::uint64_t>());
+  };
+
+  "counts_and_histograms"_test = [&] {
+    profiling_resource profiler(test_allocator);
+    auto* first = profiler.allocate(3, 1);
+    auto* second = profiler.allocate(16, 8);
+    auto const& profile = profiler.profile();
+
+    expect(that % 2U == profile.allocations);
+    expect(that % 19U == profile.live_bytes);
+    expect(that % 19U == profile.total_bytes);
+    expect(that % 1U == profile.size_histogram[2]) << "3 is in (2, 4]\n";
+    expect(that % 1U == profile.size_histogram[4]) << "16 is in (8, 16]\n";
+    expect(that % 1U == profile.alignment_histogram[0]);
+    expect(that % 1U == profile.alignment_histogram[3]);
+    expect(that % 0U == profile.padding_bytes)
+      << "Padding is unknown for an arbitrary resource\n";
+
+    profiler.deallocate(first, 3, 1);
+    profiler.deallocate(second, 16, 8);
+    expect(that % 2U == profile.deallocations);
+    expect(that % 0U == profile.live_bytes);
+    expect(that % 19U == profile.peak_live_bytes);
+  };
+
+  "attributes_types"_test = [&] {
+    auto arena = make_monotonic_allocator<512>();
+    profiling_resource profiler(arena);
+    static_assert(direct_allocator<decltype(profiler)>);
+    {
+      auto a = make_strong_ptr<test_class>(profiler, 1);
+      auto b = make_strong_ptr<test_class>(profiler, 2);
+      auto c = make_strong_ptr<wide_object>(profiler);
+      expect(that % 2 == b->value());
+      expect(that % &profiler == a.get_allocator())
+        << "Control blocks store the profiling resource\n";
+
+      auto const types = profiler.types();
+      expect(that % 2U == types.size());
+      expect(types[0].name.find("test_class") != std::string_view::npos);
+      expect(that % 2U == types[0].allocations);
+      expect(that % (2 * rc_size_v<test_class>) == types[0].bytes);
+      expect(types[1].name.find("wide_object") != std::string_view::npos);
+      expect(that % rc_size_v<wide_object> == types[1].bytes);
+      expect(that % 3U == profiler.profile().allocations);
+    }
+    expect(that % 0U == profiler.profile().live_bytes);
+    expect(that % 0U == arena.stats().live_bytes);
+
+    auto untagged = make_strong_ptr<test_class>(profiler.resource(), 3);
+    expect(that % 4U == profiler.profile().allocations);
+    expect(that % 2U == profiler.types()[0].allocations)
+      << "Allocations through a memory_resource* are not attributed\n";
+  };
+
+  "records_padding"_test = [&] {
+    auto arena = make_monotonic_allocator<64>();
+    profiling_resource profiler(arena);
+    auto* byte = profiler.allocate(1, 1);
+    auto* wide = profiler.allocate(8, 8);
+    expect(that % 7U == profiler.profile().padding_bytes)
+      << "Aligning to 8 after one byte skips 7 bytes\n";
+    expect(that % (arena.stats().consumed_bytes) ==
+           profiler.profile().total_bytes + profiler.profile().padding_bytes);
+    profiler.deallocate(wide, 8, 8);
+    profiler.deallocate(byte, 1, 1);
+  };
+
+  "records_latency"_test = [&] {
+    profiling_resource profiler(test_allocator);
+    auto* untimed = profiler.allocate(4, 4);
+    expect(that % 0U == profiler.profile().allocate_ticks);
+
+    profiler.set_clock(&fake_clock);
+    auto* timed = profiler.allocate(4, 4);
+    profiler.deallocate(timed, 4, 4);
+    expect(that % 5U == profiler.profile().allocate_ticks);
+    expect(that % 5U == profiler.profile().max_allocate_ticks);
+    expect(that % 5U == profiler.profile().deallocate_ticks);
+    profiler.deallocate(untimed, 4, 4);
+  };
+
+  "reset"_test = [&] {
+    profiling_resource profiler(test_allocator);
+    auto ptr = make_strong_ptr<test_class>(profiler, 1);
+    profiler.reset();
+    expect(that % 0U == profiler.profile().allocations);
+    expect(that % 0U == profiler.types().size());
+    expect(that % rc_size_v<test_class> == profiler.profile().live_bytes)
+      << "Live bytes survive a reset\n";
+  };
+
+// NOTE: Abort testing does not work on Windows
+#if not defined(_WIN32) and not defined(_WIN64)
+  "termination_test"_test = [&] {
+    expect(aborts([] {
+      profiling_resource profiler(test_allocator);
+      [[maybe_unused]] auto* leaked = profiler.allocate(4, 4);
+    }))
+      << "std::terminate not called.\n";
+  };
+#endif
+  // NOLINTEND(performance-unnecessary-copy-initialization)
+}
+
+int main()
+{
+  run_test();
+  return 0;
+}
@@ -0,0 +1,169 @@
+// Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <cstddef>
+
+#include <boost/ut.hpp>
+
+import test_util;
+import strong_ptr;
+
+using namespace boost::ut;
+using namespace mem;
+
+namespace {
+// Records the order in which objects are destroyed
+struct ordered
+{
+  ordered(int p_id, std::array<int, 4>& p_log, std::size_t& p_logged)
+    : id(p_id)
+    , log(&p_log)
+    , logged(&p_logged)
+  {
+  }
+
+  ordered(ordered const&) = delete;
+  ordered& operator=(ordered const&) = delete;
+  ordered(ordered&&) = delete;
+  ordered& operator=(ordered&&) = delete;
+
+  ~ordered()
+  {
+    (*log)[(*logged)++] = id;
+  }
+
+  int id;
+  std::array<int, 4>* log;
+  std::size_t* logged;
+};
+
+// Holds a strong reference to an object created before it in the same arena
+struct dependent
+{
+  explicit dependent(strong_ptr<test_class> p_dependency)
+    : dependency(std::move(p_dependency))
+  {
+  }
+
+  strong_ptr<test_class> dependency;
+};
+}  // namespace
+
+void run_test() noexcept
+{
+  // NOLINTBEGIN(performance-unnecessary-copy-initialization)
+  "destroyed_at_scope_end"_test = [&] {
+    weak_ptr<test_class> weak;
+    {
+      scoped_arena<256> arena;
+      {
+        auto ptr = make_scoped_strong_ptr<test_class>(arena, 3);
+        weak = ptr;
+        expect(that % 3 == ptr->value());
+        expect(that % 1U == arena.size());
+        expect(that % 0U < arena.stats().live_bytes);
+      }
+      expect(that % 1 == test_class::instance_count)
+        << "Releasing the last reference must not run the destructor\n";
+      expect(weak.expired()) << "Released objects can no longer be locked\n";
+      expect(not weak.lock());
+      weak = weak_ptr<test_class>{};
+    }
+    expect(that % 0 == test_class::instance_count);
+  };
+
+  "reverse_creation_order"_test = [&] {
+    std::array<int, 4> log{};
+    std::size_t logged = 0;
+    {
+      scoped_arena<512> arena;
+      for (int i = 0; i < 4; i++) {
+        auto ptr = make_scoped_strong_ptr<ordered>(arena, i, log, logged);
+      }
+      expect(that % 0U == logged);
+    }
+    expect(that % 4U == logged);
+    expect(that % 3 == log[0]) << "Newest object is destroyed first\n";
+    expect(that % 2 == log[1]);
+    expect(that % 1 == log[2]);
+    expect(that % 0 == log[3]);
+  };
+
+  "bulk_reclaim_and_reuse"_test = [&] {
+    scoped_arena<512> arena;
+    for (int frame = 0; frame < 4; frame++) {
+      {
+        auto first = make_scoped_strong_ptr<test_class>(arena, frame);
+        auto const single = arena.stats().live_bytes;
+        auto second = make_scoped_strong_ptr<test_class>(arena, frame + 1);
+        expect(that % (frame + 1) == second->value());
+        expect(that % (2 * single) == arena.stats().live_bytes);
+      }
+      expect(that % 2U == arena.size());
+      expect(that % 0U < arena.stats().live_bytes)
+        << "Memory is only reclaimed by the sweep\n";
+
+      arena.clear();
+      expect(that % 0U == arena.size());
+      expect(that % 0 == test_class::instance_count);
+      expect(that % 0U == arena.stats().live_bytes);
+      expect(that % 0U == arena.stats().consumed_bytes);
+    }
+  };
+
+  "dependency_on_older_object"_test = [&] {
+    {
+      scoped_arena<512> arena;
+      auto base = make_scoped_strong_ptr<test_class>(arena, 7);
+      auto user = make_scoped_strong_ptr<dependent>(arena, base);
+      expect(that % 2 == base.use_count());
+      expect(that % 7 == user->dependency->value());
+    }
+    expect(that % 0 == test_class::instance_count)
+      << "The sweep releases references between objects of the arena\n";
+  };
+
+// NOTE: Abort testing does not work on Windows
+#if not defined(_WIN32) and not defined(_WIN64) and not defined(NDEBUG)
+  "outstanding_strong_ptr_terminates"_test = [&] {
+    expect(aborts([] {
+      scoped_arena<256> arena;
+      auto ptr = make_scoped_strong_ptr<int>(arena, 1);
+      arena.clear();
+    }))
+      << "std::terminate not called.\n";
+  };
+
+  "outstanding_weak_ptr_terminates"_test = [&] {
+    expect(aborts([] {
+      weak_ptr<int> weak;
+      scoped_arena<256> arena;
+      {
+        auto ptr = make_scoped_strong_ptr<int>(arena, 1);
+        weak = ptr;
+      }
+      arena.clear();
+    }))
+      << "std::terminate not called.\n";
+  };
+#endif
+  // NOLINTEND(performance-unnecessary-copy-initialization)
+}
+
+int main()
+{
+  run_test();
+  return 0;
+}
@@ -0,0 +1,107 @@
+// Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+
+#include <boost/ut.hpp>
+
+import test_util;
+import strong_ptr;
+
+using namespace boost::ut;
+using namespace mem;
+
+namespace {
+struct static_driver
+{
+  int value = 0;
+};
+
+static_driver driver0{ 10 };
+static_driver driver1{ 11 };
+
+// constinit and constexpr fail to compile if any part of the initialization
+// requires code to run at startup, which proves these handles are placed in
+// .data or .rodata.
+constinit strong_ptr<static_driver> mutable_handle(unsafe_assume_static_tag{},
+                                                   driver0);
+constexpr strong_ptr<static_driver> fixed_handle(unsafe_assume_static_tag{},
+                                                 driver1);
+constexpr std::array<strong_ptr<static_driver>, 2> driver_table{
+  strong_ptr<static_driver>(unsafe_assume_static_tag{}, driver0),
+  strong_ptr<static_driver>(unsafe_assume_static_tag{}, driver1),
+};
+constinit optional_ptr<static_driver> optional_handle = fixed_handle;
+constinit optional_ptr<static_driver> empty_handle = nullptr;
+constexpr optional_ptr<static_driver> fixed_optional = driver_table[0];
+constexpr optional_ptr<static_driver> fixed_empty;
+
+static_assert(not fixed_handle.is_dynamic());
+static_assert(fixed_handle.operator->() == &driver1);
+static_assert(driver_table[0].operator->() == &driver0);
+static_assert(&*driver_table[1] == &driver1);
+static_assert(fixed_optional.has_value());
+static_assert(fixed_optional.value().operator->() == &driver0);
+static_assert(not fixed_empty.has_value());
+static_assert(fixed_empty.use_count() == 0);
+}  // namespace
+
+void run_test() noexcept
+{
+  // NOLINTBEGIN(performance-unnecessary-copy-initialization)
+  "constant_initialized_handles"_test = [&] {
+    expect(that % 10 == mutable_handle->value);
+    expect(that % 11 == fixed_handle->value);
+    expect(that % 0 == fixed_handle.use_count());
+    expect(that % 10 == driver_table[0]->value);
+    expect(that % 11 == driver_table[1]->value);
+    expect(that % 11 == optional_handle->value);
+    expect(not empty_handle);
+
+    fixed_handle->value = 12;
+    expect(that % 12 == driver1.value)
+      << "constexpr handles still give mutable access to the object\n";
+  };
+
+  "reassign_constinit_handles"_test = [&] {
+    {
+      auto dynamic = make_strong_ptr<static_driver>(test_allocator, 20);
+      mutable_handle = dynamic;
+      empty_handle = dynamic;
+      expect(that % 3 == dynamic.use_count());
+      expect(mutable_handle.is_dynamic());
+    }
+    expect(that % 20 == empty_handle->value);
+
+    mutable_handle = driver_table[0];
+    empty_handle.reset();
+    expect(not mutable_handle.is_dynamic());
+    expect(not empty_handle);
+  };
+
+  "copies_of_static_handles"_test = [&] {
+    auto copy = fixed_handle;
+    optional_ptr<static_driver> optional_copy = fixed_optional;
+    expect(that % 0 == copy.use_count());
+    expect(that % &driver1 == copy.operator->());
+    expect(that % &driver0 == optional_copy.operator->());
+  };
+  // NOLINTEND(performance-unnecessary-copy-initialization)
+}
+
+int main()
+{
+  run_test();
+  return 0;
+}
@@ -0,0 +1,170 @@
+// Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include <boost/ut.hpp>
+
+import test_util;
+import strong_ptr;
+
+using namespace boost::ut;
+using namespace mem;
+
+namespace {
+#if defined(__cpp_exceptions)
+int constructed_elements = 0;
+
+struct throws_on_third
+{
+  throws_on_third()
+  {
+    if (constructed_elements == 2) {
+      throw std::runtime_error("third element");
+    }
+    constructed_elements++;
+  }
+
+  throws_on_third(throws_on_third const&) = delete;
+  throws_on_third& operator=(throws_on_third const&) = delete;
+  throws_on_third(throws_on_third&&) = delete;
+  throws_on_third& operator=(throws_on_third&&) = delete;
+
+  ~throws_on_third()
+  {
+    constructed_elements--;
+  }
+};
+#endif
+}  // namespace
+
+void run_test() noexcept
+{
+  // NOLINTBEGIN(performance-unnecessary-copy-initialization)
+  "construction"_test = [&] {
+    auto array = make_strong_array<test_class>(test_allocator, 5, 42);
+
+    expect(that % 5U == array->size());
+    expect(that % 5 == test_class::instance_count)
+      << "Every element should be constructed\n";
+    expect(that % 1 == array.use_count());
+
+    for (auto const& element : *array) {
+      expect(that % 42 == element.value())
+        << "Every element receives the same arguments\n";
+    }
+
+    (*array)[3].set_value(7);
+    expect(that % 7 == (*array)[3].value());
+    expect(that % test_allocator == array.get_allocator());
+  };
+
+  "destruction"_test = [&] {
+    {
+      auto array = make_strong_array<test_class>(test_allocator, 8);
+      auto copy = array;
+      expect(that % 8 == test_class::instance_count);
+      expect(that % 2 == copy.use_count());
+    }
+    expect(that % 0 == test_class::instance_count)
+      << "All elements should be destroyed with the last reference\n";
+  };
+
+  "element_aliasing"_test = [&] {
+    auto array = make_strong_array<test_class>(test_allocator, 3, 1);
+    strong_ptr<test_class> element(array, 2);
+
+    expect(that % 2 == array.use_count())
+      << "Element should share ownership of the array\n";
+    expect(that % &(*array)[2] == &*element);
+
+#if defined(__cpp_exceptions)
+    expect(throws<mem::out_of_range>(
+      [&] { strong_ptr<test_class> invalid(array, 3); }))
+      << "Out of bounds element should throw\n";
+#endif
+
+    // Elements keep the whole array alive
+    weak_ptr<test_class> weak = element;
+    array = make_strong_array<test_class>(test_allocator, 1);
+    expect(that % 4 == test_class::instance_count);
+    expect(not weak.expired());
+
+    element = strong_ptr<test_class>(array, 0);
+    expect(weak.expired()) << "Old array should be destroyed\n";
+    expect(that % 1 == test_class::instance_count);
+  };
+
+  "zero_length"_test = [&] {
+    auto array = make_strong_array<int>(test_allocator, 0);
+    expect(that % 0U == array->size());
+    expect(array->empty());
+#if defined(__cpp_exceptions)
+    expect(throws<mem::out_of_range>([&] { strong_ptr<int> e(array, 0); }));
+#endif
+  };
+
+  "single_allocation"_test = [&] {
+    // The monotonic allocator terminates if any allocation is still alive
+    // when it is destroyed, so the header and elements must be released as a
+    // single allocation.
+    auto allocator = mem::make_monotonic_allocator<256>();
+    {
+      auto bytes = make_strong_array<std::byte>(allocator, 128, std::byte{ 3 });
+      for (auto const& byte : *bytes) {
+        expect(std::byte{ 3 } == byte);
+      }
+      auto words = make_strong_array<std::uint64_t>(allocator, 4, 9U);
+      auto const address = reinterpret_cast<std::uintptr_t>(words->data());
+      expect(that % 0U == address % alignof(std::uint64_t))
+        << "Elements must be aligned\n";
+    }
+  };
+
+#if defined(__cpp_exceptions)
+  "throwing_element_constructor"_test = [&] {
+    auto allocator = mem::make_monotonic_allocator<256>();
+    expect(throws<std::runtime_error>(
+      [&] { auto array = make_strong_array<throws_on_third>(allocator, 5); }))
+      << "Element exception should propagate\n";
+    expect(that % 0 == constructed_elements)
+      << "Constructed elements must be destroyed on failure\n";
+  };
+#endif
+
+  "enable_strong_from_this_elements"_test = [&] {
+    auto array = make_strong_array<self_aware_class>(test_allocator, 2, 5);
+    auto self = (*array)[1].get_self();
+
+    expect(that % 2 == array.use_count())
+      << "Elements should share the control block of the array\n";
+    expect(that % &(*array)[1] == &*self);
+    expect(that % 5 == self->value());
+  };
+
+  "static_resource"_test = [&] {
+    auto array = make_strong_array<int>(static_resource<test_allocator>, 4, 2);
+    expect(that % 4U == array->size());
+    expect(that % 2 == (*array)[0]);
+  };
+  // NOLINTEND(performance-unnecessary-copy-initialization)
+}
+
+int main()
+{
+  run_test();
+  return 0;
+}
@@ -0,0 +1,95 @@
+// Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <boost/ut.hpp>
+
+import test_util;
+import strong_ptr;
+
+using namespace boost::ut;
+using namespace mem;
+
+void run_test() noexcept
+{
+  // NOLINTBEGIN(performance-unnecessary-copy-initialization)
+  "construction"_test = [&] {
+    auto group = make_strong_group<test_class>(test_allocator, 4, 9);
+
+    expect(that % 4U == group.size());
+    expect(that % 4 == test_class::instance_count);
+    expect(that % 1 == group.use_count());
+
+    for (auto const& element : group) {
+      expect(that % 9 == element.value());
+    }
+  };
+
+  "contiguous"_test = [&] {
+    auto group = make_strong_group<test_class>(test_allocator, 3);
+    auto first = group[0];
+    auto last = group[2];
+
+    expect(that % (&*first + 2) == &*last)
+      << "Objects of a group must be adjacent\n";
+    expect(that % group.elements().data() == &*first);
+  };
+
+  "shared_lifetime"_test = [&] {
+    weak_ptr<test_class> weak;
+    {
+      strong_ptr<test_class> survivor = [&] {
+        auto group = make_strong_group<test_class>(test_allocator, 5, 1);
+        auto element = group[3];
+        expect(that % 2 == group.use_count());
+        return element;
+      }();
+
+      weak = survivor;
+      expect(that % 5 == test_class::instance_count)
+        << "A single element keeps the entire group alive\n";
+      expect(that % 1 == survivor->value());
+    }
+
+    expect(weak.expired());
+    expect(that % 0 == test_class::instance_count)
+      << "Entire group is destroyed with the last reference\n";
+  };
+
+#if defined(__cpp_exceptions)
+  "out_of_bounds"_test = [&] {
+    auto group = make_strong_group<test_class>(test_allocator, 2);
+    expect(throws<mem::out_of_range>([&] { auto element = group[2]; }))
+      << "Out of bounds access should throw\n";
+  };
+#endif
+
+  "single_allocation"_test = [&] {
+    auto allocator = mem::make_monotonic_allocator<256>();
+    {
+      auto group = make_strong_group<test_class>(allocator, 16, 3);
+      auto const live = allocator.stats().live_bytes;
+      auto copy = group[15];
+      expect(that % live == allocator.stats().live_bytes)
+        << "Handing out elements must not allocate\n";
+    }
+    expect(that % 0U == allocator.stats().live_bytes);
+  };
+  // NOLINTEND(performance-unnecessary-copy-initialization)
+}
+
+int main()
+{
+  run_test();
+  return 0;
+}
@@ -12,6 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
 #include <boost/ut.hpp>
 
 import test_util;
@@ -51,7 +55,9 @@ void run_test() noexcept
     auto ptr4 = ptr2;
     expect(that % 3 == ptr.use_count());
     expect(that % 3 == ptr4.use_count());
+#if defined(__cpp_exceptions)
     expect(nothrow([&] { [[maybe_unused]] auto _ = ptr4->value(); }));
+#endif
   };
 
   "strong_ptr operator overloads"_test = [&] {
@@ -185,6 +191,70 @@ void run_test() noexcept
       << "outlived alias should have sole ownership\n";
   };
 
+  "nested_alias"_test = [&] {
+    struct window_limits
+    {
+      std::uint32_t rx_window = 0;
+      // NOLINTNEXTLINE(modernize-avoid-c-arrays)
+      int history[3] = { 1, 2, 3 };
+    };
+    struct channel
+    {
+      window_limits limits;
+      test_class name{ 7 };
+    };
+    struct stack
+    {
+      std::array<channel, 2> channels{};
+    };
+
+    auto root = make_strong_ptr<stack>(test_allocator);
+    root->channels[1].limits.rx_window = 512;
+    reset_ref_count_stats();
+
+    auto rx_window = make_alias(
+      root, &stack::channels, 1, &channel::limits, &window_limits::rx_window);
+    static_assert(std::is_same_v<decltype(rx_window), strong_ptr<std::uint32_t>>);
+    expect(that % 512U == *rx_window);
+    expect(that % 2 == root.use_count());
+    if constexpr (ref_count_instrumentation) {
+      expect(that % 1U == ref_count_stats_for().strong_increments)
+        << "The whole path costs a single increment\n";
+    }
+
+    auto history = make_alias(
+      root, &stack::channels, 0, &channel::limits, &window_limits::history, 2);
+    *history = 30;
+    expect(that % 30 == root->channels[0].limits.history[2]);
+
+    strong_ptr<stack const> const_root = root;
+    auto name = make_alias(const_root, &stack::channels, 0, &channel::name);
+    static_assert(std::is_same_v<decltype(name), strong_ptr<test_class const>>);
+    expect(that % 7 == name->value());
+    expect(that % 5 == root.use_count());
+
+#if defined(__cpp_exceptions)
+    expect(throws<mem::out_of_range>([&] {
+      auto bad = make_alias(root, &stack::channels, 2, &channel::name);
+    }));
+    expect(throws<mem::out_of_range>([&] {
+      auto bad = make_alias(
+        root, &stack::channels, 0, &channel::limits, &window_limits::history, 3);
+    }));
+    expect(that % 5 == root.use_count()) << "Failed aliases add no reference\n";
+#endif
+
+    auto array = make_strong_array<channel>(test_allocator, 3);
+    auto element_name = make_alias(array, 2, &channel::name);
+    expect(that % 7 == element_name->value());
+    expect(that % 2 == array.use_count());
+#if defined(__cpp_exceptions)
+    expect(throws<mem::out_of_range>([&] {
+      auto bad = make_alias(array, 3, &channel::name);
+    }));
+#endif
+  };
+
   "equality"_test = [&] {
     auto ptr1 = make_strong_ptr<test_class>(test_allocator, 42);
     auto ptr2 = ptr1;
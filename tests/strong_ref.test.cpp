@@ -0,0 +1,107 @@
+// Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <type_traits>
+
+#include <boost/ut.hpp>
+
+import test_util;
+import strong_ptr;
+
+using namespace boost::ut;
+using namespace mem;
+
+namespace {
+int read_value(strong_ref<test_class> p_ref, int p_depth)
+{
+  if (p_depth == 0) {
+    return p_ref->value();
+  }
+  return read_value(p_ref, p_depth - 1);
+}
+}  // namespace
+
+void run_test() noexcept
+{
+  // NOLINTBEGIN(performance-unnecessary-copy-initialization)
+  "borrow_without_counting"_test = [&] {
+    static_assert(
+      not std::is_constructible_v<strong_ref<test_class>, strong_ptr<test_class>>,
+      "Borrowing from a temporary must not compile");
+
+    auto owner = make_strong_ptr<test_class>(test_allocator, 42);
+    strong_ref<test_class> ref = owner;
+
+    expect(that % 1 == owner.use_count())
+      << "Borrowing must not change the count\n";
+    expect(that % 42 == read_value(owner, 10));
+    expect(that % 1 == owner.use_count());
+    expect(that % &*owner == &*ref);
+  };
+
+  "promote"_test = [&] {
+    auto owner = make_strong_ptr<test_class>(test_allocator, 7);
+    strong_ref<test_class> ref = owner;
+
+    auto kept = ref.promote();
+    expect(that % 2 == owner.use_count());
+    expect(that % 7 == kept->value());
+
+    weak_ptr<test_class> weak = kept;
+    owner = make_strong_ptr<test_class>(test_allocator, 8);
+    expect(not weak.expired()) << "Promoted pointer keeps the object alive\n";
+  };
+
+  "polymorphism"_test = [&] {
+    auto derived = make_strong_ptr<derived_class>(test_allocator, 3);
+    strong_ref<base_class> base = derived;
+    strong_ref<derived_class> derived_ref = derived;
+    strong_ref<base_class> converted = derived_ref;
+
+    expect(that % 3 == base->value());
+    expect(base == converted);
+    expect(that % 2 == base.promote().use_count());
+  };
+
+  "static_object"_test = [&] {
+    static int value = 5;
+    strong_ptr<int> owner(mem::unsafe_assume_static_tag{}, value);
+    strong_ref<int> ref = owner;
+    auto promoted = ref.promote();
+    expect(that % 5 == *promoted);
+    expect(that % 0 == ref.use_count());
+  };
+
+// NOTE: Abort testing does not work on Windows
+#if not defined(_WIN32) and not defined(_WIN64) and not defined(NDEBUG)
+  "promote_after_owner_destroyed"_test = [&] {
+    expect(aborts([] {
+      auto owner = make_strong_ptr<test_class>(test_allocator, 1);
+      // Keeps the control block in memory so the check can observe it
+      weak_ptr<test_class> weak = owner;
+      strong_ref<test_class> ref = owner;
+      owner = make_strong_ptr<test_class>(test_allocator, 2);
+      [[maybe_unused]] auto promoted = ref.promote();
+    }))
+      << "std::terminate not called.\n";
+  };
+#endif
+  // NOLINTEND(performance-unnecessary-copy-initialization)
+}
+
+int main()
+{
+  run_test();
+  return 0;
+}
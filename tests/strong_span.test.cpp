@@ -0,0 +1,138 @@
+// Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+#include <boost/ut.hpp>
+
+import test_util;
+import strong_ptr;
+
+using namespace boost::ut;
+using namespace mem;
+
+namespace {
+struct frame
+{
+  std::array<int, 8> samples{ 0, 1, 2, 3, 4, 5, 6, 7 };
+  // NOLINTNEXTLINE(modernize-avoid-c-arrays)
+  int history[4] = { 10, 11, 12, 13 };
+};
+}  // namespace
+
+void run_test() noexcept
+{
+  // NOLINTBEGIN(performance-unnecessary-copy-initialization)
+  "std_array_member"_test = [&] {
+    auto owner = make_strong_ptr<frame>(test_allocator);
+    strong_span<int> samples(owner, &frame::samples);
+
+    expect(that % 8U == samples.size());
+    expect(that % 2 == owner.use_count());
+
+    int sum = 0;
+    for (auto& sample : samples) {
+      sum += sample;
+    }
+    expect(that % 28 == sum);
+    expect(that % 2 == owner.use_count())
+      << "Iterating must not touch the count\n";
+
+    samples[3] = 30;
+    expect(that % 30 == owner->samples[3]);
+#if defined(__cpp_exceptions)
+    expect(throws<mem::out_of_range>([&] { (void)samples[8]; }));
+#endif
+  };
+
+  "c_array_member"_test = [&] {
+    auto owner = make_strong_ptr<frame>(test_allocator);
+    strong_span<int const> history(owner, &frame::history);
+    expect(that % 4U == history.size());
+    expect(that % 13 == history[3]);
+  };
+
+  "subspan"_test = [&] {
+    auto owner = make_strong_ptr<frame>(test_allocator);
+    strong_span<int> samples(owner, &frame::samples);
+
+    auto middle = samples.subspan(2, 4);
+    expect(that % 4U == middle.size());
+    expect(that % 2 == middle[0]);
+    expect(that % 3 == owner.use_count()) << "One reference per span\n";
+
+    auto tail = samples.subspan(6);
+    expect(that % 2U == tail.size());
+    expect(that % 7 == tail[1]);
+    expect(that % 3U == samples.first(3).size());
+    expect(that % 5 == samples.last(3)[0]);
+    expect(samples.subspan(8).empty());
+
+#if defined(__cpp_exceptions)
+    expect(throws<mem::out_of_range>([&] { (void)samples.subspan(9); }));
+    expect(throws<mem::out_of_range>([&] { (void)samples.subspan(4, 5); }));
+    expect(throws<mem::out_of_range>([&] { (void)samples.first(9); }));
+    expect(throws<mem::out_of_range>([&] { (void)samples.last(9); }));
+#endif
+    expect(that % 4 == owner.use_count());
+  };
+
+  "share_element"_test = [&] {
+    strong_ptr<int> escaped = [] {
+      auto owner = make_strong_ptr<frame>(test_allocator);
+      strong_span<int> samples(owner, &frame::samples);
+      return samples.share(5);
+    }();
+    expect(that % 5 == *escaped);
+    expect(that % 1 == escaped.use_count())
+      << "The element keeps the owner alive\n";
+  };
+
+  "strong_array"_test = [&] {
+    strong_ptr<std::span<test_class> const> array =
+      make_strong_array<test_class>(test_allocator, 3, 9);
+    {
+      strong_span<test_class> elements = array;
+      strong_span<test_class const> const_elements = elements;
+      expect(that % 3 == array.use_count());
+      expect(that % 9 == const_elements[2].value());
+
+      auto copy = elements;
+      copy = elements.subspan(1);
+      expect(that % 2U == copy.size());
+      expect(that % 4 == array.use_count());
+    }
+    expect(that % 1 == array.use_count());
+    expect(that % 3 == test_class::instance_count);
+  };
+
+  "static_owner"_test = [&] {
+    static frame static_frame;
+    strong_ptr<frame> owner(unsafe_assume_static_tag{}, static_frame);
+    strong_span<int> samples(owner, &frame::samples);
+    expect(that % 0 == samples.use_count());
+    auto element = samples.share(1);
+    expect(that % 1 == *element);
+    expect(not element.is_dynamic());
+  };
+  // NOLINTEND(performance-unnecessary-copy-initialization)
+}
+
+int main()
+{
+  run_test();
+  return 0;
+}
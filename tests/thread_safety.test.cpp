@@ -0,0 +1,129 @@
+// Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include <boost/ut.hpp>
+
+import test_util;
+import strong_ptr;
+
+using namespace boost::ut;
+using namespace mem;
+
+namespace {
+constexpr int thread_count = 4;
+constexpr int iterations = 10'000;
+
+template<typename Policy>
+void check_count_policy()
+{
+  typename Policy::counts counts{};
+  expect(that % 1 == Policy::strong_count(counts))
+    << "Creation implies a strong reference\n";
+
+  Policy::add_strong(counts);
+  Policy::add_weak(counts);
+  expect(that % 2 == Policy::strong_count(counts));
+
+  expect(not Policy::release_strong(counts));
+  expect(Policy::release_strong(counts)) << "Last strong reference\n";
+  expect(that % 0 == Policy::strong_count(counts));
+  expect(not Policy::try_add_strong(counts))
+    << "A zero count must never be resurrected\n";
+  expect(not Policy::sole_weak(counts)) << "A weak_ptr is still alive\n";
+
+  // Collective weak reference of the strong references, then the weak_ptr
+  expect(not Policy::release_weak(counts));
+  expect(Policy::release_weak(counts)) << "Last weak reference\n";
+
+  typename Policy::counts unobserved{};
+  expect(Policy::release_strong(unobserved));
+  expect(Policy::sole_weak(unobserved))
+    << "Only the collective weak reference remains\n";
+}
+}  // namespace
+
+void run_test() noexcept
+{
+  // NOLINTBEGIN(performance-unnecessary-copy-initialization)
+  "count_policy_semantics"_test = [&] {
+    check_count_policy<unsynchronized_count_policy<std::int16_t>>();
+    check_count_policy<unsynchronized_count_policy<std::int32_t>>();
+    check_count_policy<unsynchronized_count_policy<std::int64_t>>();
+    check_count_policy<atomic_count_policy<std::int16_t>>();
+    check_count_policy<atomic_count_policy<std::int32_t>>();
+    check_count_policy<atomic_count_policy<std::int64_t>>();
+  };
+
+  if constexpr (thread_safe_ref_count) {
+    "concurrent_copies"_test = [&] {
+      auto ptr = make_strong_ptr<concurrent_test_class>(test_allocator, 42);
+      std::array<std::thread, thread_count> threads;
+
+      for (auto& thread : threads) {
+        thread = std::thread([&ptr] {
+          for (int i = 0; i < iterations; i++) {
+            auto copy = ptr;
+            expect(that % 42 == copy->value());
+          }
+        });
+      }
+
+      for (auto& thread : threads) {
+        thread.join();
+      }
+
+      expect(that % 1 == ptr.use_count())
+        << "All copies should have been released\n";
+    };
+
+    "concurrent_lock_and_release"_test = [&] {
+      for (int i = 0; i < iterations / 10; i++) {
+        auto ptr = make_strong_ptr<concurrent_test_class>(test_allocator, i);
+        weak_ptr<concurrent_test_class> weak = ptr;
+        std::atomic<bool> start = false;
+
+        std::thread locker([&] {
+          while (not start) {
+          }
+          auto locked = weak.lock();
+          if (locked) {
+            // A successful lock must always observe a living object
+            expect(locked->alive());
+            expect(that % i == locked->value());
+          }
+        });
+
+        start = true;
+        // Drop the last strong reference while the other thread locks
+        ptr = make_strong_ptr<concurrent_test_class>(test_allocator, i);
+        locker.join();
+      }
+
+      expect(that % 0 == concurrent_test_class::instance_count.load())
+        << "Every object should have been destroyed exactly once\n";
+    };
+  }
+  // NOLINTEND(performance-unnecessary-copy-initialization)
+}
+
+int main()
+{
+  run_test();
+  return 0;
+}
@@ -0,0 +1,142 @@
+// Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <type_traits>
+
+#include <boost/ut.hpp>
+
+import test_util;
+import strong_ptr;
+
+using namespace boost::ut;
+using namespace mem;
+
+namespace {
+struct channel
+{
+  std::uint32_t id = 0;
+};
+
+struct stack
+{
+  std::array<channel, 2> channels{};
+};
+}  // namespace
+
+void run_test() noexcept
+{
+  // NOLINTBEGIN(performance-unnecessary-copy-initialization)
+  "error_policy"_test = [&] {
+#if defined(__cpp_exceptions)
+    expect(exceptions_enabled);
+#else
+    expect(not exceptions_enabled);
+#endif
+  };
+
+  "try_make_strong_ptr_success"_test = [&] {
+    auto allocator = make_monotonic_allocator<64>();
+    static_assert(nothrow_allocator<decltype(allocator)>);
+    static_assert(not nothrow_allocator<std::pmr::memory_resource*>);
+    {
+      auto ptr = try_make_strong_ptr<test_class>(allocator, 5);
+      expect(that % true == ptr.has_value());
+      expect(that % 5 == ptr->value());
+      expect(that % 1 == ptr.use_count());
+      expect(that % 1 == test_class::instance_count);
+    }
+    expect(that % 0 == test_class::instance_count);
+    expect(that % 0U == allocator.stats().live_bytes);
+  };
+
+  "try_make_strong_ptr_exhausted_monotonic"_test = [&] {
+    auto allocator = make_monotonic_allocator<rc_size_v<test_class>>();
+    auto first = try_make_strong_ptr<test_class>(allocator, 1);
+    expect(that % true == first.has_value());
+
+    auto second = try_make_strong_ptr<test_class>(allocator, 2);
+    expect(that % false == second.has_value())
+      << "An exhausted arena yields a disengaged optional_ptr\n";
+    expect(that % 1 == test_class::instance_count)
+      << "No object is constructed when allocation fails\n";
+  };
+
+  "try_make_strong_ptr_exhausted_concurrent"_test = [&] {
+    auto allocator =
+      make_concurrent_monotonic_allocator<rc_size_v<std::uint64_t>>();
+    static_assert(nothrow_allocator<decltype(allocator)>);
+    auto first = try_make_strong_ptr<std::uint64_t>(allocator, 1U);
+    auto second = try_make_strong_ptr<std::uint64_t>(allocator, 2U);
+    expect(that % true == first.has_value());
+    expect(that % false == second.has_value());
+  };
+
+  "try_make_strong_ptr_exhausted_pool"_test = [&] {
+    auto pool = make_pool_allocator<test_class, 2>();
+    static_assert(nothrow_allocator<decltype(pool)>);
+    auto first = try_make_strong_ptr<test_class>(pool, 1);
+    auto second = try_make_strong_ptr<test_class>(pool, 2);
+    auto third = try_make_strong_ptr<test_class>(pool, 3);
+    expect(that % true == first.has_value());
+    expect(that % true == second.has_value());
+    expect(that % false == third.has_value());
+
+    // Releasing a slot makes room again
+    first.reset();
+    auto fourth = try_make_strong_ptr<test_class>(pool, 4);
+    expect(that % true == fourth.has_value());
+    expect(that % 4 == fourth->value());
+
+    auto too_large = try_make_strong_ptr<std::array<test_class, 4>>(pool);
+    expect(that % false == too_large.has_value())
+      << "Requests larger than a slot are refused\n";
+  };
+
+  "try_make_strong_ptr_memory_resource"_test = [&] {
+    auto ptr = try_make_strong_ptr<test_class>(test_allocator, 7);
+    expect(that % true == ptr.has_value());
+    expect(that % 7 == ptr->value());
+    expect(that % test_allocator == ptr.value().get_allocator());
+  };
+
+  "try_make_alias"_test = [&] {
+    auto root = make_strong_ptr<stack>(test_allocator);
+    root->channels[1].id = 9;
+
+    auto id = try_make_alias(root, &stack::channels, 1, &channel::id);
+    static_assert(std::is_same_v<decltype(id), optional_ptr<std::uint32_t>>);
+    expect(that % true == id.has_value());
+    expect(that % 9U == *id);
+    expect(that % 2 == root.use_count()) << "Exactly one reference is added\n";
+
+    auto missing = try_make_alias(root, &stack::channels, 2, &channel::id);
+    expect(that % false == missing.has_value())
+      << "An out of bounds index yields a disengaged optional_ptr\n";
+    expect(that % 2 == root.use_count());
+
+    auto whole = try_make_alias(root, &stack::channels, 0);
+    expect(that % true == whole.has_value());
+    expect(that % 0U == whole->id);
+  };
+  // NOLINTEND(performance-unnecessary-copy-initialization)
+}
+
+int main()
+{
+  run_test();
+  return 0;
+}
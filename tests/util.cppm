@@ -15,6 +15,7 @@
 module;
 
 #include <array>
+#include <atomic>
 #include <memory_resource>
 
 export module test_util;
@@ -108,6 +109,47 @@ export {
     int m_value;
   };
 
+  // Test class counted atomically, for objects that may be destroyed on
+  // another thread. test_class::instance_count is not atomic.
+  class concurrent_test_class
+  {
+  public:
+    explicit concurrent_test_class(int p_value = 0)
+      : m_value(p_value)
+    {
+      ++instance_count;
+    }
+
+    concurrent_test_class(concurrent_test_class const&) = delete;
+    concurrent_test_class& operator=(concurrent_test_class const&) = delete;
+    concurrent_test_class(concurrent_test_class&&) = delete;
+    concurrent_test_class& operator=(concurrent_test_class&&) = delete;
+
+    ~concurrent_test_class()
+    {
+      m_alive = false;
+      --instance_count;
+    }
+
+    [[nodiscard]] int value() const
+    {
+      return m_value;
+    }
+
+    // false once destroyed, to catch reads of a destroyed object
+    [[nodiscard]] bool alive() const
+    {
+      return m_alive;
+    }
+
+    // Static counter for number of instances
+    inline static std::atomic<int> instance_count = 0;
+
+  private:
+    int m_value;
+    bool m_alive = true;
+  };
+
   // Test class that uses enable_strong_from_this
   class self_aware_class : public mem::enable_strong_from_this<self_aware_class>
   {
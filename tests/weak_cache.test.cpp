@@ -0,0 +1,225 @@
+// Copyright 2024 - 2025 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <boost/ut.hpp>
+
+import test_util;
+import strong_ptr;
+
+using namespace boost::ut;
+using namespace mem;
+
+namespace {
+struct pair_of_values
+{
+  test_class first;
+  test_class second;
+};
+
+// Counts how often an expensive object is built
+struct decoded_asset
+{
+  explicit decoded_asset(int p_id, int& p_decodes)
+    : id(p_id)
+  {
+    p_decodes++;
+  }
+
+  int id;
+};
+}  // namespace
+
+void run_test() noexcept
+{
+  // NOLINTBEGIN(performance-unnecessary-copy-initialization)
+  "owner_comparison"_test = [&] {
+    auto owner = make_strong_ptr<pair_of_values>(test_allocator);
+    strong_ptr<test_class> first(owner, &pair_of_values::first);
+    strong_ptr<test_class> second(owner, &pair_of_values::second);
+    auto other = make_strong_ptr<test_class>(test_allocator, 1);
+
+    expect(first != second) << "Aliases point to different objects\n";
+    expect(first.owner_equal(second)) << "but share an owner\n";
+    expect(first.owner_equal(owner));
+    expect(not first.owner_before(second) and not second.owner_before(first));
+    expect(that % first.owner_hash() == second.owner_hash());
+
+    expect(not other.owner_equal(first));
+    expect(other.owner_before(first) != first.owner_before(other));
+
+    weak_ptr<test_class> weak = second;
+    expect(weak.owner_equal(first));
+    expect(first.owner_equal(weak));
+    expect(that % weak.owner_hash() == owner.owner_hash());
+
+    weak_ptr<test_class> empty;
+    weak_ptr<test_class> also_empty;
+    expect(empty.owner_equal(also_empty));
+    expect(not empty.owner_equal(weak));
+  };
+
+  "owner_survives_expiry"_test = [&] {
+    std::set<weak_ptr<test_class>, owner_less> observed;
+    weak_ptr<test_class> weak;
+    std::size_t hash = 0;
+    {
+      auto strong = make_strong_ptr<test_class>(test_allocator, 2);
+      weak = strong;
+      hash = weak.owner_hash();
+      observed.insert(weak);
+      expect(observed.contains(strong)) << "Lookup with a strong_ptr\n";
+    }
+    expect(weak.expired());
+    expect(that % hash == weak.owner_hash());
+    expect(observed.contains(weak))
+      << "An expired weak_ptr keeps its place in the ordering\n";
+  };
+
+  "owner_of_static_objects"_test = [&] {
+    static test_class object0(3);
+    static test_class object1(4);
+    strong_ptr<test_class> ptr0(unsafe_assume_static_tag{}, object0);
+    strong_ptr<test_class> ptr1(unsafe_assume_static_tag{}, object1);
+    weak_ptr<test_class> weak0 = ptr0;
+
+    expect(not ptr0.owner_equal(ptr1))
+      << "Static objects are not all owned alike\n";
+    expect(ptr0.owner_equal(weak0));
+  };
+
+  "owner_keyed_unordered_set"_test = [&] {
+    std::unordered_set<weak_ptr<test_class>, owner_hash, owner_equal> seen;
+    auto first = make_strong_ptr<test_class>(test_allocator, 5);
+    auto second = make_strong_ptr<test_class>(test_allocator, 6);
+    seen.insert(weak_ptr<test_class>(first));
+    seen.insert(weak_ptr<test_class>(second));
+    seen.insert(weak_ptr<test_class>(first));
+    expect(that % 2U == seen.size());
+  };
+
+  "std_hash"_test = [&] {
+    auto strong = make_strong_ptr<test_class>(test_allocator, 7);
+    auto copy = strong;
+    strong_ptr<test_class const> as_const = strong;
+    expect(that % std::hash<strong_ptr<test_class>>{}(strong) ==
+           std::hash<strong_ptr<test_class>>{}(copy));
+    expect(that % std::hash<strong_ptr<test_class>>{}(strong) ==
+           std::hash<strong_ptr<test_class const>>{}(as_const));
+
+    optional_ptr<test_class> maybe = strong;
+    optional_ptr<test_class> empty;
+    expect(that % std::hash<strong_ptr<test_class>>{}(strong) ==
+           std::hash<optional_ptr<test_class>>{}(maybe));
+    expect(that % std::hash<optional_ptr<test_class>>{}(nullptr) ==
+           std::hash<optional_ptr<test_class>>{}(empty));
+
+    std::unordered_map<strong_ptr<test_class>, int> map;
+    map[strong] = 1;
+    map[copy] += 1;
+    expect(that % 1U == map.size());
+    expect(that % 2 == map[strong]);
+  };
+
+  "weak_cache_hit_and_miss"_test = [&] {
+    int decodes = 0;
+    weak_cache<int, decoded_asset> cache(test_allocator);
+    expect(that % test_allocator == cache.resource());
+
+    auto first = cache.get_or_create(1, 1, decodes);
+    auto again = cache.get_or_create(1, 1, decodes);
+    expect(that % 1 == decodes) << "A live object is reused\n";
+    expect(first == again);
+    expect(that % 2 == first.use_count())
+      << "The cache holds no strong reference\n";
+
+    auto other = cache.get_or_create(2, 2, decodes);
+    expect(that % 2 == decodes);
+    expect(that % 2 == other->id);
+    expect(that % 2U == cache.size());
+
+    expect(that % true == cache.find(1).has_value());
+    expect(that % false == cache.find(3).has_value());
+  };
+
+  "weak_cache_expired_entry_is_rebuilt"_test = [&] {
+    int decodes = 0;
+    weak_cache<int, decoded_asset> cache(test_allocator);
+    {
+      auto asset = cache.get_or_create(1, 1, decodes);
+    }
+    expect(that % false == cache.find(1).has_value())
+      << "The cache does not keep objects alive\n";
+    expect(that % 1U == cache.size());
+
+    auto rebuilt = cache.get_or_create(1, 1, decodes);
+    expect(that % 2 == decodes);
+    expect(that % 1U == cache.size()) << "The expired entry is reused\n";
+  };
+
+  "weak_cache_lazy_prune"_test = [&] {
+    int decodes = 0;
+    weak_cache<int, decoded_asset> cache(test_allocator);
+    auto kept = cache.get_or_create(0, 0, decodes);
+    for (int i = 1; i < 64; i++) {
+      auto temporary = cache.get_or_create(i, i, decodes);
+    }
+    expect(that % 64 == decodes);
+    expect(that % 16U > cache.size())
+      << "Expired entries are pruned as the cache grows\n";
+    expect(that % true == cache.find(0).has_value())
+      << "Live entries survive pruning\n";
+
+    auto removed = cache.prune();
+    expect(that % 0U < removed);
+    expect(that % 1U == cache.size());
+
+    expect(cache.erase(0));
+    expect(not cache.erase(0));
+    expect(that % 0 == kept->id) << "Erasing an entry keeps the object alive\n";
+    cache.clear();
+    expect(that % 0U == cache.size());
+  };
+
+  "weak_cache_separate_entry_resource"_test = [&] {
+    std::array<std::byte, 1024> buffer{};
+    std::pmr::monotonic_buffer_resource entries(buffer.data(), buffer.size());
+    auto objects = make_monotonic_allocator<256>();
+    weak_cache<int, test_class> cache(objects, &entries);
+    {
+      auto value = cache.get_or_create(1, 8);
+      expect(that % 8 == value->value());
+      expect(that % rc_size_v<test_class> == objects.stats().live_bytes)
+        << "Only the object comes from the object resource\n";
+    }
+    expect(that % rc_size_v<test_class> == objects.stats().live_bytes)
+      << "The expired entry holds the storage until it is pruned\n";
+    expect(that % 1U == cache.prune());
+    expect(that % 0U == objects.stats().live_bytes);
+  };
+  // NOLINTEND(performance-unnecessary-copy-initialization)
+}
+
+int main()
+{
+  run_test();
+  return 0;
+}
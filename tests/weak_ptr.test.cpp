@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <exception>
+
 #include <boost/ut.hpp>
 
 import test_util;
@@ -127,6 +129,99 @@ void run_test() noexcept
       expect(that % false == bool(locked))
         << "Locking expired weak_ptr should return null optional\n";
     };
+
+  "last_weak_ptr_frees_control_block"_test = [&] {
+    // The monotonic allocator terminates if any allocation is still alive
+    // when it is destroyed, so leaking the control block fails this test.
+    auto allocator = mem::make_monotonic_allocator<128>();
+    {
+      weak_ptr<test_class> weak;
+      {
+        auto strong = make_strong_ptr<test_class>(allocator, 42);
+        weak = strong;
+        weak_ptr<test_class> weak_copy = weak;
+        expect(not weak_copy.expired());
+      }
+      expect(weak.expired()) << "Object should be destroyed\n";
+      expect(that % 0 == test_class::instance_count);
+    }
+  };
+
+  "lock_static_object"_test = [&] {
+    static int static_obj = 7;
+    strong_ptr<int> ptr(mem::unsafe_assume_static_tag{}, static_obj);
+    weak_ptr<int> weak = ptr;
+
+    auto locked = weak.lock();
+    expect(that % true == bool(locked))
+      << "Statically allocated objects can always be locked\n";
+    expect(that % 7 == *locked);
+  };
+
+  "try_lock"_test = [&] {
+    auto strong = make_strong_ptr<test_class>(test_allocator, 42);
+    weak_ptr<test_class> weak = strong;
+    auto out = make_strong_ptr<test_class>(test_allocator, 1);
+
+    expect(weak.try_lock(out)) << "Lock should succeed on valid weak_ptr\n";
+    expect(that % 42 == out->value());
+    expect(that % 2 == strong.use_count());
+    expect(that % 1 == test_class::instance_count)
+      << "Previous object held by the out parameter is released\n";
+
+    weak_ptr<test_class> expired;
+    {
+      auto temp = make_strong_ptr<test_class>(test_allocator, 100);
+      expired = temp;
+    }
+    expect(not expired.try_lock(out));
+    expect(that % 42 == out->value()) << "Failure leaves out untouched\n";
+    expect(not weak_ptr<test_class>{}.try_lock(out));
+
+    static int static_obj = 9;
+    strong_ptr<int> static_ptr(mem::unsafe_assume_static_tag{}, static_obj);
+    weak_ptr<int> static_weak = static_ptr;
+    auto int_out = make_strong_ptr<int>(test_allocator, 0);
+    expect(static_weak.try_lock(int_out));
+    expect(that % 9 == *int_out);
+  };
+
+  "visit"_test = [&] {
+    auto strong = make_strong_ptr<test_class>(test_allocator, 42);
+    weak_ptr<test_class> weak = strong;
+
+    int seen = 0;
+    expect(weak.visit([&](test_class& p_object) {
+      seen = p_object.value();
+      expect(that % 2 == strong.use_count())
+        << "Object is pinned while visiting\n";
+    }));
+    expect(that % 42 == seen);
+    expect(that % 1 == strong.use_count()) << "Pin released after visit\n";
+
+#if defined(__cpp_exceptions)
+    expect(throws<std::exception>([&] {
+      (void)weak.visit([](test_class&) { throw std::exception(); });
+    }));
+    expect(that % 1 == strong.use_count())
+      << "Pin released when the visitor throws\n";
+#endif
+
+    weak_ptr<test_class> expired;
+    {
+      auto temp = make_strong_ptr<test_class>(test_allocator, 100);
+      expired = temp;
+    }
+    bool called = false;
+    expect(not expired.visit([&](test_class&) { called = true; }));
+    expect(not called) << "Visitor must not run on an expired object\n";
+
+    auto derived = make_strong_ptr<derived_class>(test_allocator, 42);
+    weak_ptr<base_class> base_weak = derived;
+    expect(base_weak.visit([](base_class& p_base) {
+      expect(that % 42 == p_base.value());
+    }));
+  };
   // NOLINTEND(performance-unnecessary-copy-initialization)
 }
 